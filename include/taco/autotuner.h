@@ -0,0 +1,67 @@
+#ifndef TACO_AUTOTUNER_H
+#define TACO_AUTOTUNER_H
+
+#include <string>
+#include <vector>
+
+#include "taco/index_notation/index_notation.h"
+
+namespace taco {
+class TensorBase;
+
+/// Options of the schedule search done by `autotune`.
+struct AutotuneOptions {
+  /// The largest number of candidate schedules to compile and time.
+  int maxCandidates = 32;
+
+  /// The number of times each candidate is timed.  Candidates are ranked by
+  /// their median time.
+  int repetitions = 5;
+
+  /// The factors that loops are split by.
+  std::vector<int> splitFactors = {16, 128};
+
+  /// Whether to try schedules that parallelize the outer loop over threads.
+  bool parallelize = true;
+
+  /// The number of candidates to compile concurrently, or 0 to compile as
+  /// many as there are hardware threads.
+  int compileThreads = 0;
+
+  /// A file that the best schedule found for an expression is stored in,
+  /// keyed by the expression and its tensors' formats and dimensions.
+  /// Expressions that are in the file are compiled with the stored schedule
+  /// without searching.  Schedules are not stored if the name is empty.
+  std::string scheduleFile;
+};
+
+/// The median time, in milliseconds, of the compute kernel of a schedule.
+struct ScheduleTiming {
+  std::string schedule;
+  double time;
+};
+
+/// Enumerates candidate schedules for a concrete index statement, such as
+/// one returned by `makeConcreteNotation` and `reorderLoopsTopologically`.
+/// Candidates reorder the loops in ways the operand and result formats
+/// allow, precompute into a dense workspace when a sparse result would
+/// otherwise be scattered into, split and parallelize the outer loop, and
+/// tile dense inner loops.  Schedules are written in the syntax of the
+/// command-line tool's `-s` option, can be applied with
+/// `parser::applySchedule`, and are not guaranteed to be legal.  The empty
+/// schedule, which stands for the default schedule, comes first.
+std::vector<std::string>
+enumerateSchedules(IndexStmt stmt,
+                   const AutotuneOptions& options=AutotuneOptions());
+
+/// Searches for the fastest schedule of the expression assigned to `result`
+/// by compiling the candidates of `enumerateSchedules` concurrently and
+/// timing them on the tensors of the expression.  The result is compiled
+/// with the fastest schedule, which is returned.  If `timings` is given, the
+/// time of each candidate that compiled is appended to it.
+std::string autotune(TensorBase& result,
+                     const AutotuneOptions& options=AutotuneOptions(),
+                     std::vector<ScheduleTiming>* timings=nullptr);
+
+}
+#endif
@@ -24,6 +24,15 @@ public:
 
   /// Compile the source into a library, returning its full path
   std::string compile();
+
+  /// Generate the source files of the module.  This is the first half of
+  /// `compile`, and must run on the thread that created the module's IR.
+  void generateSources();
+
+  /// Compile the generated source files into a library and load it, returning
+  /// its full path.  This is the second half of `compile`; the modules of
+  /// different kernels can run it concurrently.
+  std::string compileSources();
   
   /// Compile the module into a source file located at the specified location
   /// path and prefix.  The generated source will be path/prefix.{.c|.bc, .h}
@@ -0,0 +1,59 @@
+#ifndef TACO_TASK_RUNTIME_H
+#define TACO_TASK_RUNTIME_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace taco {
+
+/// A work-stealing thread pool that runs the task-parallel loops of generated
+/// kernels (loops of kind `LoopKind::Tasks`).  A loop is split recursively in
+/// halves; a thread keeps the half it is working on and idle threads steal the
+/// largest pending halves.  A thread that waits for a loop to finish keeps
+/// running pending tasks, so parallel loops can be nested freely.
+///
+/// The runtime uses as many threads, including the calling thread, as
+/// `taco_get_num_threads()` returns.  Host applications can run their own
+/// loops through `parallelFor` to share the worker threads with taco.
+class TaskRuntime {
+public:
+  /// The body of a loop, called on the subranges [begin, end) of the loop.
+  typedef void (*Task)(void* context, int32_t begin, int32_t end);
+
+  /// Returns the runtime shared by all kernels in the process.
+  static TaskRuntime& getInstance();
+
+  ~TaskRuntime();
+
+  /// Runs `task` on subranges that together cover [begin, end), returning
+  /// once all of them have run.  Subranges have at least `grainSize`
+  /// iterations; a grain size of 0 picks one from the size of the range and
+  /// the number of threads.  The task must not throw.
+  void parallelFor(int32_t begin, int32_t end, Task task, void* context,
+                   int32_t grainSize=0);
+
+  /// Runs `body` on subranges that together cover [begin, end).
+  void parallelFor(int32_t begin, int32_t end,
+                   const std::function<void(int32_t,int32_t)>& body,
+                   int32_t grainSize=0);
+
+  /// Returns the number of threads, including the calling thread, that the
+  /// runtime currently runs loops on.
+  int getNumThreads() const;
+
+private:
+  TaskRuntime();
+
+  struct Content;
+  std::shared_ptr<Content> content;
+};
+
+/// Runs a task-parallel loop of a generated kernel on the shared runtime.
+/// Generated code calls this through the `taco_task_runtime` pointer, which
+/// the module sets when it loads the kernel.
+void runTaskLoop(int32_t begin, int32_t end, TaskRuntime::Task task,
+                 void* context);
+
+}
+#endif
@@ -15,6 +15,17 @@ class ModeFormatImpl;
 class AttrQuery;
 class IndexVar;
 
+/// A ValueEncoding describes how the values array of a tensor is stored.
+/// Plain stores every component in full.  Pattern stores no values at all and
+/// every stored component is implicitly one, which suits pattern (structure
+/// only) matrices.  Dictionary8 and Dictionary16 store each component as an
+/// 8-bit or 16-bit code into a dictionary of the tensor's distinct values.
+/// Encoded values are decoded on the fly by generated kernels, so encoded
+/// tensors can only be read by computations.
+enum class ValueEncoding {
+  Plain, Pattern, Dictionary8, Dictionary16
+};
+
 
 /// A Format describes the data layout of a tensor, and the sparse index data
 /// structures that describe locations of non-zero tensor components.
@@ -67,16 +78,33 @@ public:
   /// Sets the types of the coordinate arrays for each level
   void setLevelArrayTypes(std::vector<std::vector<Datatype>> levelArrayTypes);
 
+  /// Gets the encoding of the values array.
+  ValueEncoding getValueEncoding() const;
+
+  /// Sets the encoding of the values array.
+  void setValueEncoding(ValueEncoding valueEncoding);
+
 private:
   std::vector<ModeFormatPack> modeFormatPacks;
   std::vector<int> modeOrdering;
   std::vector<std::vector<Datatype>> levelArrayTypes;
+  ValueEncoding valueEncoding = ValueEncoding::Plain;
 };
 
 bool operator==(const Format&, const Format&);
 bool operator!=(const Format&, const Format&);
 std::ostream& operator<<(std::ostream&, const Format&);
 
+/// Returns the type of the codes stored in the values array of a tensor with
+/// the given value encoding and component type.
+Datatype getValueCodeType(ValueEncoding valueEncoding, Datatype componentType);
+
+/// Returns the largest number of distinct values a dictionary encoding can
+/// represent, or zero for encodings without a dictionary.
+size_t getValueDictionaryCapacity(ValueEncoding valueEncoding);
+
+std::ostream& operator<<(std::ostream&, const ValueEncoding&);
+
 
 /// The type of a mode defines how it is stored.  For example, a mode may be
 /// stored as a dense array, a compressed sparse representation, or a hash map.
@@ -87,12 +115,14 @@ public:
   static ModeFormat dense;       /// e.g., first mode in CSR
   static ModeFormat compressed;  /// e.g., second mode in CSR
   static ModeFormat singleton;   /// e.g., second mode in COO
+  static ModeFormat deltaCompressed; /// compressed with bit-packed deltas
 
   static ModeFormat sparse;      /// alias for compressed
   static ModeFormat Dense;       /// alias for dense
   static ModeFormat Compressed;  /// alias for compressed
   static ModeFormat Sparse;      /// alias for compressed
   static ModeFormat Singleton;   /// alias for singleton
+  static ModeFormat DeltaCompressed; /// alias for deltaCompressed
 
   /// Properties of a mode format
   enum Property {
@@ -156,6 +186,7 @@ public:
   friend bool operator==(const ModeFormat&, const ModeFormat&);
   friend bool operator!=(const ModeFormat&, const ModeFormat&);
   friend std::ostream& operator<<(std::ostream&, const ModeFormat&);
+  friend int getTileSize(const ModeFormat&);
 
 private:
   std::shared_ptr<const ModeFormatImpl> impl;
@@ -190,11 +221,13 @@ extern const ModeFormat Dense;
 extern const ModeFormat Compressed;
 extern const ModeFormat Sparse;
 extern const ModeFormat Singleton;
+extern const ModeFormat DeltaCompressed;
 
 extern const ModeFormat dense;
 extern const ModeFormat compressed;
 extern const ModeFormat sparse;
 extern const ModeFormat singleton;
+extern const ModeFormat deltaCompressed;
 
 extern const Format CSR;
 extern const Format CSC;
@@ -203,10 +236,23 @@ extern const Format DCSC;
 
 const Format COO(int order, bool isUnique = true, bool isOrdered = true, 
                  bool isAoS = false, const std::vector<int>& modeOrdering = {});
+
+/// A dense format that stores components in tiles, where `tileSizes[i]` is
+/// the extent of the tiles along mode i.  Modes are padded to a whole number
+/// of tiles.
+Format Tiled(const std::vector<int>& tileSizes,
+             const std::vector<int>& modeOrdering = {});
 /// @}
 
 /// True if all modes are dense.
 bool isDense(const Format&);
 
+/// True if the mode format is a tiled dense level (see `Tiled`).
+bool isTiled(const ModeFormat&);
+
+/// Returns the number of coordinates of a tiled level in each tile, or one if
+/// the level is not tiled.
+int getTileSize(const ModeFormat&);
+
 }
 #endif
@@ -41,6 +41,7 @@ class IndexStmt;
 class IndexExpr;
 class Assignment;
 class Access;
+class Semiring;
 
 class IterationAlgebra;
 
@@ -330,6 +331,8 @@ public:
   Literal(long);
   Literal(long long);
   Literal(int8_t);
+  Literal(float16);
+  Literal(bfloat16);
   Literal(float);
   Literal(double);
   Literal(std::complex<float>);
@@ -483,6 +486,52 @@ private:
   std::string name;
 };
 
+/// A structural mask that restricts an expression to the coordinates stored in
+/// a mask tensor or, if the mask is complemented, to the coordinates that are
+/// not stored in it.  Masked expressions follow GraphBLAS semantics: a masked assignment replaces the result, so
+/// entries outside the mask become zero, whereas a masked compound assignment
+/// accumulates into the result and leaves entries outside the mask unchanged.
+/// Lowering iterates over the mask's sparsity and computes only the sampled
+/// entries.
+/// ```
+/// // Sampled dense-dense matrix multiplication (SDDMM)
+/// C(i,j) = Mask(M(i,j))(A(i,k) * B(k,j));
+///
+/// // Accumulate the products that are not stored in M into C
+/// C(i,j) += Mask(M(i,j), true)(A(i,k) * B(k,j));
+/// ```
+class Mask {
+public:
+  Mask() = default;
+  explicit Mask(Access mask, bool complement=false);
+
+  /// Return the access of the mask tensor.
+  Access getAccess() const;
+
+  /// Returns true if the expression is restricted to the coordinates that are
+  /// not stored in the mask.
+  bool isComplemented() const;
+
+  /// Returns true if the mask is defined.
+  bool defined() const;
+
+  /// Returns true if the masked assignment that the mask was retrieved from
+  /// accumulates into its result, leaving the entries outside the mask as
+  /// they are.
+  bool accumulates() const;
+
+  /// Restrict an expression to the mask.  Index variables of the expression
+  /// that do not index the mask are summed over inside the mask, so that the
+  /// mask bounds the iteration space before any reduction.
+  Call operator()(IndexExpr expr) const;
+
+private:
+  Access mask;
+  bool complement = false;
+  bool accumulate = false;
+  friend class Assignment;
+};
+
 /// A call to an intrinsic.
 /// ```
 /// a(i) = abs(b(i));
@@ -640,15 +689,21 @@ public:
   /// All other iterators are merged with the "two finger" strategy.
   /// The two finger strategy merges by advancing each iterator one at a time, 
   /// while the gallop strategy implements the exponential search algorithm.
+  /// The SIMD block strategy advances iterators like the gallop strategy, but
+  /// skips over blocks of coordinates that are smaller than the next candidate
+  /// coordinate by comparing each block to it with SIMD instructions, which is
+  /// faster than galloping when the intersected iterators have similar
+  /// densities.
   /// 
   /// Preconditions:
   /// This command applies to variables involving sparse iterators only;
   /// it is a no-op if the variable invovles any dense iterators.
   /// Any variable can be merged with the two finger strategy, whereas gallop
-  /// only applies to a variable if its merge lattice has a single point 
-  /// (i.e. an intersection). For example, if a variable involves multiplications
-  /// only, it can be merged with gallop.
-  /// Furthermore, all iterators must be ordered for gallop to apply.
+  /// and SIMD block only apply to a variable if its merge lattice has a single
+  /// point (i.e. an intersection). For example, if a variable involves
+  /// multiplications only, it can be merged with gallop.
+  /// Furthermore, all iterators must be ordered for gallop and SIMD block to
+  /// apply.
   IndexStmt mergeby(IndexVar i, MergeStrategy strategy) const;
 
   /// The parallelize
@@ -764,7 +819,9 @@ public:
   /// assembled by appending or inserting nonzeros into the result tensor.
   /// In the latter case, the transformation inserts additional loops to 
   /// precompute statistics about the result tensor that are required for 
-  /// preallocating memory and coordinating insertions of nonzeros.
+  /// preallocating memory and coordinating insertions of nonzeros.  The
+  /// symbolic strategy also computes these statistics and inserts nonzeros
+  /// in parallel, so the result is allocated once instead of being grown.
   IndexStmt assemble(TensorVar result, AssembleStrategy strategy, 
                      bool separately_schedulable = false) const;
 
@@ -796,6 +853,17 @@ public:
   /// assignment into a compound assignment, e.g. `+=`.
   Assignment(Access lhs, IndexExpr rhs, IndexExpr op = IndexExpr());
 
+  /// Create a masked assignment that computes only the entries of the
+  /// right-hand side sampled by the mask.  If `op` is undefined the result is
+  /// replaced, otherwise the sampled entries are accumulated into it.
+  Assignment(Access lhs, IndexExpr rhs, Mask mask, IndexExpr op = IndexExpr());
+
+  /// Create an assignment that is evaluated over a semiring.  Products on the
+  /// right-hand side use the semiring's multiplication, while additions,
+  /// reductions, and the compound operator `op`, if any, use its addition.
+  Assignment(Access lhs, IndexExpr rhs, const Semiring& semiring,
+             IndexExpr op = IndexExpr());
+
   /// Create an assignment. Can specify an optional operator `op` that turns the
   /// assignment into a compound assignment, e.g. `+=`. Additionally, specify
   /// any modifers on reduction index variables (windows, index sets, etc.).
@@ -820,6 +888,10 @@ public:
   /// Return the reduction index variables i nthe assign
   std::vector<IndexVar> getReductionVars() const;
 
+  /// Return the assignment's mask or an undefined mask if the assignment is
+  /// not masked.
+  Mask getMask() const;
+
   typedef AssignmentNode Node;
 };
 
@@ -1149,6 +1221,10 @@ public:
   /// Set the name of the tensor variable.
   void setName(std::string name);
 
+  /// Set the format of the tensor variable. The format must have the same
+  /// order as the tensor variable.
+  void setFormat(const Format& format);
+
   /// Check whether the tensor variable is defined.
   bool defined() const;
 
@@ -0,0 +1,70 @@
+#ifndef TACO_SEMIRING_H
+#define TACO_SEMIRING_H
+
+#include <string>
+
+#include "taco/type.h"
+#include "taco/index_notation/index_notation.h"
+#include "taco/index_notation/tensor_operator.h"
+
+namespace taco {
+
+/// A semiring replaces the addition and multiplication of tensor algebra
+/// expressions with other operators, such as min and plus for shortest paths
+/// or or and and for breadth-first search.  The semiring's zero is the
+/// identity of its addition and annihilates its multiplication, so operands
+/// whose fill value is the zero are iterated over only where they are stored
+/// and reductions stop as soon as they reach an annihilator of the addition.
+/// ```
+/// const double inf = std::numeric_limits<double>::infinity();
+/// Tensor<double> A("A", {n,n}, CSR, inf);
+/// Tensor<double> d("d", {n}, {Dense}, inf);
+/// ...
+/// Semiring minPlus = Semiring::minPlus(Float64);
+/// // One step of the Bellman-Ford shortest paths algorithm
+/// y(i) = minPlus(sum(j, A(i,j) * d(j)));
+/// ```
+class Semiring {
+public:
+  /// Create a semiring from its addition and multiplication, which must be
+  /// binary operators, and its zero.
+  Semiring(std::string name, Func add, Func multiply, Literal zero);
+
+  /// Return the name of the semiring.
+  const std::string& getName() const;
+
+  /// Return the semiring's addition, which also reduces sum reductions.
+  const Func& getAdd() const;
+
+  /// Return the semiring's multiplication.
+  const Func& getMultiply() const;
+
+  /// Return the semiring's zero, the fill value of its operands.
+  const Literal& getZero() const;
+
+  /// Evaluate an expression over the semiring: products are computed with
+  /// the semiring's multiplication, and additions and sum reductions with its
+  /// addition.  The expression must sum over its reduction variables
+  /// explicitly, as in reduction notation.
+  IndexExpr operator()(IndexExpr expr) const;
+
+  /// The tropical semiring (min, +), whose zero is infinity.
+  static Semiring minPlus(Datatype type);
+
+  /// The (max, *) semiring over non-negative numbers, whose zero is zero.
+  static Semiring maxTimes(Datatype type);
+
+  /// The boolean semiring (or, and), whose zero is false.
+  static Semiring orAnd(Datatype type);
+
+private:
+  std::string name;
+  Func add;
+  Func multiply;
+  Literal zero;
+};
+
+std::ostream& operator<<(std::ostream&, const Semiring&);
+
+}
+#endif
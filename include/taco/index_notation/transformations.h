@@ -5,6 +5,7 @@
 #include <string>
 #include <ostream>
 #include <vector>
+#include <map>
 #include "index_notation.h"
 
 namespace taco {
@@ -252,11 +253,45 @@ IndexStmt reorderLoopsTopologically(IndexStmt stmt);
  */
 IndexStmt scalarPromote(IndexStmt stmt);
 
+/**
+ * Changes the type of the scalar temporaries that reductions accumulate into
+ * to `type`, if it is wider than their type, so that results stored at a low
+ * precision are accumulated at a higher one.
+ */
+IndexStmt widenAccumulators(IndexStmt stmt, Datatype type);
+
 /**
  * Insert where statements with temporaries into the following statements kinds:
  * 1. The result is a is scattered into but does not support random insert.
  */
 IndexStmt insertTemporaries(IndexStmt stmt);
 
+/**
+ * Precomputes subexpressions of a loop nest's assignment that occur more than
+ * once, or that do not depend on every loop of the nest, into temporaries
+ * with where statements.  A subexpression that depends on an outer prefix of
+ * the loops is precomputed into a scalar inside the innermost loop of the
+ * prefix, and one that depends on the prefix and one more loop into a vector
+ * that is indexed by it.  Only subexpressions that read dense tensors are
+ * precomputed, so the iteration space of the nest does not change.
+ */
+IndexStmt eliminateCommonSubexpressions(IndexStmt stmt);
+
+/**
+ * Rewrites an assignment whose right-hand side sums a product of three or more
+ * tensors into a sequence of binary contractions, where each contraction but
+ * the last computes a dense temporary that is consumed by a later one.  The
+ * order of the contractions is chosen to minimize an estimate of the number
+ * of multiplications, which uses the operand dimensions and the number of
+ * nonzeros in `nonzeros` (operands without an entry are assumed dense).  The
+ * result is in concrete index notation, with the contractions nested in
+ * where statements.  If no order is estimated to be cheaper than a single
+ * loop nest over all index variables, or if the last contraction would have
+ * to scatter into a sparse result, the assignment is returned unchanged.
+ */
+IndexStmt optimizeContractionOrder(Assignment assignment,
+                                   const std::map<TensorVar,size_t>& nonzeros =
+                                       std::map<TensorVar,size_t>());
+
 }
 #endif
@@ -80,7 +80,8 @@ enum class TensorProperty {
   Indices,
   Values,
   FillValue,
-  ValuesSize
+  ValuesSize,
+  ValueDictionary
 };
 
 /** Base class for backend IR */
@@ -615,7 +616,9 @@ struct Switch : public StmtNode<Switch> {
   static const IRNodeType _type_info = IRNodeType::Switch;
 };
 
-enum class LoopKind {Serial, Static, Dynamic, Runtime, Vectorized, Static_Chunked};
+/// LoopKind::Tasks loops are outlined into a function that runs on the
+/// subranges of the loop handed out by the work-stealing task runtime.
+enum class LoopKind {Serial, Static, Dynamic, Runtime, Vectorized, Static_Chunked, Tasks};
 
 /** A for loop from start to end by increment.
  * A vectorized loop will require the increment to be 1 and the
@@ -792,6 +795,10 @@ struct GetProperty : public ExprNode<GetProperty> {
   static Expr make(Expr tensor, TensorProperty property, int mode=0);
   static Expr make(Expr tensor, TensorProperty property, int mode,
                    int index, std::string name);
+
+  /// Make a values array property whose elements have a type other than the
+  /// tensor component type (e.g. the codes of dictionary-encoded values).
+  static Expr make(Expr tensor, TensorProperty property, Datatype type);
   
   static const IRNodeType _type_info = IRNodeType::GetProperty;
 };
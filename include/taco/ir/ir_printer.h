@@ -23,6 +23,10 @@ public:
   void print(Stmt);
 
 protected:
+  /// Returns the statement that `print` emits for `stmt`, which is simplified
+  /// if the printer was asked to simplify.
+  Stmt getPrintedStmt(Stmt stmt);
+
   virtual void visit(const Literal*);
   virtual void visit(const Var*);
   virtual void visit(const Neg*);
@@ -4,12 +4,17 @@
 namespace taco {
 
 /// ParallelUnit::CPUThread generates a pragma to parallelize over CPU threads
+/// ParallelUnit::CPUThreadBalanced parallelizes over CPU threads like CPUThread,
+///   but splits a dense loop over the rows of a compressed level into chunks
+///   with an equal number of nonzeros rather than an equal number of rows
+/// ParallelUnit::CPUTask splits the loop into tasks that run on taco's
+///   work-stealing runtime instead of OpenMP
 /// ParallelUnit::CPUVector generates a pragma to utilize a CPU vector unit
 /// ParallelUnit::GPUBlock must be used with GPUThread to create blocks of GPU threads
 /// ParallelUnit::GPUWarp can be optionally used to allow for GPU warp-level primitives
 /// ParallelUnit::GPUThread causes for every iteration to be executed on a separate GPU thread
 enum class ParallelUnit {
-  NotParallel, DefaultUnit, GPUBlock, GPUWarp, GPUThread, CPUThread, CPUVector, CPUThreadGroupReduction, GPUBlockReduction, GPUWarpReduction
+  NotParallel, DefaultUnit, GPUBlock, GPUWarp, GPUThread, CPUThread, CPUVector, CPUThreadGroupReduction, GPUBlockReduction, GPUWarpReduction, CPUThreadBalanced, CPUTask
 };
 extern const char *ParallelUnit_NAMES[];
 
@@ -28,15 +33,25 @@ enum class BoundType {
 };
 extern const char *BoundType_NAMES[];
 
+/// AssembleStrategy::Append appends nonzeros to the result, growing its arrays
+/// as needed
+/// AssembleStrategy::Insert first computes statistics about the result, such
+/// as the number of nonzeros in each row, which are used to allocate it once
+/// before nonzeros are inserted
+/// AssembleStrategy::Symbolic inserts like Insert, but computes the
+/// statistics in a separate symbolic phase and distributes the outermost loops
+/// of both the symbolic and numeric phases across CPU threads
 enum class AssembleStrategy {
-  Append, Insert
+  Append, Insert, Symbolic
 };
 extern const char *AssembleStrategy_NAMES[];
 
 /// MergeStrategy::TwoFinger merges iterators by incrementing one at a time
 /// MergeStrategy::Galloping merges iterators by exponential search (galloping)
+/// MergeStrategy::SimdBlock merges iterators by comparing blocks of
+/// coordinates to the next candidate coordinate with SIMD instructions
 enum class MergeStrategy {
-  TwoFinger, Gallop
+  TwoFinger, Gallop, SimdBlock
 };
 extern const char *MergeStrategy_NAMES[];
 
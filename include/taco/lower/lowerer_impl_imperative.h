@@ -70,6 +70,18 @@ protected:
   /// Lower a forall statement.
   virtual ir::Stmt lowerForall(Forall forall);
 
+  /// Lower a CPU-parallel forall whose iterations reduce into the same
+  /// elements of dense results (OutputRaceStrategy::Temporary) by giving every
+  /// thread a private copy of those results, and summing the copies into the
+  /// results with a parallel tree reduction after the loop.
+  virtual ir::Stmt lowerForallPrivatized(Forall forall);
+
+  /// Lower a nest of foralls that computes a dense matrix-matrix or
+  /// matrix-vector product to a call to a BLAS, which falls back to the
+  /// lowered loops when no BLAS is configured.  Returns an undefined statement
+  /// if the forall is not such a product.
+  virtual ir::Stmt lowerForallBlas(Forall forall);
+
   /// Lower a forall that needs to be cloned so that one copy does not have guards
   /// used for vectorized and unrolled loops
   virtual ir::Stmt lowerForallCloned(Forall forall);
@@ -84,6 +96,15 @@ protected:
                                         std::set<Access> reducedAccesses,
                                         ir::Stmt recoveryStmt);
 
+  /// Lower a CPU-parallel dimension loop whose locators include a dense level
+  /// above a compressed level, by splitting the rows into one chunk per thread
+  /// such that every chunk holds roughly the same number of nonzeros. Returns
+  /// an undefined statement if no locator has such a level.
+  virtual ir::Stmt lowerForallBalanced(Forall forall, ir::Expr coordinate,
+                                       std::vector<ir::Expr> bounds,
+                                       std::vector<Iterator> locators,
+                                       ir::Stmt body);
+
   /// Lower a forall that iterates over all the coordinates in the forall index
   /// var's dimension, and locates tensor positions from the locate iterators.
   virtual ir::Stmt lowerForallDenseAcceleration(Forall forall,
@@ -147,7 +168,8 @@ protected:
      *      A concrete index notation statement to compute at the points in the
      *      sparse iteration space described by the merge lattice.
      * \param mergeStrategy
-     *      A strategy for merging iterators. One of TwoFinger or Gallop.
+     *      A strategy for merging iterators. One of TwoFinger, Gallop or
+     *      SimdBlock.
      *
      * \return
      *       IR code to compute the forall loop.
@@ -174,7 +196,8 @@ protected:
      *      sparse iteration space region described by the merge point.
      * \param mergeWithMax
      *      A boolean indicating whether coordinates should be combined with MAX instead of MIN.
-     *      MAX is needed when the iterators are merged with the Gallop strategy.
+     *      MAX is needed when the iterators are merged with the Gallop or
+     *      SimdBlock strategy.
      */
   virtual ir::Stmt lowerMergePoint(MergeLattice pointLattice,
                                    ir::Expr coordinate, IndexVar coordinateVar, IndexStmt statement,
@@ -338,9 +361,11 @@ protected:
                                const std::set<Access>& reducedAccesses);
   /**
    * Generate code to initialize values array in range
-   * [begin * size, (begin + 1) * size) with the fill value.
+   * [begin * size, (begin + 1) * size) with the fill value.  Large arrays are
+   * initialized by a parallel loop of the given kind.
    */
-  ir::Stmt initValues(ir::Expr tensor, ir::Expr initVal, ir::Expr begin, ir::Expr size);
+  ir::Stmt initValues(ir::Expr tensor, ir::Expr initVal, ir::Expr begin, ir::Expr size,
+                      ir::LoopKind parallelKind=ir::LoopKind::Static_Chunked);
 
   /// Declare position variables and initialize them with a locate.
   ir::Stmt declLocatePosVars(std::vector<Iterator> iterators);
@@ -397,6 +422,10 @@ protected:
   /// Create an expression to index into a tensor value array.
   ir::Expr generateValueLocExpr(Access access) const;
 
+  /// Create an expression that loads the tensor value at the given location of
+  /// its value array, decoding the value if the tensor has encoded values.
+  ir::Expr generateValueLoadExpr(TensorVar var, ir::Expr loc) const;
+
   /// Expression that evaluates to true if none of the iterators are exhausted
   ir::Expr checkThatNoneAreExhausted(std::vector<Iterator> iterators);
 
@@ -505,6 +534,15 @@ private:
 
   std::set<TensorVar> needCompute;
 
+  /// Result tensors of the statement being lowered
+  std::set<TensorVar> resultTensors;
+
+  /// Whether the results of the enclosing forall are being privatized
+  bool privatizingResults = false;
+
+  /// Whether the loops of a product offloaded to a BLAS are being lowered
+  bool loweringBlasFallback = false;
+
   int markAssignsAtomicDepth = 0;
   ParallelUnit atomicParallelUnit;
 
@@ -512,6 +550,15 @@ private:
 
   std::set<ir::Expr> nonFullyInitializedResults;
 
+  /// Results that masked assignments accumulate into.
+  std::set<TensorVar> accumulatedResults;
+
+  /// The kind of loop that initializes the values of results before they are
+  /// computed.  It matches the schedule of the parallel loop that computes
+  /// the results, so that on NUMA systems every page of a result is first
+  /// touched, and thus placed, by the thread that later writes to it.
+  ir::LoopKind resultInitLoopKind = ir::LoopKind::Static_Chunked;
+
   /// Map used to hoist temporary workspace initialization
   std::map<Forall, Where> temporaryInitialization;
 
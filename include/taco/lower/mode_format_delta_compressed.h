@@ -0,0 +1,50 @@
+#ifndef TACO_MODE_FORMAT_DELTA_COMPRESSED_H
+#define TACO_MODE_FORMAT_DELTA_COMPRESSED_H
+
+#include "taco/lower/mode_format_impl.h"
+
+namespace taco {
+
+/// A compressed mode format whose coordinates are delta encoded and bit
+/// packed.  Coordinates are split into blocks of `BlockSize` positions, and
+/// each coordinate is stored as its offset from the smallest coordinate of its
+/// block using a bit width that is fixed across the level.  A level stores
+/// three arrays:
+///   - pos: the same segment array as a compressed level,
+///   - crd: the packed offsets as 32-bit words, and
+///   - crd_hdr: the bit width followed by the base coordinate of each block.
+/// Generated code decodes coordinates on the fly with `taco_unpack_crd`.
+/// Levels are packed as compressed levels and encoded afterwards, so this
+/// mode format can only be used for operands.
+class DeltaCompressedModeFormat : public ModeFormatImpl {
+public:
+  static const int BlockSize = 32;
+
+  DeltaCompressedModeFormat();
+  DeltaCompressedModeFormat(bool isFull, bool isOrdered,
+                            bool isUnique, bool isZeroless);
+
+  ~DeltaCompressedModeFormat() override {}
+
+  ModeFormat copy(std::vector<ModeFormat::Property> properties) const override;
+
+  ModeFunction posIterBounds(ir::Expr parentPos, Mode mode) const override;
+  ModeFunction posIterAccess(ir::Expr pos, std::vector<ir::Expr> coords,
+                             Mode mode) const override;
+
+  ModeFunction coordBounds(ir::Expr parentPos, Mode mode) const override;
+
+  std::vector<ir::Expr> getArrays(ir::Expr tensor, int mode,
+                                  int level) const override;
+
+protected:
+  ir::Expr getPosArray(ModePack pack) const;
+  ir::Expr getCoordArray(ModePack pack) const;
+  ir::Expr getCoordHeaderArray(ModePack pack) const;
+
+  ir::Expr unpackCoord(ir::Expr pos, Mode mode) const;
+};
+
+}
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef TACO_MODE_FORMAT_TILED_H
+#define TACO_MODE_FORMAT_TILED_H
+
+#include "taco/lower/mode_format_impl.h"
+
+namespace taco {
+
+/// A dense mode format whose components are laid out in tiles.  A tensor whose
+/// levels are all tiled stores its components tile by tile, with the tiles
+/// ordered lexicographically and the components of each tile stored
+/// contiguously in row-major order.  The levels of a tile have `tileSize`
+/// coordinates each, and the tile grid of a level has ceil(N/tileSize) tiles,
+/// so levels are padded to a multiple of the tile size.
+///
+/// Positions of a tiled level encode both the tile and the coordinates within
+/// the tile.  A level therefore needs the product of the tile sizes of its
+/// ancestor levels (`tileVolume`) to split the position of its parent.  Use
+/// `Tiled` in format.h to construct formats of tiled levels.
+class TiledModeFormat : public ModeFormatImpl {
+public:
+  using ModeFormatImpl::getInsertCoord;
+
+  TiledModeFormat(int tileSize, int tileVolume);
+  TiledModeFormat(int tileSize, int tileVolume, bool isOrdered, bool isUnique,
+                  bool isZeroless);
+
+  ~TiledModeFormat() override {}
+
+  ModeFormat copy(std::vector<ModeFormat::Property> properties) const override;
+
+  ModeFunction locate(ir::Expr parentPos, std::vector<ir::Expr> coords,
+                      Mode mode) const override;
+
+  ir::Stmt getInsertCoord(ir::Expr p, const std::vector<ir::Expr>& i,
+                          Mode mode) const override;
+  ir::Expr getWidth(Mode mode) const override;
+  ir::Stmt getInsertInitCoords(ir::Expr pBegin, ir::Expr pEnd,
+                               Mode mode) const override;
+  ir::Stmt getInsertInitLevel(ir::Expr szPrev, ir::Expr sz,
+                              Mode mode) const override;
+  ir::Stmt getInsertFinalizeLevel(ir::Expr szPrev, ir::Expr sz,
+                                  Mode mode) const override;
+
+  ir::Expr getAssembledSize(ir::Expr prevSize, Mode mode) const override;
+  ModeFunction getYieldPos(ir::Expr parentPos, std::vector<ir::Expr> coords,
+                           Mode mode) const override;
+
+  std::vector<ir::Expr> getArrays(ir::Expr tensor, int mode,
+                                  int level) const override;
+
+  /// Returns the number of coordinates of the level in each tile.
+  int getTileSize() const;
+
+  /// Returns the number of components of the ancestor levels in each tile.
+  int getTileVolume() const;
+
+protected:
+  bool equals(const ModeFormatImpl& other) const override;
+
+  ir::Expr getSizeArray(ModePack pack) const;
+
+  const int tileSize;
+  const int tileVolume;
+};
+
+}
+
+#endif
@@ -19,10 +19,12 @@ class EinsumParser : public util::Uncopyable {
 
 public:
 
-  /// Create a parser object from einsum notation
+  /// Create a parser object from einsum notation. If optimize is true, the
+  /// result of a product of three or more tensors is computed by contracting
+  /// them pairwise in the cheapest order.
   /// @throws ParserError is there is an error with parsing the einsum string
   EinsumParser(const std::string &expression, std::vector<TensorBase> &tensors,
-               Format &format, Datatype outType);
+               Format &format, Datatype outType, bool optimize=false);
 
   /// Returns true if the expression passed in has an output specified and false otherwise
   /// @throws ParserError if output is not specified correctly
@@ -41,6 +43,7 @@ private:
   std::string einsumPunctuation;
   Datatype outType;
   Format format;
+  bool optimize;
 
 
   std::string subscripts;
@@ -4,6 +4,8 @@
 #include <string>
 #include <vector>
 
+#include "taco/index_notation/index_notation.h"
+
 namespace taco {
 namespace parser {
 
@@ -14,6 +16,13 @@ std::vector<std::vector<std::string>> ScheduleParser(const std::string);
 
 std::vector<std::string> varListParser(const std::string);
 
+// apply parsed schedule directives, such as the output of ScheduleParser, to
+// a statement.  If usesGPU is given, it is set to whether the directives
+// parallelize loops over GPU units.
+IndexStmt applySchedule(IndexStmt stmt,
+                        std::vector<std::vector<std::string>> scheduleCommands,
+                        bool* usesGPU=nullptr);
+
 // serialize the result of a parse (for debugging)
 std::string serializeParsedSchedule(std::vector<std::vector<std::string>>);
 
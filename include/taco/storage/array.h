@@ -66,6 +66,19 @@ Array makeArray(T* data, size_t size, Array::Policy policy=Array::UserOwns) {
 /// Construct an array of elements of the given type.
 Array makeArray(Datatype type, size_t size);
 
+/// A function that allocates the memory of arrays constructed by `makeArray`.
+/// The arrays release the memory with the C free function.
+typedef void* (*ArrayAllocator)(size_t bytes);
+
+/// Allocates memory that is aligned to 64 bytes.  Allocations that span
+/// several huge pages are aligned to huge pages instead, and the kernel is
+/// advised to back them with transparent huge pages.  This is the default
+/// array allocator, and mirrors `taco_malloc` in generated code.
+void* allocateAligned(size_t bytes);
+
+/// Set the allocator of arrays constructed by `makeArray`.
+void setArrayAllocator(ArrayAllocator allocator);
+
 /// Construct an Array from the values.
 template <typename T>
 Array makeArray(const std::vector<T>& values) {
@@ -0,0 +1,71 @@
+#ifndef TACO_STORAGE_STATISTICS_H
+#define TACO_STORAGE_STATISTICS_H
+
+#include <vector>
+#include <ostream>
+
+namespace taco {
+
+/// Statistics about the nonzero structure of a tensor that are cheap to
+/// collect while the tensor is packed, and that are used to choose formats.
+class TensorStatistics {
+public:
+  /// Construct undefined statistics.
+  TensorStatistics();
+
+  /// Collect statistics from coordinates that are sorted lexicographically in
+  /// the given mode ordering.  The coordinates are stored `stride` bytes
+  /// apart, and the j-th integer of a coordinate is its coordinate in mode
+  /// modeOrdering[j].  Duplicate coordinates are counted once.
+  TensorStatistics(const std::vector<int>& dimensions,
+                   const std::vector<int>& modeOrdering,
+                   const char* coordinates, size_t numCoordinates,
+                   size_t stride);
+
+  /// Returns true if statistics have been collected.
+  bool defined() const;
+
+  /// Returns the order of the tensor.
+  int getOrder() const;
+
+  /// Returns the dimension of the given mode.
+  int getDimension(int mode) const;
+
+  /// Returns the number of distinct nonzero coordinates.
+  size_t getNumNonzeros() const;
+
+  /// Returns the number of slices of a mode (e.g., rows for mode 0 of a
+  /// matrix) that contain at least one nonzero.
+  size_t getNumNonEmptySlices(int mode) const;
+
+  /// Returns the fraction of the slices of a mode that contain no nonzeros.
+  double getEmptySliceFraction(int mode) const;
+
+  /// Returns the largest number of nonzeros in any slice of a mode.
+  size_t getMaxSliceNonzeros(int mode) const;
+
+  /// Returns the mode ordering the fiber statistics were collected in.
+  const std::vector<int>& getModeOrdering() const;
+
+  /// Returns the number of distinct coordinate prefixes that span levels
+  /// 0 to `level` of the mode ordering, i.e., the number of entries a sparse
+  /// level would store.
+  size_t getNumFibers(int level) const;
+
+  /// Returns the fraction of the coordinates of a level, given its prefix,
+  /// that are nonzero, i.e., the density of the level if it were dense.
+  double getLevelDensity(int level) const;
+
+private:
+  std::vector<int> dimensions;
+  std::vector<int> modeOrdering;
+  std::vector<size_t> numNonEmptySlices;
+  std::vector<size_t> maxSliceNonzeros;
+  std::vector<size_t> numFibers;
+  bool isDefined;
+};
+
+std::ostream& operator<<(std::ostream&, const TensorStatistics&);
+
+}
+#endif
@@ -52,9 +52,14 @@ public:
   /// Returns the value array that contains the tensor components.
   const Array& getValues() const;
 
-  /// Returns the tensor component value array.
+  /// Returns the tensor component value array.  If the values are encoded
+  /// (see ValueEncoding) then the array holds the value codes.
   Array getValues();
 
+  /// Returns the dictionary of distinct values that value codes index into.
+  /// Undefined unless the format has a dictionary value encoding.
+  const Array& getValueDictionary() const;
+
   /// Returns the full value attached to the tensor storage
   Literal getFillValue();
 
@@ -70,6 +75,9 @@ public:
   /// Set the tensor component value array.
   void setValues(const Array& values);
 
+  /// Set the dictionary of distinct values that value codes index into.
+  void setValueDictionary(const Array& dictionary);
+
 
 private:
   struct Content;
@@ -78,6 +86,14 @@ private:
 
 
 
+/// Encode the plain values array of tensor storage in place, as specified by
+/// the value encoding of the storage format.
+void encodeValues(TensorStorage storage);
+
+/// Encode the coordinates of tensor storage levels that were packed as
+/// compressed levels but whose format is delta compressed.
+void encodeCoordinates(TensorStorage storage);
+
 /// Compare tensor storage objects.
 bool equals(TensorStorage a, TensorStorage b);
 
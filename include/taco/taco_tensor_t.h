@@ -20,6 +20,7 @@ typedef struct taco_tensor_t {
   uint8_t*     vals;          // tensor values
   uint8_t*     fill_value;    // tensor fill value
   int32_t      vals_size;     // values array size
+  uint8_t*     vals_dict;     // value dictionary (dictionary-encoded values)
 } taco_tensor_t;
 
 taco_tensor_t *init_taco_tensor_t(int32_t order, int32_t csize,
@@ -1,6 +1,7 @@
 #ifndef TACO_TENSOR_H
 #define TACO_TENSOR_H
 
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -21,6 +22,7 @@
 #include "taco/storage/array.h"
 #include "taco/storage/typed_vector.h"
 #include "taco/storage/typed_index.h"
+#include "taco/storage/statistics.h"
 
 #include "taco/error.h"
 #include "taco/error/error_messages.h"
@@ -39,6 +41,9 @@ struct AccessTensorNode;
 template <typename CType>
 struct ScalarAccess;
 
+struct AutotuneOptions;
+struct ScheduleTiming;
+
 /// TensorBase is the super-class for all tensors. You can use it directly to
 /// avoid templates, or you can use the templated `Tensor<T>` that inherits from
 /// `TensorBase`.
@@ -121,6 +126,11 @@ public:
   /// Returns the tensor var for this tensor.
   const TensorVar& getTensorVar() const;
 
+  /// Returns statistics about the nonzero structure of the tensor, collected
+  /// the last time the tensor was packed.  The statistics are undefined if the
+  /// tensor has not been packed or if it was computed from an expression.
+  const TensorStatistics& getStatistics() const;
+
   /// Set the expression to be evaluated when calling compute or assemble.
   void setAssignment(Assignment assignment);
 
@@ -419,6 +429,30 @@ public:
   /// Pack tensor into the given format
   void pack();
 
+  /// Repack the tensor's components into a different format.
+  void repack(Format format);
+
+  /// Returns a copy of the tensor stored in the given format.  Copies are
+  /// cached until the tensor is modified, so repeated conversions are free.
+  TensorBase convert(Format format);
+
+  /// If enabled, the tensor is repacked into the format returned by
+  /// `suggestFormat` before an expression that reads it is compiled.
+  void setAutomaticFormatSelection(bool automaticFormatSelection);
+
+  /// If enabled, an expression that multiplies three or more tensors is
+  /// computed as a sequence of binary contractions in the order returned by
+  /// `optimizeContractionOrder`, when that is estimated to be cheaper.
+  void setAutomaticContractionOrdering(bool automaticContractionOrdering);
+
+  /// Set the type that reductions into the tensor accumulate in, when it is
+  /// wider than the component type.  Reductions into 16-bit float tensors
+  /// accumulate in float unless a wider type is set.
+  void setAccumulationType(Datatype accumulationType);
+
+  /// Returns the type that reductions into the tensor accumulate in.
+  Datatype getAccumulationType() const;
+
   /// Compile the tensor expression.
   void compile();
 
@@ -498,6 +532,8 @@ public:
   friend std::ostream& operator<<(std::ostream&, TensorBase&);
 
   friend struct AccessTensorNode;
+  friend std::string autotune(TensorBase&, const AutotuneOptions&,
+                              std::vector<ScheduleTiming>*);
   std::vector<TensorBase> getDependentTensors();
 private:
   static std::shared_ptr<ir::Module> getHelperFunctions(
@@ -505,6 +541,7 @@ private:
   static std::shared_ptr<ir::Module> getComputeKernel(const IndexStmt stmt);
   static void cacheComputeKernel(const IndexStmt stmt, 
                                  const std::shared_ptr<ir::Module> kernel);
+  static void evictComputeKernels(const TensorVar& tensorVar);
 
   /* --- Compiler Methods --- */
   bool neverPacked();
@@ -535,7 +572,8 @@ protected:
 
 private:
   template <typename CType>
-  void reinsertPackedComponents();
+  void reinsertPackedComponents(TensorBase tensor);
+  void reinsertPackedComponents(TensorBase tensor, Datatype ctype);
 
   struct Content;
   std::shared_ptr<Content> content;
@@ -738,6 +776,12 @@ TensorBase read(std::string filename, ModeFormat modeType, bool pack = true);
 /// and the tensor is returned packed by default.
 TensorBase read(std::string filename, Format format, bool pack = true);
 
+/// Read a tensor from a file with components of the given type, which the
+/// values in the file are rounded to.  The file format is inferred from the
+/// filename and the tensor is returned packed by default.
+TensorBase read(std::string filename, Format format, Datatype ctype,
+                bool pack = true);
+
 /// Read a tensor from a file of the given file format and the tensor is
 /// returned packed by default.
 TensorBase read(std::string filename, FileType filetype, ModeFormat modetype,
@@ -758,6 +802,23 @@ TensorBase read(std::istream& stream, FileType filetype, ModeFormat modetype,
 TensorBase read(std::istream& stream, FileType filetype, Format format,
                 bool pack = true);
 
+/// Suggest a format for a packed tensor from the statistics collected when it
+/// was packed.  Levels are stored dense or compressed depending on their
+/// density, and hypersparse tensors are stored as coordinate lists.  If a
+/// context expression that reads the tensor is given, then the modes are
+/// ordered the way loops over the expression will iterate over them.
+Format suggestFormat(const TensorBase& tensor, IndexExpr context=IndexExpr());
+
+/// Suggest formats to convert operands of an assignment into when their mode
+/// orderings disagree with the order the assignment's loops iterate over the
+/// result.  An operand is converted if the loops cannot be ordered around its
+/// format, or if the estimated cost of converting it is lower than the cost
+/// of the loop order and result scatter workspace its format would force.
+/// Operands that should keep their format are not in the returned map.
+std::map<TensorVar,Format>
+suggestOperandFormats(Assignment assignment,
+                      const std::vector<TensorBase>& operands);
+
 /// Write a tensor to a file. The file format is inferred from the filename.
 void write(std::string filename, const TensorBase& tensor);
 
@@ -904,6 +965,7 @@ struct TensorBase::Content {
   ir::Stmt           computeFunc;
   bool               assembleWhileCompute;
   std::shared_ptr<ir::Module> module;
+  std::vector<TensorVar> arguments;
 
   size_t             coordinateBufferUsed;
   size_t             coordinateSize;
@@ -915,13 +977,19 @@ struct TensorBase::Content {
   bool               needsAssemble;
   bool               needsCompute;
   std::vector<std::weak_ptr<TensorBase::Content>> dependentTensors;
+
+  TensorStatistics   statistics;
+  bool               automaticFormatSelection;
+  bool               automaticContractionOrdering;
+  Datatype           accumulationType;
+  std::vector<TensorBase> conversions;
   unsigned int       uniqueId;
 
   Content(std::string name, Datatype dataType, const std::vector<int>& dimensions,
           Format format, Literal fill)
       : dataType(dataType), dimensions(dimensions),
         storage(TensorStorage(dataType, dimensions, format, fill)),
-        tensorVar(TensorVar(util::getUniqueId(), name, Type(dataType,convert(dimensions)),format, fill)) {
+        tensorVar(TensorVar(util::getUniqueId(), name, Type(dataType,taco::convert(dimensions)),format, fill)) {
           uniqueId = tensorVar.getId();
         }
 };
@@ -1000,7 +1068,7 @@ void TensorBase::insertUnchecked(
 }
 
 template <typename CType>
-void TensorBase::reinsertPackedComponents() {
+void TensorBase::reinsertPackedComponents(TensorBase tensor) {
   auto begin = iteratorPacked<CType>().begin();
   auto end = iteratorPacked<CType>().end();
   std::vector<int> coords(getOrder());
@@ -1008,7 +1076,7 @@ void TensorBase::reinsertPackedComponents() {
     for (size_t i = 0; i < (size_t)getOrder(); ++i) {
       coords[i] = it->first[i];
     }
-    insertUnsynced(coords, it->second);
+    tensor.insertUnsynced(coords, it->second);
   }
 }
 
@@ -1336,5 +1404,48 @@ void taco_set_num_threads(int num_threads);
 /// computations. This will be replaced by a scheduling language in the future.
 int taco_get_num_threads();
 
+/// Policies for placing the storage of tensors on the nodes of NUMA systems.
+/// With FirstTouch, pages are placed on the node of the thread that first
+/// writes to them.  Generated code initializes results with the schedule of
+/// the parallel loop that computes them, so each thread's part of a result is
+/// local to it.  With Interleave, the index and value arrays of tensors that
+/// are packed are also spread page by page across all nodes, which balances
+/// the bandwidth of operands that every thread reads.
+enum class NumaPolicy {
+  FirstTouch, Interleave
+};
+
+/// Set the policy for placing tensor storage on NUMA nodes.  Interleave only
+/// has an effect on Linux systems with more than one node.
+void taco_set_numa_policy(NumaPolicy policy);
+
+/// Get the policy for placing tensor storage on NUMA nodes.
+NumaPolicy taco_get_numa_policy();
+
+/// Set whether computations are fused with the computations of their operands
+/// that have been assigned but not yet computed.  An operand that is fused is
+/// not stored unless it is read later, in which case it is computed on its
+/// own.  For example, with fusion the chain `T(i,j) = A(i,k)*B(k,j);
+/// C(i,j) = T(i,j) + D(i,j)` is computed by one kernel when C is read, which
+/// keeps each component of T in a scalar temporary.
+void taco_set_fusion(bool fusion);
+
+/// Get whether computations are fused with the computations of their operands.
+bool taco_get_fusion();
+
+/// Set the BLAS library that dense matrix-matrix and matrix-vector products
+/// are offloaded to, given as the name or path of a shared library with the
+/// CBLAS interface (e.g. "libopenblas.so.0").  Kernels that are compiled
+/// afterwards call its gemm and gemv routines for loop nests such as
+/// `A(i,j) = B(i,k) * C(k,j)` over dense operands, and run their own loops
+/// if no BLAS is set.  The default is the library named by the TACO_BLAS
+/// environment variable, if any.  Returns false if the library cannot be
+/// loaded, in which case no BLAS is used.
+bool taco_set_blas(const std::string& library);
+
+/// Get the handle of the BLAS library that dense products are offloaded to,
+/// or null if there is none.
+void* taco_get_blas();
+
 }
 #endif
@@ -11,6 +11,43 @@
 
 namespace taco {
 
+/// A 16-bit IEEE 754 half precision floating point number.  Values are stored
+/// in 16 bits and converted to float for arithmetic.
+class float16 {
+public:
+  float16() = default;
+  float16(float value);
+  operator float() const;
+
+  /// Create a half precision number from its bit pattern.
+  static float16 fromBits(uint16_t bits);
+
+  /// Returns the bit pattern of the number.
+  uint16_t getBits() const;
+
+private:
+  uint16_t bits;
+};
+
+/// A 16-bit brain floating point number, which has the exponent range of a
+/// float and an 8-bit significand.  Values are stored in 16 bits and
+/// converted to float for arithmetic.
+class bfloat16 {
+public:
+  bfloat16() = default;
+  bfloat16(float value);
+  operator float() const;
+
+  /// Create a brain floating point number from its bit pattern.
+  static bfloat16 fromBits(uint16_t bits);
+
+  /// Returns the bit pattern of the number.
+  uint16_t getBits() const;
+
+private:
+  uint16_t bits;
+};
+
 /// A basic taco type. These can be boolean, integer, unsigned integer, float
 /// or complex float at different precisions.
 class Datatype {
@@ -28,6 +65,8 @@ public:
     Int32,
     Int64,
     Int128,
+    Float16,
+    BFloat16,
     Float32,
     Float64,
     Complex64,
@@ -53,6 +92,10 @@ public:
   bool isBool() const;
   /// @}
 
+  /// True if the type is a 16-bit floating point type.  Kernels load and store
+  /// values of these types in 16 bits but compute on them in float.
+  bool isReducedPrecision() const;
+
   /// Returns the number of bytes required to store one element of this type.
   int getNumBytes() const;
 
@@ -82,6 +125,8 @@ extern Datatype Int32;
 extern Datatype Int64;
 extern Datatype Int128;
 Datatype Float(int bits = sizeof(double)*8);
+extern Datatype Float16;
+extern Datatype BFloat16;
 extern Datatype Float32;
 extern Datatype Float64;
 Datatype Complex(int bits);
@@ -143,6 +188,14 @@ template<> inline Datatype type<int8_t>() {
   return Int8;
 }
 
+template<> inline Datatype type<float16>() {
+  return Float16;
+}
+
+template<> inline Datatype type<bfloat16>() {
+  return BFloat16;
+}
+
 template<> inline Datatype type<float>() {
   return Float32;
 }
@@ -175,6 +228,8 @@ union ComponentTypeUnion {
   int64_t int64Value;
   long long int128Value;
 
+  float16 float16Value;
+  bfloat16 bfloat16Value;
   float float32Value;
   double float64Value;
 
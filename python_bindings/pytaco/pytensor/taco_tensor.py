@@ -2950,7 +2950,7 @@ def evaluate(expr, *operands, out_format=None, dtype=None):
     return tensor.from_tensor_base(tensor_base)
 
 
-def einsum(expr, *operands, out_format=None, dtype=None):
+def einsum(expr, *operands, out_format=None, dtype=None, optimize=False):
     """
     Evaluates the Einstein summation convention on the input operands.
 
@@ -2992,6 +2992,12 @@ def einsum(expr, *operands, out_format=None, dtype=None):
      dtype: datatype, optional
         The datatype of the output tensor.
 
+    optimize: bool, optional
+        If true, a product of three or more operands is computed as a sequence of pairwise contractions into dense
+        temporaries, in the order estimated to be cheapest from the dimensions and numbers of nonzeros of the operands
+        (similar to NumPy's ``einsum_path``). The operands are multiplied in a single loop nest if no order is estimated
+        to be cheaper.
+
 
     See also
     ----------
@@ -3078,7 +3084,7 @@ def einsum(expr, *operands, out_format=None, dtype=None):
         for i in range(1, len(args)):
             out_dtype = _cm.max_type(out_dtype, args[i].dtype)
 
-    ein = _cm._einsum(expr, [t._tensor for t in args], out_format, out_dtype)
+    ein = _cm._einsum(expr, [t._tensor for t in args], out_format, out_dtype, optimize)
     return tensor.from_tensor_base(ein)
 
 
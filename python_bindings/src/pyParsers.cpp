@@ -82,14 +82,15 @@ static TensorBase parseString(std::string& expr, py::list &tensors, py::object&
   return result;
 }
 
-static TensorBase einsumParse(std::string& expr, py::list &tensors, py::object& fmt, Datatype dtype) {
+static TensorBase einsumParse(std::string& expr, py::list &tensors, py::object& fmt, Datatype dtype,
+                              bool optimize) {
   std::vector<TensorBase> cppTensors;
   for(auto &tensor: tensors){
     cppTensors.push_back(tensor.cast<TensorBase>());
   }
 
   Format format = fmt.is_none()? Format() : fmt.cast<Format>();
-  parser::EinsumParser einsumParser(expr, cppTensors, format, dtype);
+  parser::EinsumParser einsumParser(expr, cppTensors, format, dtype, optimize);
   try {
     einsumParser.parse();
   } catch (const parser::ParseError& e){
@@ -0,0 +1,394 @@
+#include "taco/autotuner.h"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <tuple>
+
+#include "taco/tensor.h"
+#include "taco/cuda.h"
+#include "taco/codegen/module.h"
+#include "taco/index_notation/index_notation_nodes.h"
+#include "taco/index_notation/transformations.h"
+#include "taco/lower/lower.h"
+#include "taco/parser/schedule_parser.h"
+#include "taco/util/collections.h"
+#include "taco/util/strings.h"
+#include "taco/util/timers.h"
+
+using namespace std;
+
+namespace taco {
+
+/// Returns the variables of the loops that are perfectly nested at the root
+/// of the statement, outermost first, and sets `body` to the statement that
+/// the innermost loop encloses.
+static vector<IndexVar> getLoopNest(IndexStmt stmt, IndexStmt* body) {
+  vector<IndexVar> loops;
+  while (isa<Forall>(stmt)) {
+    loops.push_back(to<Forall>(stmt).getIndexVar());
+    stmt = to<Forall>(stmt).getStmt();
+  }
+  *body = stmt;
+  return loops;
+}
+
+static bool isDense(const Format& format, int level) {
+  return format.getModeFormats()[level].getName() == Dense.getName();
+}
+
+/// Returns true if loops in the given order iterate over the levels of every
+/// access with sparse levels in storage order.  Accesses to dense tensors
+/// can be iterated in any order.
+static bool respectsFormats(const vector<IndexVar>& order,
+                            const vector<Access>& accesses) {
+  for (const Access& access : accesses) {
+    const Format& format = access.getTensorVar().getFormat();
+    bool allDense = true;
+    for (int level = 0; level < format.getOrder(); level++) {
+      allDense &= isDense(format, level);
+    }
+    if (allDense) {
+      continue;
+    }
+
+    const vector<IndexVar>& vars = access.getIndexVars();
+    ptrdiff_t previous = -1;
+    for (int mode : format.getModeOrdering()) {
+      auto it = find(order.begin(), order.end(), vars[mode]);
+      ptrdiff_t position = it - order.begin();
+      if (it == order.end() || position < previous) {
+        return false;
+      }
+      previous = position;
+    }
+  }
+  return true;
+}
+
+/// Returns true if the variable only indexes dense modes of the accesses.
+static bool indexesDenseModes(IndexVar var, const vector<Access>& accesses) {
+  for (const Access& access : accesses) {
+    const Format& format = access.getTensorVar().getFormat();
+    const vector<IndexVar>& vars = access.getIndexVars();
+    for (int level = 0; level < format.getOrder(); level++) {
+      if (vars[format.getModeOrdering()[level]] == var &&
+          !isDense(format, level)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/// Returns a variable name derived from `name` that is not in `names`, and
+/// adds it to `names`.
+static string getUniqueName(const string& name, set<string>* names) {
+  string unique = name;
+  for (int i = 0; util::contains(*names, unique); i++) {
+    unique = name + "_" + to_string(i);
+  }
+  names->insert(unique);
+  return unique;
+}
+
+/// Returns the names of the variables that a split of `var` introduces.
+static pair<string,string>
+getSplitNames(IndexVar var, set<string>* names,
+              map<string,pair<string,string>>* splitNames) {
+  if (!util::contains(*splitNames, var.getName())) {
+    string outer = getUniqueName(var.getName() + "0", names);
+    string inner = getUniqueName(var.getName() + "1", names);
+    splitNames->insert({var.getName(), {outer, inner}});
+  }
+  return splitNames->at(var.getName());
+}
+
+/// Applies a schedule written in the syntax of the command-line tool's `-s`
+/// option.  The empty schedule applies the default schedule.
+static IndexStmt applySchedule(IndexStmt stmt, const string& schedule) {
+  if (schedule.empty()) {
+    return parallelizeOuterLoop(insertTemporaries(stmt));
+  }
+  return parser::applySchedule(stmt, parser::ScheduleParser(schedule));
+}
+
+vector<string> enumerateSchedules(IndexStmt stmt,
+                                  const AutotuneOptions& options) {
+  vector<string> schedules = {""};
+  auto addSchedule = [&](const vector<string>& directives) {
+    string schedule = util::join(directives, ",");
+    if ((int)schedules.size() < options.maxCandidates &&
+        !util::contains(schedules, schedule)) {
+      schedules.push_back(schedule);
+    }
+  };
+
+  IndexStmt body;
+  vector<IndexVar> loops = getLoopNest(stmt, &body);
+  if (loops.empty() || !isa<Assignment>(body)) {
+    return schedules;
+  }
+  Assignment assignment = to<Assignment>(body);
+  Access result = assignment.getLhs();
+  vector<Access> accesses = {result};
+  match(assignment.getRhs(),
+    function<void(const AccessNode*)>([&](const AccessNode* op) {
+      accesses.push_back(Access(op));
+    })
+  );
+
+  set<string> names;
+  map<string,pair<string,string>> splitNames;
+  for (const IndexVar& var : getIndexVars(stmt)) {
+    names.insert(var.getName());
+  }
+
+  bool sparseResult = false;
+  for (int level = 0; level < result.getTensorVar().getOrder(); level++) {
+    sparseResult |= !isDense(result.getTensorVar().getFormat(), level);
+  }
+  stringstream rhs;
+  rhs << assignment.getRhs();
+  string rhsString = rhs.str();
+  rhsString.erase(remove(rhsString.begin(), rhsString.end(), ' '),
+                  rhsString.end());
+
+  // Enumerate the loop orders, starting with the current one.  Deep loop
+  // nests are not reordered, as they have too many orders to try.
+  vector<vector<IndexVar>> orders;
+  vector<size_t> permutation(loops.size());
+  for (size_t i = 0; i < loops.size(); i++) {
+    permutation[i] = i;
+  }
+  do {
+    vector<IndexVar> order;
+    for (size_t i : permutation) {
+      order.push_back(loops[i]);
+    }
+    if (respectsFormats(order, accesses)) {
+      orders.push_back(order);
+    }
+  } while (loops.size() <= 5 &&
+           next_permutation(permutation.begin(), permutation.end()));
+
+  for (const vector<IndexVar>& order : orders) {
+    vector<string> directives;
+    if (order != loops) {
+      directives.push_back("reorder(" + util::join(order, ",") + ")");
+    }
+
+    // Sparse results cannot be scattered into, so loops over their last mode
+    // that are nested in reduction loops precompute into a dense workspace.
+    auto firstReduction = find_if(order.begin(), order.end(),
+        [&](const IndexVar& var) {
+          return !util::contains(result.getIndexVars(), var);
+        });
+    vector<IndexVar> scattered;
+    for (auto it = firstReduction; it != order.end(); ++it) {
+      if (util::contains(result.getIndexVars(), *it)) {
+        scattered.push_back(*it);
+      }
+    }
+    bool precompute = sparseResult && !scattered.empty();
+    if (precompute) {
+      const Format& format = result.getTensorVar().getFormat();
+      IndexVar last = result.getIndexVars()[format.getModeOrdering().back()];
+      if (scattered.size() > 1 || scattered[0] != order.back() ||
+          scattered[0] != last) {
+        continue;
+      }
+      directives.push_back("precompute(" + rhsString + "," +
+                           last.getName() + "," + last.getName() + ")");
+    }
+    addSchedule(directives);
+
+    if (options.parallelize) {
+      IndexVar outer = order.front();
+      string strategy = util::contains(result.getIndexVars(), outer)
+                        ? "NoRaces" : "Temporary";
+      vector<string> parallel = directives;
+      parallel.push_back("parallelize(" + outer.getName() + ",CPUThread," +
+                         strategy + ")");
+      addSchedule(parallel);
+
+      for (int factor : options.splitFactors) {
+        string outer0, outer1;
+        tie(outer0, outer1) = getSplitNames(outer, &names, &splitNames);
+        vector<string> split = directives;
+        split.push_back("split(" + outer.getName() + "," + outer0 + "," +
+                        outer1 + "," + to_string(factor) + ")");
+        split.push_back("parallelize(" + outer0 + ",CPUThread," +
+                        strategy + ")");
+        addSchedule(split);
+      }
+    }
+
+    // Tile dense inner loops, so that the parts of the tensors they index
+    // stay in cache across the iterations of the outer loops.
+    IndexVar inner = order.back();
+    if (order.size() > 1 && !precompute && indexesDenseModes(inner, accesses)) {
+      for (int factor : options.splitFactors) {
+        string inner0, inner1;
+        tie(inner0, inner1) = getSplitNames(inner, &names, &splitNames);
+        vector<string> tiled = directives;
+        tiled.push_back("split(" + inner.getName() + "," + inner0 + "," +
+                        inner1 + "," + to_string(factor) + ")");
+        vector<string> tiledOrder = {inner0};
+        for (size_t i = 0; i < order.size() - 1; i++) {
+          tiledOrder.push_back(order[i].getName());
+        }
+        tiledOrder.push_back(inner1);
+        tiled.push_back("reorder(" + util::join(tiledOrder, ",") + ")");
+        addSchedule(tiled);
+      }
+    }
+  }
+  return schedules;
+}
+
+/// Returns the key that the best schedule of an assignment is stored under.
+static string getScheduleKey(Assignment assignment) {
+  stringstream key;
+  key << assignment;
+  set<string> tensors;
+  auto addTensor = [&](const TensorVar& tensor) {
+    if (tensors.insert(tensor.getName()).second) {
+      key << " " << tensor.getName() << ":" << tensor.getFormat() << ":"
+          << tensor.getType();
+    }
+  };
+  addTensor(assignment.getLhs().getTensorVar());
+  match(assignment.getRhs(),
+    function<void(const AccessNode*)>([&](const AccessNode* op) {
+      addTensor(op->tensorVar);
+    })
+  );
+  return key.str();
+}
+
+string autotune(TensorBase& result, const AutotuneOptions& options,
+                vector<ScheduleTiming>* timings) {
+  taco_uassert(!should_use_CUDA_codegen())
+      << "Autotuning is only supported for CPU kernels";
+  Assignment assignment = result.getAssignment();
+  taco_uassert(assignment.defined()) << error::compile_without_expr;
+
+  IndexStmt stmt =
+      makeConcreteNotation(makeReductionNotation(assignment));
+  stmt = reorderLoopsTopologically(stmt);
+
+  string key = getScheduleKey(assignment);
+  if (!options.scheduleFile.empty()) {
+    ifstream file(options.scheduleFile);
+    string line;
+    while (getline(file, line)) {
+      size_t separator = line.find('\t');
+      if (separator != string::npos && line.substr(0, separator) == key) {
+        string schedule = line.substr(separator + 1);
+        result.setNeedsCompile(true);
+        result.compile(applySchedule(stmt, schedule));
+        return schedule;
+      }
+    }
+  }
+
+  // Lower the candidates and generate their code.  Candidates that cannot
+  // be applied or lowered are illegal and are skipped.
+  struct Candidate {
+    string schedule;
+    IndexStmt stmt;
+    shared_ptr<ir::Module> module;
+    bool compiled;
+  };
+  vector<Candidate> candidates;
+  for (const string& schedule : enumerateSchedules(stmt, options)) {
+    try {
+      IndexStmt scheduled = applySchedule(stmt, schedule);
+      IndexStmt concrete = scalarPromote(scheduled.concretize());
+      auto module = make_shared<ir::Module>();
+      module->addFunction(lower(concrete, "assemble", true, false));
+      module->addFunction(lower(concrete, "compute", false, true));
+      module->generateSources();
+      candidates.push_back({schedule, scheduled, module, false});
+    }
+    catch (TacoException&) {
+    }
+  }
+
+  // Run the C compiler on several candidates at once.
+  int numThreads = (options.compileThreads > 0)
+                   ? options.compileThreads
+                   : std::max(1, (int)thread::hardware_concurrency());
+  atomic<size_t> next(0);
+  vector<thread> compilers;
+  for (int i = 0; i < numThreads; i++) {
+    compilers.push_back(thread([&]() {
+      for (size_t c = next++; c < candidates.size(); c = next++) {
+        try {
+          candidates[c].module->compileSources();
+          candidates[c].compiled = true;
+        }
+        catch (TacoException&) {
+        }
+      }
+    }));
+  }
+  for (auto& compiler : compilers) {
+    compiler.join();
+  }
+
+  // Time the candidates on the tensors of the expression.  The compiled
+  // candidates are put in the kernel cache, so compiling the result with a
+  // candidate's schedule picks up its module.
+  const Candidate* best = nullptr;
+  double bestTime = 0.0;
+  for (const Candidate& candidate : candidates) {
+    if (!candidate.compiled) {
+      continue;
+    }
+    TensorBase::cacheComputeKernel(scalarPromote(candidate.stmt.concretize()),
+                       candidate.module);
+    result.setNeedsCompile(true);
+    result.compile(candidate.stmt);
+
+    util::Timer timer;
+    for (int i = 0; i < std::max(1, options.repetitions); i++) {
+      result.setNeedsAssemble(true);
+      result.setNeedsCompute(true);
+      result.assemble();
+      timer.start();
+      result.compute();
+      timer.stop();
+    }
+    double time = timer.getResult().median;
+    if (timings) {
+      timings->push_back({candidate.schedule, time});
+    }
+    if (!best || time < bestTime) {
+      best = &candidate;
+      bestTime = time;
+    }
+  }
+  taco_uassert(best) << "None of the candidate schedules of " << assignment
+                     << " compiled";
+
+  result.setNeedsCompile(true);
+  result.compile(best->stmt);
+  result.setNeedsAssemble(true);
+  result.setNeedsCompute(true);
+
+  if (!options.scheduleFile.empty()) {
+    ofstream file(options.scheduleFile, ios::app);
+    file << key << '\t' << best->schedule << '\n';
+  }
+  return best->schedule;
+}
+
+}
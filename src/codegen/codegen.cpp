@@ -70,7 +70,12 @@ bool CodeGen::checkForAlloc(const Function *func) {
 // helper to translate from taco type to C type
 string CodeGen::printCType(Datatype type, bool is_ptr) {
   stringstream ret;
-  ret << type;
+  // Kernels store 16-bit floats in 16 bits but compute on them in float
+  if (type.isReducedPrecision() && !is_ptr) {
+    ret << "float";
+  } else {
+    ret << type;
+  }
 
   if (is_ptr) {
     ret << "*";
@@ -201,10 +206,10 @@ string CodeGen::printTensorProperty(string varname, const GetProperty* op, bool
     varname += "_ptr";
   }
 
-  auto tensor = op->tensor.as<Var>();
-  if (op->property == TensorProperty::Values) {
+  if (op->property == TensorProperty::Values ||
+      op->property == TensorProperty::ValueDictionary) {
     // for the values, it's in the last slot
-    ret << printType(tensor->type, true) << star;
+    ret << printType(op->type, true) << star;
     ret << " " << varname;
     return ret.str();
   } else if (op->property == TensorProperty::ValuesSize) {
@@ -237,15 +242,27 @@ string CodeGen::unpackTensorProperty(string varname, const GetProperty* op,
   auto tensor = op->tensor.as<Var>();
   if (op->property == TensorProperty::Values) {
     // for the values, it's in the last slot
-    ret << printType(tensor->type, true);
-    ret << " " << restrictKeyword() << " " << varname << " = (" << printType(tensor->type, true) << ")(";
-    ret << tensor->name << "->vals);\n";
+    ret << printType(op->type, true);
+    ret << " " << restrictKeyword() << " " << varname << " = (" << printType(op->type, true) << ")(";
+    ret << assumeAligned(tensor->name + "->vals") << ");\n";
+    return ret.str();
+  } else if (op->property == TensorProperty::ValueDictionary) {
+    ret << printType(op->type, true);
+    ret << " " << restrictKeyword() << " " << varname << " = (" << printType(op->type, true) << ")(";
+    ret << tensor->name << "->vals_dict);\n";
     return ret.str();
   } else if (op->property == TensorProperty::ValuesSize) {
     ret << "int " << varname << " = " << tensor->name << "->vals_size;\n";
     return ret.str();
   } else if (op->property == TensorProperty::FillValue) {
     ret << printType(tensor->type, false) << " " << varname << " = ";
+    if (tensor->type.isReducedPrecision()) {
+      ret << (tensor->type == Float16 ? "taco_float16_to_float("
+                                      : "taco_bfloat16_to_float(");
+      ret << "*((" << printType(tensor->type, true) << ")(" << tensor->name
+          << "->fill_value)));\n";
+      return ret.str();
+    }
     ret << "*((" <<printType(tensor->type, true) << ")(" << tensor->name << "->fill_value));\n";
     return ret.str();
   }
@@ -264,8 +281,10 @@ string CodeGen::unpackTensorProperty(string varname, const GetProperty* op,
     tp = "int*";
     auto nm = op->index;
     ret << tp << " " << restrictKeyword() << " " << varname << " = ";
-    ret << "(int*)(" << tensor->name << "->indices[" << op->mode;
-    ret << "][" << nm << "]);\n";
+    ret << "(int*)(" << assumeAligned(tensor->name + "->indices[" +
+                                     std::to_string(op->mode) + "][" +
+                                     std::to_string(nm) + "]");
+    ret << ");\n";
   }
 
   return ret.str();
@@ -285,7 +304,8 @@ string CodeGen::packTensorProperty(string varname, Expr tnsr,
   } else if (property == TensorProperty::ValuesSize) {
     ret << tensor->name << "->vals_size = " << varname << ";\n";
     return ret.str();
-  } else if (property == TensorProperty::FillValue) {
+  } else if (property == TensorProperty::FillValue ||
+             property == TensorProperty::ValueDictionary) {
     return "";
   }
 
@@ -632,7 +652,14 @@ void CodeGen::printYield(const Yield* op, vector<Expr> localVars,
   }
   doIndent();
   stream << valName << "[" << bufSizeName << "] = ";
-  op->val.accept(this);
+  if (op->val.type().isReducedPrecision()) {
+    stream << (op->val.type() == Float16 ? "taco_float_to_float16("
+                                         : "taco_float_to_bfloat16(");
+    op->val.accept(this);
+    stream << ")";
+  } else {
+    op->val.accept(this);
+  }
   stream << ";" << endl;
 
   doIndent();
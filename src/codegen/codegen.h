@@ -61,6 +61,10 @@ protected:
 private:
   virtual std::string restrictKeyword() const { return ""; }
 
+  /// Returns an expression that tells the compiler that the array `array`
+  /// may be assumed to be aligned.
+  virtual std::string assumeAligned(std::string array) const { return array; }
+
   std::string printTensorProperty(std::string varname, const GetProperty* op, bool is_ptr);
   std::string unpackTensorProperty(std::string varname, const GetProperty* op,
                               bool is_output_prop);
@@ -20,7 +20,7 @@ namespace ir {
 namespace {
 
 // Include stdio.h for printf
-// stdlib.h for malloc/realloc
+// stdlib.h for malloc/realloc/posix_memalign
 // math.h for sqrt
 // MIN preprocessor macro
 // This *must* be kept in sync with taco_tensor_t.h
@@ -40,6 +40,68 @@ const string cHeaders =
   "#define TACO_MIN(_a,_b) ((_a) < (_b) ? (_a) : (_b))\n"
   "#define TACO_MAX(_a,_b) ((_a) > (_b) ? (_a) : (_b))\n"
   "#define TACO_DEREF(_a) (((___context___*)(*__ctx__))->_a)\n"
+  // 16-bit floats are stored as their bit patterns and converted to float,
+  // rounding to nearest even, when they are loaded and stored.
+  "typedef uint16_t taco_float16_t;\n"
+  "typedef uint16_t taco_bfloat16_t;\n"
+  "static inline float taco_float16_to_float(taco_float16_t h) {\n"
+  "  uint32_t sign = (uint32_t)(h & 0x8000) << 16;\n"
+  "  uint32_t exponent = (h >> 10) & 0x1f;\n"
+  "  uint32_t mantissa = h & 0x3ff;\n"
+  "  uint32_t bits;\n"
+  "  if (exponent == 0x1f) {\n"
+  "    bits = sign | 0x7f800000 | (mantissa << 13);\n"
+  "  } else if (exponent != 0) {\n"
+  "    bits = sign | ((exponent + 112) << 23) | (mantissa << 13);\n"
+  "  } else if (mantissa == 0) {\n"
+  "    bits = sign;\n"
+  "  } else {\n"
+  "    exponent = 113;\n"
+  "    while (!(mantissa & 0x400)) {\n"
+  "      mantissa <<= 1;\n"
+  "      exponent--;\n"
+  "    }\n"
+  "    bits = sign | (exponent << 23) | ((mantissa & 0x3ff) << 13);\n"
+  "  }\n"
+  "  float f;\n"
+  "  memcpy(&f, &bits, sizeof(f));\n"
+  "  return f;\n"
+  "}\n"
+  "static inline taco_float16_t taco_float_to_float16(float f) {\n"
+  "  uint32_t bits;\n"
+  "  memcpy(&bits, &f, sizeof(bits));\n"
+  "  uint16_t sign = (bits >> 16) & 0x8000;\n"
+  "  uint32_t mantissa = bits & 0x7fffff;\n"
+  "  int exponent = (int)((bits >> 23) & 0xff) - 112;\n"
+  "  if (exponent == 143) return sign | 0x7c00 | (mantissa ? 0x200 : 0);\n"
+  "  if (exponent >= 0x1f) return sign | 0x7c00;\n"
+  "  if (exponent < -10) return sign;\n"
+  "  uint32_t half, remainder, halfway;\n"
+  "  if (exponent <= 0) {\n"
+  "    int shift = 14 - exponent;\n"
+  "    half = (mantissa | 0x800000) >> shift;\n"
+  "    remainder = (mantissa | 0x800000) & ((1u << shift) - 1);\n"
+  "    halfway = 1u << (shift - 1);\n"
+  "  } else {\n"
+  "    half = ((uint32_t)exponent << 10) | (mantissa >> 13);\n"
+  "    remainder = mantissa & 0x1fff;\n"
+  "    halfway = 0x1000;\n"
+  "  }\n"
+  "  if (remainder > halfway || (remainder == halfway && (half & 1))) half++;\n"
+  "  return sign | half;\n"
+  "}\n"
+  "static inline float taco_bfloat16_to_float(taco_bfloat16_t h) {\n"
+  "  uint32_t bits = (uint32_t)h << 16;\n"
+  "  float f;\n"
+  "  memcpy(&f, &bits, sizeof(f));\n"
+  "  return f;\n"
+  "}\n"
+  "static inline taco_bfloat16_t taco_float_to_bfloat16(float f) {\n"
+  "  uint32_t bits;\n"
+  "  memcpy(&bits, &f, sizeof(bits));\n"
+  "  if ((bits & 0x7fffffff) > 0x7f800000) return (bits >> 16) | 0x40;\n"
+  "  return (bits + 0x7fff + ((bits >> 16) & 1)) >> 16;\n"
+  "}\n"
   "#ifndef TACO_TENSOR_T_DEFINED\n"
   "#define TACO_TENSOR_T_DEFINED\n"
   "typedef enum { taco_mode_dense, taco_mode_sparse } taco_mode_t;\n"
@@ -53,12 +115,225 @@ const string cHeaders =
   "  uint8_t*     vals;          // tensor values\n"
   "  uint8_t*     fill_value;    // tensor fill value\n"
   "  int32_t      vals_size;     // values array size\n"
+  "  uint8_t*     vals_dict;     // value dictionary (dictionary-encoded values)\n"
   "} taco_tensor_t;\n"
   "#endif\n"
   "#if !_OPENMP\n"
   "int omp_get_thread_num() { return 0; }\n"
   "int omp_get_max_threads() { return 1; }\n"
   "#endif\n"
+  // Task-parallel loops call the work-stealing runtime through this pointer,
+  // which the module sets after loading the kernel. If it is not set (e.g.
+  // when the code is compiled outside of taco) the loops run serially.
+  "typedef void (*taco_task_t)(void*, int32_t, int32_t);\n"
+  "void (*taco_task_runtime)(int32_t, int32_t, taco_task_t, void*) = 0;\n"
+  "void taco_parallel_for(int32_t begin, int32_t end, taco_task_t task, void* context) {\n"
+  "  if (taco_task_runtime) {\n"
+  "    taco_task_runtime(begin, end, task, context);\n"
+  "  }\n"
+  "  else if (begin < end) {\n"
+  "    task(context, begin, end);\n"
+  "  }\n"
+  "}\n"
+  // Dense matrix products call the CBLAS routines of a BLAS library through
+  // these pointers, which the module sets after loading the kernel if a BLAS
+  // is configured.  Otherwise the helpers return 0 and kernels run their own
+  // loops.
+  "void (*taco_cblas_dgemm)(int, int, int, int, int, int, double, const double*, int, const double*, int, double, double*, int) = 0;\n"
+  "void (*taco_cblas_sgemm)(int, int, int, int, int, int, float, const float*, int, const float*, int, float, float*, int) = 0;\n"
+  "void (*taco_cblas_dgemv)(int, int, int, int, double, const double*, int, const double*, int, double, double*, int) = 0;\n"
+  "void (*taco_cblas_sgemv)(int, int, int, int, float, const float*, int, const float*, int, float, float*, int) = 0;\n"
+  "#define TACO_CBLAS_ROW_MAJOR 101\n"
+  "#define TACO_CBLAS_TRANS(_t) ((_t) ? 112 : 111)\n"
+  "int taco_dgemm(int transa, int transb, int m, int n, int k, const double* a, int lda, const double* b, int ldb, double beta, double* c, int ldc) {\n"
+  "  if (!taco_cblas_dgemm) return 0;\n"
+  "  taco_cblas_dgemm(TACO_CBLAS_ROW_MAJOR, TACO_CBLAS_TRANS(transa), TACO_CBLAS_TRANS(transb), m, n, k, 1.0, a, lda, b, ldb, beta, c, ldc);\n"
+  "  return 1;\n"
+  "}\n"
+  "int taco_sgemm(int transa, int transb, int m, int n, int k, const float* a, int lda, const float* b, int ldb, float beta, float* c, int ldc) {\n"
+  "  if (!taco_cblas_sgemm) return 0;\n"
+  "  taco_cblas_sgemm(TACO_CBLAS_ROW_MAJOR, TACO_CBLAS_TRANS(transa), TACO_CBLAS_TRANS(transb), m, n, k, 1.0f, a, lda, b, ldb, beta, c, ldc);\n"
+  "  return 1;\n"
+  "}\n"
+  "int taco_dgemv(int trans, int m, int n, const double* a, int lda, const double* x, double beta, double* y) {\n"
+  "  if (!taco_cblas_dgemv) return 0;\n"
+  "  taco_cblas_dgemv(TACO_CBLAS_ROW_MAJOR, TACO_CBLAS_TRANS(trans), m, n, 1.0, a, lda, x, 1, beta, y, 1);\n"
+  "  return 1;\n"
+  "}\n"
+  "int taco_sgemv(int trans, int m, int n, const float* a, int lda, const float* x, float beta, float* y) {\n"
+  "  if (!taco_cblas_sgemv) return 0;\n"
+  "  taco_cblas_sgemv(TACO_CBLAS_ROW_MAJOR, TACO_CBLAS_TRANS(trans), m, n, 1.0f, a, lda, x, 1, beta, y, 1);\n"
+  "  return 1;\n"
+  "}\n"
+  // Arrays are allocated aligned to TACO_ALIGNMENT bytes, and arrays that span
+  // several huge pages are aligned to huge pages and backed by transparent
+  // huge pages where the system supports it.  The memory can be released with
+  // free.  Kernels may assume that operand arrays are aligned too if compiled
+  // with TACO_ASSUME_ALIGNED_OPERANDS.
+  "#ifndef TACO_ALIGNMENT\n"
+  "#define TACO_ALIGNMENT 64\n"
+  "#endif\n"
+  "#ifndef TACO_HUGE_PAGE_SIZE\n"
+  "#define TACO_HUGE_PAGE_SIZE 2097152\n"
+  "#endif\n"
+  "#ifdef TACO_ASSUME_ALIGNED_OPERANDS\n"
+  "#define TACO_ASSUME_ALIGNED(_p) __builtin_assume_aligned((_p), TACO_ALIGNMENT)\n"
+  "#else\n"
+  "#define TACO_ASSUME_ALIGNED(_p) (_p)\n"
+  "#endif\n"
+  "#if defined(__GNUC__)\n"
+  "#define TACO_ALIGNED_ALLOC __attribute__((malloc, assume_aligned(TACO_ALIGNMENT)))\n"
+  "#else\n"
+  "#define TACO_ALIGNED_ALLOC\n"
+  "#endif\n"
+  "int posix_memalign(void** memptr, size_t alignment, size_t size);\n"
+  "#if defined(__linux__) && (defined(__x86_64__) || defined(__aarch64__))\n"
+  "int madvise(void* addr, size_t length, int advice);\n"
+  "#define TACO_MADV_HUGEPAGE 14\n"
+  "#endif\n"
+  "size_t taco_alignment(size_t size) {\n"
+  "  return (size >= 2 * TACO_HUGE_PAGE_SIZE) ? TACO_HUGE_PAGE_SIZE : TACO_ALIGNMENT;\n"
+  "}\n"
+  "void taco_advise(void* ptr, size_t size) {\n"
+  "#ifdef TACO_MADV_HUGEPAGE\n"
+  "  if (taco_alignment(size) == TACO_HUGE_PAGE_SIZE) {\n"
+  "    madvise(ptr, size / TACO_HUGE_PAGE_SIZE * TACO_HUGE_PAGE_SIZE, TACO_MADV_HUGEPAGE);\n"
+  "  }\n"
+  "#endif\n"
+  "}\n"
+  "TACO_ALIGNED_ALLOC void* taco_malloc(size_t size) {\n"
+  "  void* ptr = NULL;\n"
+  "  if (posix_memalign(&ptr, taco_alignment(size), size > 0 ? size : 1) != 0) {\n"
+  "    return NULL;\n"
+  "  }\n"
+  "  taco_advise(ptr, size);\n"
+  "  return ptr;\n"
+  "}\n"
+  "TACO_ALIGNED_ALLOC void* taco_calloc(size_t size) {\n"
+  "  char* ptr = (char*)taco_malloc(size);\n"
+  "  if (ptr != NULL) {\n"
+  "    // Clear the pages in parallel, so they are first touched by the threads\n"
+  "    // that compute on them\n"
+  "    int64_t numPages = (size + 4095) / 4096;\n"
+  "    #pragma omp parallel for schedule(runtime) if (numPages > 64)\n"
+  "    for (int64_t page = 0; page < numPages; page++) {\n"
+  "      memset(ptr + page * 4096, 0, TACO_MIN(4096, size - page * 4096));\n"
+  "    }\n"
+  "  }\n"
+  "  return ptr;\n"
+  "}\n"
+  "TACO_ALIGNED_ALLOC void* taco_realloc(void* ptr, size_t size) {\n"
+  "  void* result = realloc(ptr, size);\n"
+  "  if (result != NULL && (uintptr_t)result % taco_alignment(size) != 0) {\n"
+  "    void* aligned = taco_malloc(size);\n"
+  "    if (aligned != NULL) {\n"
+  "      memcpy(aligned, result, size);\n"
+  "    }\n"
+  "    free(result);\n"
+  "    return aligned;\n"
+  "  }\n"
+  "  taco_advise(result, size);\n"
+  "  return result;\n"
+  "}\n"
+  // Temporaries that a kernel allocates and frees itself, such as workspaces,
+  // are bump allocated from a per-thread arena that is reset when a kernel
+  // starts.  Blocks are popped as soon as they and every block above them are
+  // freed.  Blocks that do not fit fall back to the heap, and the arena grows
+  // to fit them the next time it is empty.  An arena lives as long as its
+  // thread.
+  "#ifndef TACO_ARENA_LIMIT\n"
+  "#define TACO_ARENA_LIMIT 67108864\n"
+  "#endif\n"
+  "#define TACO_ARENA_MIN_CAPACITY 65536\n"
+  "#define TACO_ARENA_NONE ((size_t)-1)\n"
+  "#if defined(__GNUC__)\n"
+  "#define TACO_THREAD_LOCAL __thread\n"
+  "#else\n"
+  "#define TACO_THREAD_LOCAL\n"
+  "#endif\n"
+  "typedef struct {\n"
+  "  char*  data;\n"
+  "  size_t capacity;\n"
+  "  size_t top;\n"
+  "  size_t last;\n"
+  "  size_t overflow;\n"
+  "} taco_arena_t;\n"
+  "typedef struct {\n"
+  "  size_t previous;\n"
+  "  size_t freed;\n"
+  "} taco_arena_block_t;\n"
+  "TACO_THREAD_LOCAL taco_arena_t taco_arena = {NULL, 0, 0, TACO_ARENA_NONE, 0};\n"
+  "void taco_arena_reset() {\n"
+  "  taco_arena.top = 0;\n"
+  "  taco_arena.last = TACO_ARENA_NONE;\n"
+  "}\n"
+  "void taco_arena_grow(taco_arena_t* arena) {\n"
+  "  size_t capacity = TACO_MAX(2 * arena->capacity, arena->capacity + arena->overflow);\n"
+  "  capacity = TACO_MIN(TACO_MAX(capacity, TACO_ARENA_MIN_CAPACITY), TACO_ARENA_LIMIT);\n"
+  "  arena->overflow = 0;\n"
+  "  if (capacity > arena->capacity) {\n"
+  "    char* data = (char*)taco_malloc(capacity);\n"
+  "    if (data != NULL) {\n"
+  "      free(arena->data);\n"
+  "      arena->data = data;\n"
+  "      arena->capacity = capacity;\n"
+  "    }\n"
+  "  }\n"
+  "}\n"
+  "TACO_ALIGNED_ALLOC void* taco_arena_malloc(size_t size) {\n"
+  "  taco_arena_t* arena = &taco_arena;\n"
+  "  size_t bytes = TACO_ALIGNMENT + (size + TACO_ALIGNMENT - 1) / TACO_ALIGNMENT * TACO_ALIGNMENT;\n"
+  "  if (arena->top == 0 && arena->overflow > 0) {\n"
+  "    taco_arena_grow(arena);\n"
+  "  }\n"
+  "  if (bytes > arena->capacity - arena->top) {\n"
+  "    arena->overflow += bytes;\n"
+  "    return taco_malloc(size);\n"
+  "  }\n"
+  "  taco_arena_block_t* block = (taco_arena_block_t*)(arena->data + arena->top);\n"
+  "  block->previous = arena->last;\n"
+  "  block->freed = 0;\n"
+  "  arena->last = arena->top;\n"
+  "  arena->top += bytes;\n"
+  "  return (char*)block + TACO_ALIGNMENT;\n"
+  "}\n"
+  "TACO_ALIGNED_ALLOC void* taco_arena_calloc(size_t size) {\n"
+  "  void* ptr = taco_arena_malloc(size);\n"
+  "  if (ptr != NULL) {\n"
+  "    memset(ptr, 0, size);\n"
+  "  }\n"
+  "  return ptr;\n"
+  "}\n"
+  "void taco_arena_free(void* ptr) {\n"
+  "  taco_arena_t* arena = &taco_arena;\n"
+  "  char* block = (char*)ptr - TACO_ALIGNMENT;\n"
+  "  if ((char*)ptr < arena->data || (char*)ptr >= arena->data + arena->capacity) {\n"
+  "    free(ptr);\n"
+  "    return;\n"
+  "  }\n"
+  "  ((taco_arena_block_t*)block)->freed = 1;\n"
+  "  while (arena->last != TACO_ARENA_NONE &&\n"
+  "         ((taco_arena_block_t*)(arena->data + arena->last))->freed) {\n"
+  "    arena->top = arena->last;\n"
+  "    arena->last = ((taco_arena_block_t*)(arena->data + arena->last))->previous;\n"
+  "  }\n"
+  "}\n"
+  // Vectorized loops that are outlined into functions with AVX2 instructions
+  // only call them if the processor supports AVX2.
+  "#if defined(__GNUC__) && defined(__x86_64__) && !defined(TACO_NO_SIMD)\n"
+  "#define TACO_SIMD_AVX2 1\n"
+  "#include <immintrin.h>\n"
+  "int taco_avx2_supported = -1;\n"
+  "int taco_has_avx2() {\n"
+  "  if (taco_avx2_supported < 0) {\n"
+  "    __builtin_cpu_init();\n"
+  "    taco_avx2_supported = __builtin_cpu_supports(\"avx2\") != 0;\n"
+  "  }\n"
+  "  return taco_avx2_supported;\n"
+  "}\n"
+  "#else\n"
+  "#define TACO_SIMD_AVX2 0\n"
+  "#endif\n"
   "int cmp(const void *a, const void *b) {\n"
   "  return *((const int*)a) - *((const int*)b);\n"
   "}\n"
@@ -84,6 +359,45 @@ const string cHeaders =
   "  }\n"
   "  return curr+1;\n"
   "}\n"
+  // Increment arrayStart until array[arrayStart] >= target or arrayStart >= arrayEnd
+  // by comparing blocks of eight coordinates to the target at once.  Since the
+  // array is sorted, the coordinates in a block that are less than the target
+  // form a prefix of the block.
+  "#if TACO_SIMD_AVX2\n"
+  "__attribute__((target(\"avx2\")))\n"
+  "int taco_simd_advance_avx2(int *array, int arrayStart, int arrayEnd, int target) {\n"
+  "  __m256i targets = _mm256_set1_epi32(target);\n"
+  "  while (arrayStart + 8 <= arrayEnd) {\n"
+  "    __m256i block = _mm256_loadu_si256((__m256i*)(array + arrayStart));\n"
+  "    int less = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(targets, block)));\n"
+  "    if (less != 0xff) {\n"
+  "      return arrayStart + __builtin_ctz(~less);\n"
+  "    }\n"
+  "    arrayStart += 8;\n"
+  "  }\n"
+  "  while (arrayStart < arrayEnd && array[arrayStart] < target) {\n"
+  "    arrayStart++;\n"
+  "  }\n"
+  "  return arrayStart;\n"
+  "}\n"
+  "#endif\n"
+  "int taco_simd_advance(int *array, int arrayStart, int arrayEnd, int target) {\n"
+  "  if (arrayStart >= arrayEnd || array[arrayStart] >= target) {\n"
+  "    return arrayStart;\n"
+  "  }\n"
+  "#if TACO_SIMD_AVX2\n"
+  "  if (taco_has_avx2()) {\n"
+  "    return taco_simd_advance_avx2(array, arrayStart + 1, arrayEnd, target);\n"
+  "  }\n"
+  "#endif\n"
+  "  while (arrayStart + 8 <= arrayEnd && array[arrayStart + 7] < target) {\n"
+  "    arrayStart += 8;\n"
+  "  }\n"
+  "  while (arrayStart < arrayEnd && array[arrayStart] < target) {\n"
+  "    arrayStart++;\n"
+  "  }\n"
+  "  return arrayStart;\n"
+  "}\n"
   "int taco_binarySearchAfter(int *array, int arrayStart, int arrayEnd, int target) {\n"
   "  if (array[arrayStart] >= target) {\n"
   "    return arrayStart;\n"
@@ -126,6 +440,31 @@ const string cHeaders =
   "  }\n"
   "  return lowerBound;\n"
   "}\n"
+  // Returns the first index in [arrayStart, arrayEnd) whose value is at least
+  // target, or arrayEnd if there is none. Unlike the searches above this is
+  // exact in the presence of repeated values (e.g. empty rows in a pos array).
+  "int taco_binarySearchFirst(int *array, int arrayStart, int arrayEnd, int target) {\n"
+  "  while (arrayStart < arrayEnd) {\n"
+  "    int mid = arrayStart + (arrayEnd - arrayStart) / 2;\n"
+  "    if (array[mid] < target) {\n"
+  "      arrayStart = mid + 1;\n"
+  "    }\n"
+  "    else {\n"
+  "      arrayEnd = mid;\n"
+  "    }\n"
+  "  }\n"
+  "  return arrayStart;\n"
+  "}\n"
+  // Decode the coordinate at position p of a delta compressed level, which is
+  // stored as an offset from the base coordinate of its block.
+  "int taco_unpack_crd(int *crd_hdr, int *crd, int p) {\n"
+  "  const uint32_t* words = (const uint32_t*)crd;\n"
+  "  uint32_t width = (uint32_t)crd_hdr[0];\n"
+  "  uint64_t bit = (uint64_t)p * width;\n"
+  "  uint64_t chunk = words[bit >> 5] | ((uint64_t)words[(bit >> 5) + 1] << 32);\n"
+  "  uint32_t offset = (uint32_t)((chunk >> (bit & 31)) & ((1ull << width) - 1));\n"
+  "  return crd_hdr[1 + (p >> 5)] + (int)offset;\n"
+  "}\n"
   "taco_tensor_t* init_taco_tensor_t(int32_t order, int32_t csize,\n"
   "                                  int32_t* dimensions, int32_t* mode_ordering,\n"
   "                                  taco_mode_t* mode_types) {\n"
@@ -136,6 +475,7 @@ const string cHeaders =
   "  t->mode_types    = (taco_mode_t *) malloc(order * sizeof(taco_mode_t));\n"
   "  t->indices       = (uint8_t ***) malloc(order * sizeof(uint8_t***));\n"
   "  t->csize         = csize;\n"
+  "  t->vals_dict     = NULL;\n"
   "  for (int32_t i = 0; i < order; i++) {\n"
   "    t->dimensions[i]    = dimensions[i];\n"
   "    t->mode_ordering[i] = mode_ordering[i];\n"
@@ -145,7 +485,7 @@ const string cHeaders =
   "        t->indices[i] = (uint8_t **) malloc(1 * sizeof(uint8_t **));\n"
   "        break;\n"
   "      case taco_mode_sparse:\n"
-  "        t->indices[i] = (uint8_t **) malloc(2 * sizeof(uint8_t **));\n"
+  "        t->indices[i] = (uint8_t **) malloc(3 * sizeof(uint8_t **));\n"
   "        break;\n"
   "    }\n"
   "  }\n"
@@ -262,6 +602,610 @@ protected:
   }
 };
 
+namespace {
+
+// Collects the temporaries that a function allocates and frees itself and
+// never reallocates, which can be allocated from the per-thread arena.
+class FindArenaTemporaries : public IRVisitor {
+public:
+  set<const Var*> temporaries;
+
+  FindArenaTemporaries(Stmt body) {
+    body.accept(this);
+    for (const Var* var : allocated) {
+      if (util::contains(freed, var) && !util::contains(reallocated, var)) {
+        temporaries.insert(var);
+      }
+    }
+  }
+
+protected:
+  using IRVisitor::visit;
+
+  set<const Var*> allocated;
+  set<const Var*> reallocated;
+  set<const Var*> freed;
+
+  virtual void visit(const Allocate *op) {
+    IRVisitor::visit(op);
+    if (const Var* var = op->var.as<Var>()) {
+      (op->is_realloc ? reallocated : allocated).insert(var);
+    }
+  }
+
+  virtual void visit(const Free *op) {
+    IRVisitor::visit(op);
+    if (const Var* var = op->var.as<Var>()) {
+      freed.insert(var);
+    }
+  }
+};
+
+// Collects the task-parallel loops of a function, inner loops first so that
+// the functions they are outlined into precede the functions that call them.
+class FindTaskLoops : public IRVisitor {
+public:
+  vector<const For*> loops;
+
+protected:
+  using IRVisitor::visit;
+
+  virtual void visit(const For *op) {
+    IRVisitor::visit(op);
+    if (op->kind == LoopKind::Tasks) {
+      loops.push_back(op);
+    }
+  }
+};
+
+// Finds the variables and tensor properties that the body of a loop uses but
+// does not declare, which an outlined loop must capture from its caller, and
+// whether the body assigns to any of them.  Declarations are matched by their
+// generated names, since distinct IR vars may be emitted with the same name.
+class FindCaptures : public IRVisitor {
+public:
+  vector<Expr> captures;
+  bool assignsCapture = false;
+
+  FindCaptures(const For* loop, const map<Expr, string, ExprCompare>& varMap)
+      : varMap(varMap) {
+    declare(loop->var);
+    loop->contents.accept(this);
+  }
+
+protected:
+  using IRVisitor::visit;
+
+  const map<Expr, string, ExprCompare>& varMap;
+  set<string> declared;
+  set<string> captured;
+
+  string getName(Expr expr) {
+    taco_iassert(varMap.count(expr) > 0) << expr;
+    return varMap.at(expr);
+  }
+
+  void declare(Expr var) {
+    declared.insert(getName(var));
+  }
+
+  bool isDeclared(Expr expr) {
+    return declared.count(getName(expr)) > 0;
+  }
+
+  void capture(Expr expr) {
+    string name = getName(expr);
+    if (!declared.count(name) && !captured.count(name)) {
+      captured.insert(name);
+      captures.push_back(expr);
+    }
+  }
+
+  virtual void visit(const Var *op) {
+    capture(op);
+  }
+
+  virtual void visit(const GetProperty *op) {
+    capture(op);
+  }
+
+  virtual void visit(const VarDecl *op) {
+    op->rhs.accept(this);
+    declare(op->var);
+  }
+
+  virtual void visit(const For *op) {
+    declare(op->var);
+    op->start.accept(this);
+    op->end.accept(this);
+    op->increment.accept(this);
+    op->contents.accept(this);
+  }
+
+  virtual void visit(const Assign *op) {
+    assignsCapture |= !isDeclared(op->lhs);
+    IRVisitor::visit(op);
+  }
+
+  virtual void visit(const Allocate *op) {
+    assignsCapture |= !isDeclared(op->var);
+    IRVisitor::visit(op);
+  }
+
+  virtual void visit(const Free *op) {
+    assignsCapture |= !isDeclared(op->var);
+    IRVisitor::visit(op);
+  }
+};
+
+// Collects the vectorized loops of a function.
+class FindVectorizedLoops : public IRVisitor {
+public:
+  vector<const For*> loops;
+
+protected:
+  using IRVisitor::visit;
+
+  virtual void visit(const For *op) {
+    IRVisitor::visit(op);
+    if (op->kind == LoopKind::Vectorized) {
+      loops.push_back(op);
+    }
+  }
+};
+
+// Finds the variables that an expression uses and the arrays it loads from.
+class FindUses : public IRVisitor {
+public:
+  set<string> vars;
+  set<string> arrays;
+
+  FindUses(Expr expr, function<string(Expr)> getName) : getName(getName) {
+    expr.accept(this);
+  }
+
+protected:
+  using IRVisitor::visit;
+
+  function<string(Expr)> getName;
+
+  virtual void visit(const Var* op) {
+    vars.insert(getName(op));
+  }
+
+  virtual void visit(const Load* op) {
+    arrays.insert(getName(op->arr));
+    IRVisitor::visit(op);
+  }
+};
+
+// The AVX2 types and intrinsics that a vectorized loop over doubles (four
+// lanes) or floats (eight lanes) is translated to.  Coordinates are 32-bit
+// integers and take up a 128-bit vector in loops over doubles.
+struct SimdIsa {
+  int lanes;
+  string vec;       // vector of values
+  string ivec;      // vector of coordinates
+  string suffix;    // suffix of floating-point intrinsics
+  string iprefix;   // prefix of integer intrinsics
+  int size;         // size of a value in bytes
+
+  SimdIsa(Datatype type) {
+    if (type == Float64) {
+      lanes = 4; vec = "__m256d"; ivec = "__m128i"; suffix = "pd";
+      iprefix = "_mm"; size = 8;
+    }
+    else {
+      lanes = 8; vec = "__m256"; ivec = "__m256i"; suffix = "ps";
+      iprefix = "_mm256"; size = 4;
+    }
+  }
+
+  string fop(const string& op) const { return "_mm256_" + op + "_" + suffix; }
+  string iop(const string& op) const { return iprefix + "_" + op; }
+  string izero() const {
+    return iprefix + (iprefix == "_mm" ? "_setzero_si128()" : "_setzero_si256()");
+  }
+  string fmask() const { return "_mm256_castsi256_" + suffix + "(taco_mask)"; }
+};
+
+// A value in a vectorized loop body: the same in every lane (a scalar
+// expression), the loop variable plus a scalar expression (the scalar is the
+// value of the first lane), or a vector.
+struct SimdValue {
+  enum Kind {Uniform, Linear, Varying} kind;
+  bool isFloat;
+  string code;
+};
+
+// Translates the body of a vectorized loop to AVX2 intrinsics.  Bodies are
+// supported if they only declare variables, store to the locations the loop
+// variable indexes contiguously, and reduce into scalars or loop-invariant
+// locations.  Values are loaded contiguously, or gathered if their locations
+// are loaded (e.g. from crd arrays), and the lanes past the end of the loop
+// are masked off.  Translation fails on anything else.
+class SimdLoopTranslator {
+public:
+  stringstream body;
+  vector<string> accumulators;
+  vector<string> results;     // the locations that accumulators are added to
+  set<string> reductionVars;  // captured scalars that are reduced into
+
+  SimdLoopTranslator(const For* loop, Datatype type,
+                     function<string(Expr)> print,
+                     function<string(Expr)> getName)
+      : isa(type), type(type), print(print), getName(getName),
+        loopVar(getName(loop->var)) {}
+
+  bool translate(Stmt stmt) {
+    vector<Stmt> stmts;
+    flatten(stmt, &stmts);
+    for (auto& s : stmts) {
+      if (auto store = s.as<Store>()) {
+        storedArrays.insert(getName(store->arr));
+      }
+      else if (auto assign = s.as<Assign>()) {
+        reductionVars.insert(getName(assign->lhs));
+      }
+    }
+    for (auto& s : stmts) {
+      if (!translateStmt(s)) {
+        return false;
+      }
+    }
+    // Stored arrays may only be read at the locations they are stored to
+    for (auto& load : loads) {
+      if (util::contains(storeBases, load.first) &&
+          (load.second.kind != SimdValue::Linear ||
+           load.second.code != storeBases.at(load.first))) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+private:
+  SimdIsa isa;
+  Datatype type;
+  function<string(Expr)> print;
+  function<string(Expr)> getName;
+  string loopVar;
+  map<string,SimdValue> locals;
+  set<string> storedArrays;
+  map<string,string> storeBases;
+  vector<pair<string,SimdValue>> loads;
+  int numTemporaries = 0;
+
+  void flatten(Stmt stmt, vector<Stmt>* stmts) {
+    if (auto block = stmt.as<Block>()) {
+      for (auto& s : block->contents) {
+        flatten(s, stmts);
+      }
+    }
+    else if (auto scope = stmt.as<Scope>()) {
+      flatten(scope->scopedStmt, stmts);
+    }
+    else if (stmt.defined()) {
+      stmts->push_back(stmt);
+    }
+  }
+
+  string temporary(const string& vecType, const string& code) {
+    string name = "taco_v" + to_string(numTemporaries++);
+    body << "    " << vecType << " " << name << " = " << code << ";\n";
+    return name;
+  }
+
+  bool isValueType(Datatype t) { return t == type; }
+  bool isCoordType(Datatype t) { return t == Int32; }
+
+  // Returns true if the expression is the same in every lane
+  bool isUniform(Expr expr) {
+    FindUses uses(expr, getName);
+    for (auto& name : uses.vars) {
+      if (name == loopVar || util::contains(reductionVars, name) ||
+          (util::contains(locals, name) &&
+           locals.at(name).kind != SimdValue::Uniform)) {
+        return false;
+      }
+    }
+    for (auto& arr : uses.arrays) {
+      if (util::contains(storedArrays, arr)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Returns true if the expression uses variables declared in the loop body
+  bool usesLocals(Expr expr) {
+    for (auto& name : FindUses(expr, getName).vars) {
+      if (util::contains(locals, name)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  string toVector(const SimdValue& value) {
+    if (value.kind == SimdValue::Varying) {
+      return value.code;
+    }
+    if (value.isFloat) {
+      return temporary(isa.vec, isa.fop("set1") + "(" + value.code + ")");
+    }
+    string code = isa.iop("set1_epi32") + "(" + value.code + ")";
+    if (value.kind == SimdValue::Linear) {
+      code = isa.iop("add_epi32") + "(" + code + ", taco_iota)";
+    }
+    return temporary(isa.ivec, code);
+  }
+
+  bool translateExpr(Expr expr, SimdValue* value) {
+    if (!isValueType(expr.type()) && !isCoordType(expr.type()) &&
+        !isUniform(expr)) {
+      return false;
+    }
+    if (isUniform(expr)) {
+      *value = {SimdValue::Uniform, expr.type().isFloat(),
+                "(" + print(expr) + ")"};
+      return true;
+    }
+
+    if (auto var = expr.as<Var>()) {
+      string name = getName(var);
+      if (name == loopVar) {
+        *value = {SimdValue::Linear, false, name};
+        return true;
+      }
+      if (!util::contains(locals, name)) {
+        return false;
+      }
+      *value = locals.at(name);
+      return true;
+    }
+    if (auto load = expr.as<Load>()) {
+      return translateLoad(load, value);
+    }
+    if (auto cast = expr.as<Cast>()) {
+      SimdValue a;
+      if (!isValueType(cast->type) || !translateExpr(cast->a, &a) ||
+          a.isFloat) {
+        return false;
+      }
+      *value = {SimdValue::Varying, true,
+                temporary(isa.vec, "_mm256_cvtepi32_" + isa.suffix + "(" +
+                                   toVector(a) + ")")};
+      return true;
+    }
+    if (auto neg = expr.as<Neg>()) {
+      return translateBinary(ir::Sub::make(ir::Literal::zero(neg->type),
+                                           neg->a), value);
+    }
+    return translateBinary(expr, value);
+  }
+
+  bool translateBinary(Expr expr, SimdValue* value) {
+    Expr a, b;
+    string op;
+    if (auto add = expr.as<ir::Add>()) {
+      a = add->a; b = add->b; op = "add";
+    }
+    else if (auto sub = expr.as<ir::Sub>()) {
+      a = sub->a; b = sub->b; op = "sub";
+    }
+    else if (auto mul = expr.as<ir::Mul>()) {
+      a = mul->a; b = mul->b; op = "mul";
+    }
+    else if (auto div = expr.as<ir::Div>()) {
+      a = div->a; b = div->b; op = "div";
+    }
+    else {
+      return false;
+    }
+
+    SimdValue va, vb;
+    if (!translateExpr(a, &va) || !translateExpr(b, &vb) ||
+        va.isFloat != vb.isFloat) {
+      return false;
+    }
+    if (va.isFloat) {
+      *value = {SimdValue::Varying, true,
+                temporary(isa.vec, isa.fop(op) + "(" + toVector(va) + ", " +
+                                   toVector(vb) + ")")};
+      return true;
+    }
+
+    // The loop variable plus or minus a scalar stays linear
+    if (op == "add" && va.kind == SimdValue::Linear &&
+        vb.kind == SimdValue::Uniform) {
+      *value = {SimdValue::Linear, false, "(" + va.code + " + " + vb.code + ")"};
+      return true;
+    }
+    if (op == "add" && va.kind == SimdValue::Uniform &&
+        vb.kind == SimdValue::Linear) {
+      *value = {SimdValue::Linear, false, "(" + va.code + " + " + vb.code + ")"};
+      return true;
+    }
+    if (op == "sub" && va.kind == SimdValue::Linear &&
+        vb.kind == SimdValue::Uniform) {
+      *value = {SimdValue::Linear, false, "(" + va.code + " - " + vb.code + ")"};
+      return true;
+    }
+    if (op == "div") {
+      return false;
+    }
+    string intrinsic = (op == "mul") ? "mullo_epi32" : op + "_epi32";
+    *value = {SimdValue::Varying, false,
+              temporary(isa.ivec, isa.iop(intrinsic) + "(" + toVector(va) +
+                                  ", " + toVector(vb) + ")")};
+    return true;
+  }
+
+  bool translateLoad(const Load* load, SimdValue* value) {
+    SimdValue loc;
+    if (!isUniform(load->arr) || !translateExpr(load->loc, &loc) ||
+        loc.isFloat) {
+      return false;
+    }
+    string arr = getName(load->arr);
+    loads.push_back({arr, loc});
+    if (isValueType(load->type)) {
+      string code;
+      if (loc.kind == SimdValue::Linear) {
+        code = isa.fop("maskload") + "(" + arr + " + " + loc.code +
+               ", taco_mask)";
+      }
+      else {
+        code = "_mm256_mask_i32gather_" + isa.suffix + "(" +
+               isa.fop("setzero") + "(), " + arr + ", " + toVector(loc) +
+               ", " + isa.fmask() + ", " + to_string(isa.size) + ")";
+      }
+      *value = {SimdValue::Varying, true, temporary(isa.vec, code)};
+      return true;
+    }
+    if (isCoordType(load->type)) {
+      string code;
+      if (loc.kind == SimdValue::Linear) {
+        code = isa.iop("maskload_epi32") + "(" + arr + " + " + loc.code +
+               ", taco_mask32)";
+      }
+      else {
+        code = isa.iop("mask_i32gather_epi32") + "(" + isa.izero() + ", " +
+               arr + ", " + toVector(loc) + ", taco_mask32, 4)";
+      }
+      *value = {SimdValue::Varying, false, temporary(isa.ivec, code)};
+      return true;
+    }
+    return false;
+  }
+
+  void accumulate(const string& result, const SimdValue& value) {
+    string accumulator = "taco_acc" + to_string(accumulators.size());
+    accumulators.push_back(accumulator);
+    results.push_back(result);
+    body << "    " << accumulator << " = " << isa.fop("add") << "("
+         << accumulator << ", " << isa.fop("and") << "(" << toVector(value)
+         << ", " << isa.fmask() << "));\n";
+  }
+
+  // Matches `lhs + x` or `x + lhs`, returning x
+  Expr getAddend(Expr expr, function<bool(Expr)> isLhs) {
+    if (auto add = expr.as<ir::Add>()) {
+      if (isLhs(add->a)) {
+        return add->b;
+      }
+      if (isLhs(add->b)) {
+        return add->a;
+      }
+    }
+    return Expr();
+  }
+
+  bool translateStmt(Stmt stmt) {
+    if (auto decl = stmt.as<VarDecl>()) {
+      SimdValue rhs;
+      if (!translateExpr(decl->rhs, &rhs)) {
+        return false;
+      }
+      string name = getName(decl->var);
+      if (rhs.kind == SimdValue::Varying) {
+        locals[name] = rhs;
+      }
+      else {
+        body << "    " << util::toString(decl->var.type()) << " " << name
+             << " = " << rhs.code << ";\n";
+        locals[name] = {rhs.kind, rhs.isFloat, name};
+      }
+      return true;
+    }
+
+    if (auto assign = stmt.as<Assign>()) {
+      string name = getName(assign->lhs);
+      if (util::contains(locals, name) || assign->use_atomics ||
+          !isValueType(assign->lhs.type())) {
+        return false;
+      }
+      Expr addend = getAddend(assign->rhs, [&](Expr e) {
+        return e.as<Var>() && getName(e) == name;
+      });
+      SimdValue value;
+      if (!addend.defined() || !translateExpr(addend, &value) ||
+          !value.isFloat) {
+        return false;
+      }
+      accumulate("*" + name, value);
+      return true;
+    }
+
+    if (auto store = stmt.as<Store>()) {
+      SimdValue loc;
+      string arr = getName(store->arr);
+      if (store->use_atomics || !isValueType(store->data.type()) ||
+          util::contains(storeBases, arr) ||
+          !translateExpr(store->loc, &loc)) {
+        return false;
+      }
+      if (loc.kind == SimdValue::Uniform) {
+        // A reduction into a location that is the same in every lane
+        string location = print(store->loc);
+        Expr addend = getAddend(store->data, [&](Expr e) {
+          auto load = e.as<Load>();
+          return load && getName(load->arr) == arr &&
+                 print(load->loc) == location;
+        });
+        SimdValue value;
+        if (usesLocals(store->loc) || !addend.defined() ||
+            !translateExpr(addend, &value) || !value.isFloat) {
+          return false;
+        }
+        storeBases[arr] = "";
+        accumulate(arr + "[" + location + "]", value);
+        return true;
+      }
+
+      SimdValue data;
+      if (loc.kind != SimdValue::Linear || !translateExpr(store->data, &data) ||
+          !data.isFloat) {
+        return false;
+      }
+      storeBases[arr] = loc.code;
+      body << "    " << isa.fop("maskstore") << "(" << arr << " + " << loc.code
+           << ", taco_mask, " << toVector(data) << ");\n";
+      return true;
+    }
+    return false;
+  }
+};
+
+// Finds the types of the values that a loop body loads, stores and assigns.
+class FindValueTypes : public IRVisitor {
+public:
+  set<Datatype::Kind> types;
+
+protected:
+  using IRVisitor::visit;
+
+  virtual void visit(const Load* op) {
+    if (op->type.isFloat()) {
+      types.insert(op->type.getKind());
+    }
+    IRVisitor::visit(op);
+  }
+
+  virtual void visit(const Store* op) {
+    types.insert(op->data.type().getKind());
+    IRVisitor::visit(op);
+  }
+
+  virtual void visit(const Assign* op) {
+    types.insert(op->lhs.type().getKind());
+    IRVisitor::visit(op);
+  }
+};
+
+} // anonymous namespace
+
 CodeGen_C::CodeGen_C(std::ostream &dest, OutputKind outputKind, bool simplify)
     : CodeGen(dest, false, simplify, C), out(dest), outputKind(outputKind) {}
 
@@ -298,6 +1242,36 @@ void CodeGen_C::visit(const Function* func) {
   FindVars outputVarFinder({}, func->outputs, this);
   func->body.accept(&outputVarFinder);
 
+  // find all the vars that are not inputs or outputs and declare them
+  resetUniqueNameCounters();
+  FindVars varFinder(func->inputs, func->outputs, this);
+  func->body.accept(&varFinder);
+  varMap = varFinder.varMap;
+  localVars = varFinder.localVars;
+
+  // output the functions that vectorized and task-parallel loops are
+  // outlined into
+  Stmt body = getPrintedStmt(func->body);
+  arenaVars.clear();
+  if (outputKind == ImplementationGen && !emittingCoroutine) {
+    arenaVars = FindArenaTemporaries(body).temporaries;
+  }
+  simdFunctions.clear();
+  taskFunctions.clear();
+  if (outputKind == ImplementationGen && !emittingCoroutine) {
+    FindVectorizedLoops vectorizedLoopFinder;
+    body.accept(&vectorizedLoopFinder);
+    for (const For* loop : vectorizedLoopFinder.loops) {
+      outlineSimdLoop(loop);
+    }
+
+    FindTaskLoops taskLoopFinder;
+    body.accept(&taskLoopFinder);
+    for (const For* loop : taskLoopFinder.loops) {
+      outlineTaskLoop(loop);
+    }
+  }
+
   // output function declaration
   doIndent();
   out << printFuncName(func, inputVarFinder.varDecls, outputVarFinder.varDecls);
@@ -313,13 +1287,6 @@ void CodeGen_C::visit(const Function* func) {
 
   indent++;
 
-  // find all the vars that are not inputs or outputs and declare them
-  resetUniqueNameCounters();
-  FindVars varFinder(func->inputs, func->outputs, this);
-  func->body.accept(&varFinder);
-  varMap = varFinder.varMap;
-  localVars = varFinder.localVars;
-
   // Print variable declarations
   out << printDecls(varFinder.varDecls, func->inputs, func->outputs) << endl;
 
@@ -328,8 +1295,13 @@ void CodeGen_C::visit(const Function* func) {
         << endl;
   }
 
+  if (!arenaVars.empty()) {
+    doIndent();
+    out << "taco_arena_reset();\n";
+  }
+
   // output body
-  print(func->body);
+  body.accept(this);
 
   // output repack only if we allocated memory
   if (checkForAlloc(func))
@@ -347,6 +1319,188 @@ void CodeGen_C::visit(const Function* func) {
   out << "}\n";
 }
 
+string CodeGen_C::printCaptureType(Expr capture) {
+  if (auto var = capture.as<Var>()) {
+    if (var->is_tensor) {
+      return "taco_tensor_t*";
+    }
+    return util::toString(var->type) + (var->is_ptr ? "*" : "");
+  }
+
+  auto property = capture.as<GetProperty>();
+  taco_iassert(property);
+  switch (property->property) {
+    case TensorProperty::Values:
+    case TensorProperty::ValueDictionary:
+      return printType(property->type, true);
+    case TensorProperty::FillValue:
+      return printType(property->tensor.type(), false);
+    case TensorProperty::Indices:
+      return "int*";
+    default:
+      return "int";
+  }
+}
+
+// Outline a task-parallel loop into a function that runs the loop over one
+// subrange, and a struct that holds the values the loop body captures from
+// the enclosing function.  Loops that assign to captured variables are left
+// to run serially, since the assignments would not be seen by the caller.
+void CodeGen_C::outlineTaskLoop(const For* loop) {
+  FindCaptures captureFinder(loop, varMap);
+  auto increment = loop->increment.as<Literal>();
+  if (captureFinder.assignsCapture || increment == nullptr ||
+      !(increment->type.isInt() || increment->type.isUInt()) ||
+      !increment->equalsScalar(1)) {
+    return;
+  }
+
+  TaskFunction task;
+  task.name = funcName + "_task" + to_string(taskFunctions.size());
+  for (auto& capture : captureFinder.captures) {
+    task.captures.push_back({printCaptureType(capture), varMap[capture]});
+  }
+
+  out << "typedef struct {\n";
+  for (auto& capture : task.captures) {
+    out << "  " << capture.first << " " << capture.second << ";\n";
+  }
+  if (task.captures.empty()) {
+    out << "  int32_t unused;\n";
+  }
+  out << "} " << task.name << "_context_t;\n\n";
+
+  out << "static void " << task.name << "(void* taco_task_context, "
+      << "int32_t taco_task_begin, int32_t taco_task_end) {\n";
+  out << "  " << task.name << "_context_t* taco_task_captures = ("
+      << task.name << "_context_t*)taco_task_context;\n";
+  for (auto& capture : task.captures) {
+    bool isPtr = capture.first.back() == '*' &&
+                 capture.first != "taco_tensor_t*";
+    out << "  " << capture.first << (isPtr ? " " + restrictKeyword() : "")
+        << " " << capture.second << " = taco_task_captures->"
+        << capture.second << ";\n";
+  }
+
+  Expr begin = Var::make("taco_task_begin", Int32);
+  Expr end = Var::make("taco_task_end", Int32);
+  varMap[begin] = "taco_task_begin";
+  varMap[end] = "taco_task_end";
+  int savedIndent = indent;
+  indent = 1;
+  For::make(loop->var, begin, end, loop->increment, loop->contents,
+            LoopKind::Serial, ParallelUnit::NotParallel,
+            loop->unrollFactor).accept(this);
+  indent = savedIndent;
+  out << "}\n\n";
+
+  taskFunctions.insert({loop, task});
+}
+
+string CodeGen_C::printToString(Expr expr) {
+  stringstream str;
+  streambuf* buffer = out.rdbuf(str.rdbuf());
+  parentPrecedence = TOP;
+  expr.accept(this);
+  out.rdbuf(buffer);
+  return str.str();
+}
+
+// Outline a vectorized loop into a function that runs it with AVX2
+// instructions, which is called instead of the loop when the processor
+// supports AVX2.  Loops over doubles or floats whose bodies the
+// SimdLoopTranslator cannot translate are left to the C compiler.
+void CodeGen_C::outlineSimdLoop(const For* loop) {
+  auto increment = loop->increment.as<Literal>();
+  if (loop->var.type() != Int32 || increment == nullptr ||
+      !increment->type.isInt() || !increment->equalsScalar(1)) {
+    return;
+  }
+  FindValueTypes valueTypes;
+  loop->contents.accept(&valueTypes);
+  if (valueTypes.types.size() != 1) {
+    return;
+  }
+  Datatype type(*valueTypes.types.begin());
+  if (type != Float64 && type != Float32) {
+    return;
+  }
+
+  SimdLoopTranslator translator(loop, type,
+      [this](Expr expr) { return printToString(expr); },
+      [this](Expr expr) {
+        taco_iassert(varMap.count(expr) > 0) << expr;
+        return varMap.at(expr);
+      });
+  if (!translator.translate(loop->contents)) {
+    return;
+  }
+
+  SimdFunction simd;
+  simd.name = funcName + "_simd" + to_string(simdFunctions.size());
+  vector<string> parameters = {"int32_t taco_simd_begin",
+                               "int32_t taco_simd_end"};
+  for (auto& capture : FindCaptures(loop, varMap).captures) {
+    string captureType = printCaptureType(capture);
+    string name = varMap[capture];
+    if (util::contains(translator.reductionVars, name)) {
+      parameters.push_back(captureType + "* " + name);
+      simd.arguments.push_back("&" + name);
+    }
+    else {
+      bool isPtr = captureType.back() == '*' && captureType != "taco_tensor_t*";
+      parameters.push_back(captureType + (isPtr ? " " + restrictKeyword() : "") +
+                           " " + name);
+      simd.arguments.push_back(name);
+    }
+  }
+
+  SimdIsa isa(type);
+  string var = varMap[loop->var];
+  string valueType = printType(type, false);
+  out << "#if TACO_SIMD_AVX2\n";
+  out << "__attribute__((target(\"avx2\")))\n";
+  out << "static void " << simd.name << "(" << util::join(parameters, ", ")
+      << ") {\n";
+  for (auto& accumulator : translator.accumulators) {
+    out << "  " << isa.vec << " " << accumulator << " = " << isa.fop("setzero")
+        << "();\n";
+  }
+  vector<int> lanes;
+  for (int lane = 0; lane < isa.lanes; lane++) {
+    lanes.push_back(lane);
+  }
+  out << "  " << isa.ivec << " taco_iota = " << isa.iop("setr_epi32") << "("
+      << util::join(lanes, ", ") << ");\n";
+  out << "  for (int32_t " << var << " = taco_simd_begin; " << var
+      << " < taco_simd_end; " << var << " += " << isa.lanes << ") {\n";
+  out << "    " << isa.ivec << " taco_mask32 = " << isa.iop("cmpgt_epi32")
+      << "(" << isa.iop("set1_epi32") << "(taco_simd_end), "
+      << isa.iop("add_epi32") << "(" << isa.iop("set1_epi32") << "(" << var
+      << "), taco_iota));\n";
+  out << "    __m256i taco_mask = "
+      << (type == Float64 ? "_mm256_cvtepi32_epi64(taco_mask32)" : "taco_mask32")
+      << ";\n";
+  out << translator.body.str();
+  out << "  }\n";
+  for (size_t i = 0; i < translator.accumulators.size(); i++) {
+    out << "  {\n";
+    out << "    " << valueType << " taco_sum[" << isa.lanes << "];\n";
+    out << "    " << isa.fop("storeu") << "(taco_sum, "
+        << translator.accumulators[i] << ");\n";
+    out << "    for (int taco_lane = 1; taco_lane < " << isa.lanes
+        << "; taco_lane++) {\n";
+    out << "      taco_sum[0] += taco_sum[taco_lane];\n";
+    out << "    }\n";
+    out << "    " << translator.results[i] << " += taco_sum[0];\n";
+    out << "  }\n";
+  }
+  out << "}\n";
+  out << "#endif\n\n";
+
+  simdFunctions.insert({loop, simd});
+}
+
 void CodeGen_C::visit(const VarDecl* op) {
   if (emittingCoroutine) {
     doIndent();
@@ -356,6 +1510,16 @@ void CodeGen_C::visit(const VarDecl* op) {
     op->rhs.accept(this);
     stream << ";";
     stream << endl;
+  } else if (op->var.type().isReducedPrecision() && 
+             !to<Var>(op->var)->is_ptr) {
+    doIndent();
+    stream << keywordString(printCType(op->var.type(), false)) << " ";
+    op->var.accept(this);
+    parentPrecedence = Precedence::TOP;
+    stream << " = ";
+    op->rhs.accept(this);
+    stream << ";";
+    stream << endl;
   } else {
     IRPrinter::visit(op);
   }
@@ -426,6 +1590,59 @@ static string getAtomicPragma() {
 // Docs for vectorization pragmas:
 // http://clang.llvm.org/docs/LanguageExtensions.html#extensions-for-loop-hint-optimizations
 void CodeGen_C::visit(const For* op) {
+  if (op->kind == LoopKind::Tasks && util::contains(taskFunctions, op)) {
+    const TaskFunction& task = taskFunctions.at(op);
+    string context = task.name + "_context";
+    doIndent();
+    out << task.name << "_context_t " << context << ";\n";
+    for (auto& capture : task.captures) {
+      doIndent();
+      out << context << "." << capture.second << " = " << capture.second
+          << ";\n";
+    }
+    doIndent();
+    stream << "taco_parallel_for(";
+    parentPrecedence = TOP;
+    op->start.accept(this);
+    stream << ", ";
+    parentPrecedence = TOP;
+    op->end.accept(this);
+    stream << ", " << task.name << ", &" << context << ");\n";
+    return;
+  }
+
+  // Run vectorized loops that were outlined into AVX2 functions through them
+  // if the processor supports AVX2, and through the scalar loop otherwise
+  bool simd = (op->kind == LoopKind::Vectorized &&
+               util::contains(simdFunctions, op));
+  if (simd) {
+    const SimdFunction& function = simdFunctions.at(op);
+    out << "#if TACO_SIMD_AVX2\n";
+    doIndent();
+    out << "if (taco_has_avx2()) {\n";
+    indent++;
+    doIndent();
+    stream << function.name << "(";
+    parentPrecedence = TOP;
+    op->start.accept(this);
+    stream << ", ";
+    parentPrecedence = TOP;
+    op->end.accept(this);
+    for (auto& argument : function.arguments) {
+      stream << ", " << argument;
+    }
+    stream << ");\n";
+    indent--;
+    doIndent();
+    out << "}\n";
+    doIndent();
+    out << "else\n";
+    out << "#endif\n";
+    doIndent();
+    out << "{\n";
+    indent++;
+  }
+
   switch (op->kind) {
     case LoopKind::Vectorized:
       doIndent();
@@ -479,6 +1696,12 @@ void CodeGen_C::visit(const For* op) {
   doIndent();
   stream << "}";
   stream << endl;
+
+  if (simd) {
+    indent--;
+    doIndent();
+    stream << "}" << endl;
+  }
 }
 
 void CodeGen_C::visit(const While* op) {
@@ -534,7 +1757,9 @@ void CodeGen_C::visit(const Max* op) {
 }
 
 void CodeGen_C::visit(const Allocate* op) {
-  string elementType = printCType(op->var.type(), false);
+  string elementType = op->var.type().isReducedPrecision()
+                     ? util::toString(op->var.type())
+                     : printCType(op->var.type(), false);
 
   doIndent();
   op->var.accept(this);
@@ -542,18 +1767,16 @@ void CodeGen_C::visit(const Allocate* op) {
   stream << elementType << "*";
   stream << ")";
   if (op->is_realloc) {
-    stream << "realloc(";
+    stream << "taco_realloc(";
     op->var.accept(this);
     stream << ", ";
   }
   else {
-    // If the allocation was requested to clear the allocated memory,
-    // use calloc instead of malloc.
-    if (op->clear) {
-      stream << "calloc(1, ";
-    } else {
-      stream << "malloc(";
-    }
+    // Temporaries are allocated from the arena.  If the allocation was
+    // requested to clear the allocated memory, use calloc instead of malloc.
+    const Var* var = op->var.as<Var>();
+    string allocator = util::contains(arenaVars, var) ? "taco_arena_" : "taco_";
+    stream << allocator << (op->clear ? "calloc(" : "malloc(");
   }
   stream << "sizeof(" << elementType << ")";
   stream << " * ";
@@ -564,6 +1787,19 @@ void CodeGen_C::visit(const Allocate* op) {
     stream << endl;
 }
 
+void CodeGen_C::visit(const Free* op) {
+  if (!util::contains(arenaVars, op->var.as<Var>())) {
+    IRPrinter::visit(op);
+    return;
+  }
+  doIndent();
+  stream << "taco_arena_free(";
+  parentPrecedence = Precedence::TOP;
+  op->var.accept(this);
+  stream << ");";
+  stream << endl;
+}
+
 void CodeGen_C::visit(const Sqrt* op) {
   taco_tassert(op->type.isFloat() && op->type.getNumBits() == 64) <<
       "Codegen doesn't currently support non-double sqrt";
@@ -580,12 +1816,48 @@ void CodeGen_C::visit(const Assign* op) {
   IRPrinter::visit(op);
 }
 
+void CodeGen_C::visit(const Load* op) {
+  if (!op->type.isReducedPrecision()) {
+    IRPrinter::visit(op);
+    return;
+  }
+  stream << (op->type == Float16 ? "taco_float16_to_float("
+                                 : "taco_bfloat16_to_float(");
+  IRPrinter::visit(op);
+  stream << ")";
+}
+
 void CodeGen_C::visit(const Store* op) {
   if (op->use_atomics) {
     doIndent();
     stream << getAtomicPragma() << endl;
   }
-  IRPrinter::visit(op);
+  if (!op->arr.type().isReducedPrecision()) {
+    IRPrinter::visit(op);
+    return;
+  }
+  doIndent();
+  op->arr.accept(this);
+  stream << "[";
+  parentPrecedence = Precedence::TOP;
+  op->loc.accept(this);
+  stream << "] = ";
+  stream << (op->arr.type() == Float16 ? "taco_float_to_float16("
+                                       : "taco_float_to_bfloat16(");
+  parentPrecedence = Precedence::TOP;
+  op->data.accept(this);
+  stream << ");";
+  stream << endl;
+}
+
+void CodeGen_C::visit(const Cast* op) {
+  if (!op->type.isReducedPrecision()) {
+    IRPrinter::visit(op);
+    return;
+  }
+  stream << "(" << keywordString(printCType(op->type, false)) << ")";
+  parentPrecedence = Precedence::CAST;
+  op->a.accept(this);
 }
 
 void CodeGen_C::generateShim(const Stmt& func, stringstream &ret) {
@@ -1,6 +1,7 @@
 #ifndef TACO_BACKEND_C_H
 #define TACO_BACKEND_C_H
 #include <map>
+#include <set>
 #include <vector>
 
 #include "taco/ir/ir.h"
@@ -38,8 +39,11 @@ protected:
   void visit(const Min*);
   void visit(const Max*);
   void visit(const Allocate*);
+  void visit(const Free*);
   void visit(const Sqrt*);
+  void visit(const Load*);
   void visit(const Store*);
+  void visit(const Cast*);
   void visit(const Assign*);
 
   std::map<Expr, std::string, ExprCompare> varMap;
@@ -52,10 +56,39 @@ protected:
   int labelCount;
   bool emittingCoroutine;
 
+  /// The temporaries of the current function that are allocated from the
+  /// per-thread arena rather than the heap.
+  std::set<const Var*> arenaVars;
+
   class FindVars;
 
+  /// A function that a task-parallel loop is outlined into, along with the
+  /// (type, name) of the values it captures from the enclosing function.
+  struct TaskFunction {
+    std::string name;
+    std::vector<std::pair<std::string, std::string>> captures;
+  };
+  std::map<const For*, TaskFunction> taskFunctions;
+
+  void outlineTaskLoop(const For* loop);
+  std::string printCaptureType(Expr capture);
+
+  /// A function that a vectorized loop is outlined into, which runs the loop
+  /// with AVX2 instructions, along with the arguments it is called with.
+  struct SimdFunction {
+    std::string name;
+    std::vector<std::string> arguments;
+  };
+  std::map<const For*, SimdFunction> simdFunctions;
+
+  void outlineSimdLoop(const For* loop);
+  std::string printToString(Expr expr);
+
 private:
   virtual std::string restrictKeyword() const { return "restrict"; }
+  virtual std::string assumeAligned(std::string array) const {
+    return "TACO_ASSUME_ALIGNED(" + array + ")";
+  }
 };
 
 } // namespace ir
@@ -15,6 +15,7 @@
 #include "codegen/codegen_c.h"
 #include "codegen/codegen_cuda.h"
 #include "taco/cuda.h"
+#include "taco/codegen/task_runtime.h"
 
 using namespace std;
 
@@ -109,6 +110,19 @@ void writeShims(vector<Stmt> funcs, string path, string prefix) {
 } // anonymous namespace
 
 string Module::compile() {
+  generateSources();
+  return compileSources();
+}
+
+void Module::generateSources() {
+  // open the output file & write out the source
+  compileToSource(tmpdir, libname);
+
+  // write out the shims
+  writeShims(funcs, tmpdir, libname);
+}
+
+string Module::compileSources() {
   string prefix = tmpdir+libname;
   string fullpath = prefix + ".so";
   
@@ -145,12 +159,6 @@ string Module::compile() {
     prefix + file_ending + " " + shims_file + " " + 
     "-o " + fullpath + " -lm";
 
-  // open the output file & write out the source
-  compileToSource(tmpdir, libname);
-  
-  // write out the shims
-  writeShims(funcs, tmpdir, libname);
-  
   // now compile it
   int err = system(cmd.data());
   taco_uassert(err == 0) << "Compilation command failed:\n" << cmd
@@ -163,6 +171,23 @@ string Module::compile() {
   lib_handle = dlopen(fullpath.data(), RTLD_NOW | RTLD_LOCAL);
   taco_uassert(lib_handle) << "Failed to load generated code, error is: " << dlerror();
 
+  // point task-parallel loops in the generated code at the task runtime
+  void* taskRuntime = dlsym(lib_handle, "taco_task_runtime");
+  if (taskRuntime) {
+    typedef void (*runtime_t)(int32_t, int32_t, TaskRuntime::Task, void*);
+    *static_cast<runtime_t*>(taskRuntime) = runTaskLoop;
+  }
+
+  // point dense products in the generated code at the configured BLAS
+  void* blas = taco_get_blas();
+  for (const string routine : {"dgemm", "sgemm", "dgemv", "sgemv"}) {
+    void* pointer = dlsym(lib_handle, ("taco_cblas_" + routine).c_str());
+    if (pointer) {
+      *static_cast<void**>(pointer) =
+          blas ? dlsym(blas, ("cblas_" + routine).c_str()) : nullptr;
+    }
+  }
+
   return fullpath;
 }
 
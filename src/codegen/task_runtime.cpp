@@ -0,0 +1,243 @@
+#include "taco/codegen/task_runtime.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "taco/tensor.h"
+#include "taco/error.h"
+
+using namespace std;
+
+namespace taco {
+
+namespace {
+
+struct Loop {
+  TaskRuntime::Task task;
+  void* context;
+  int32_t grainSize;
+
+  // Number of iterations that have not yet run.  The thread that started the
+  // loop waits for this to reach zero.
+  atomic<int64_t> remaining;
+};
+
+struct Range {
+  Loop* loop;
+  int32_t begin;
+  int32_t end;
+};
+
+// The ranges waiting to run on one thread.  The owner pushes and pops at the
+// back while thieves take from the front, where the largest ranges are.
+struct Queue {
+  mutex lock;
+  deque<Range> ranges;
+};
+
+// Index of the queue owned by the current thread, or -1 for threads that are
+// not workers of the runtime.  These share the last queue.
+thread_local int queueIndex = -1;
+
+}
+
+struct TaskRuntime::Content {
+  vector<unique_ptr<Queue>> queues;
+  vector<thread> workers;
+
+  atomic<int> queued{0};
+  bool stop = false;
+  mutex sleepLock;
+  condition_variable wakeup;
+
+  // Guards changes to the number of threads, which only happen while no
+  // loops started by threads outside the runtime are running.
+  mutex configLock;
+  int activeLoops = 0;
+  int numThreads = 1;
+
+  Queue& ownQueue() {
+    return *queues[queueIndex >= 0 ? queueIndex : queues.size() - 1];
+  }
+
+  void push(const Range& range) {
+    Queue& queue = ownQueue();
+    {
+      lock_guard<mutex> guard(queue.lock);
+      queue.ranges.push_back(range);
+    }
+    queued++;
+    {
+      // Taking the lock orders the push before a worker's check for work.
+      lock_guard<mutex> guard(sleepLock);
+    }
+    wakeup.notify_one();
+  }
+
+  bool take(Range* range) {
+    size_t self = queueIndex >= 0 ? queueIndex : queues.size() - 1;
+    {
+      Queue& queue = *queues[self];
+      lock_guard<mutex> guard(queue.lock);
+      if (!queue.ranges.empty()) {
+        *range = queue.ranges.back();
+        queue.ranges.pop_back();
+        queued--;
+        return true;
+      }
+    }
+    for (size_t i = 1; i < queues.size(); i++) {
+      Queue& victim = *queues[(self + i) % queues.size()];
+      lock_guard<mutex> guard(victim.lock);
+      if (!victim.ranges.empty()) {
+        *range = victim.ranges.front();
+        victim.ranges.pop_front();
+        queued--;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void run(Range range) {
+    Loop* loop = range.loop;
+    while (range.end - range.begin > loop->grainSize) {
+      int32_t mid = range.begin + (range.end - range.begin) / 2;
+      push({loop, mid, range.end});
+      range.end = mid;
+    }
+    loop->task(loop->context, range.begin, range.end);
+    loop->remaining.fetch_sub(range.end - range.begin, memory_order_acq_rel);
+  }
+
+  void work(int index) {
+    queueIndex = index;
+    while (true) {
+      Range range;
+      if (take(&range)) {
+        run(range);
+        continue;
+      }
+      unique_lock<mutex> guard(sleepLock);
+      wakeup.wait(guard, [this]() { return stop || queued.load() > 0; });
+      if (stop) {
+        return;
+      }
+    }
+  }
+
+  void stopWorkers() {
+    {
+      lock_guard<mutex> guard(sleepLock);
+      stop = true;
+    }
+    wakeup.notify_all();
+    for (auto& worker : workers) {
+      worker.join();
+    }
+    workers.clear();
+    stop = false;
+  }
+
+  void startWorkers(int threads) {
+    queues.clear();
+    for (int i = 0; i < threads; i++) {
+      queues.push_back(unique_ptr<Queue>(new Queue()));
+    }
+    for (int i = 0; i < threads - 1; i++) {
+      workers.push_back(thread(&Content::work, this, i));
+    }
+    numThreads = threads;
+  }
+};
+
+TaskRuntime::TaskRuntime() : content(new Content) {
+  content->startWorkers(1);
+}
+
+TaskRuntime::~TaskRuntime() {
+  content->stopWorkers();
+}
+
+TaskRuntime& TaskRuntime::getInstance() {
+  static TaskRuntime runtime;
+  return runtime;
+}
+
+int TaskRuntime::getNumThreads() const {
+  return content->numThreads;
+}
+
+void TaskRuntime::parallelFor(int32_t begin, int32_t end, Task task,
+                              void* context, int32_t grainSize) {
+  if (end <= begin) {
+    return;
+  }
+
+  const bool isWorker = (queueIndex >= 0);
+  int threads;
+  if (isWorker) {
+    threads = content->numThreads;
+  }
+  else {
+    lock_guard<mutex> guard(content->configLock);
+    int requested = std::max(1, taco_get_num_threads());
+    if (content->activeLoops == 0 && requested != content->numThreads) {
+      content->stopWorkers();
+      content->startWorkers(requested);
+    }
+    threads = content->numThreads;
+    content->activeLoops++;
+  }
+
+  if (threads == 1) {
+    task(context, begin, end);
+  }
+  else {
+    Loop loop;
+    loop.task = task;
+    loop.context = context;
+    loop.grainSize = (grainSize > 0) ? grainSize
+                   : std::max<int32_t>(1, (end - begin) / (8 * threads));
+    loop.remaining = (int64_t)end - begin;
+
+    content->run({&loop, begin, end});
+    while (loop.remaining.load(memory_order_acquire) > 0) {
+      Range range;
+      if (content->take(&range)) {
+        content->run(range);
+      }
+      else {
+        this_thread::yield();
+      }
+    }
+  }
+
+  if (!isWorker) {
+    lock_guard<mutex> guard(content->configLock);
+    content->activeLoops--;
+  }
+}
+
+static void runFunction(void* context, int32_t begin, int32_t end) {
+  (*static_cast<const function<void(int32_t,int32_t)>*>(context))(begin, end);
+}
+
+void TaskRuntime::parallelFor(int32_t begin, int32_t end,
+                              const function<void(int32_t,int32_t)>& body,
+                              int32_t grainSize) {
+  parallelFor(begin, end, runFunction,
+              const_cast<function<void(int32_t,int32_t)>*>(&body), grainSize);
+}
+
+void runTaskLoop(int32_t begin, int32_t end, TaskRuntime::Task task,
+                 void* context) {
+  TaskRuntime::getInstance().parallelFor(begin, end, task, context);
+}
+
+}
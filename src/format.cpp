@@ -9,6 +9,8 @@
 #include "taco/lower/mode_format_dense.h"
 #include "taco/lower/mode_format_compressed.h"
 #include "taco/lower/mode_format_singleton.h"
+#include "taco/lower/mode_format_delta_compressed.h"
+#include "taco/lower/mode_format_tiled.h"
 
 #include "taco/error.h"
 #include "taco/util/strings.h"
@@ -89,7 +91,8 @@ Datatype Format::getCoordinateTypeIdx(size_t level) const {
   if (level >= levelArrayTypes.size()) {
     return Int32;
   }
-  if (getModeFormats()[level].getName() == Dense.getName()) {
+  if (getModeFormats()[level].getName() == Dense.getName() ||
+      isTiled(getModeFormats()[level])) {
     return levelArrayTypes[level][0];
   }
   return levelArrayTypes[level][1];
@@ -99,6 +102,14 @@ void Format::setLevelArrayTypes(std::vector<std::vector<Datatype>> levelArrayTyp
   this->levelArrayTypes = levelArrayTypes;
 }
 
+ValueEncoding Format::getValueEncoding() const {
+  return this->valueEncoding;
+}
+
+void Format::setValueEncoding(ValueEncoding valueEncoding) {
+  this->valueEncoding = valueEncoding;
+}
+
 
 bool operator==(const Format& a, const Format& b){
   const auto aModeTypePacks = a.getModeFormatPacks();
@@ -107,7 +118,8 @@ bool operator==(const Format& a, const Format& b){
   const auto bModeOrdering = b.getModeOrdering();
   
   if (aModeTypePacks.size() != bModeTypePacks.size() || 
-      aModeOrdering.size() != bModeOrdering.size()) {
+      aModeOrdering.size() != bModeOrdering.size() ||
+      a.getValueEncoding() != b.getValueEncoding()) {
     return false;
   }
   for (size_t i = 0; i < aModeOrdering.size(); ++i) {
@@ -128,8 +140,52 @@ bool operator!=(const Format& a, const Format& b) {
 }
 
 std::ostream &operator<<(std::ostream& os, const Format& format) {
-  return os << "(" << util::join(format.getModeFormatPacks(), ",") << "; "
-            << util::join(format.getModeOrdering(), ",") << ")";
+  os << "(" << util::join(format.getModeFormatPacks(), ",") << "; "
+     << util::join(format.getModeOrdering(), ",");
+  if (format.getValueEncoding() != ValueEncoding::Plain) {
+    os << "; " << format.getValueEncoding();
+  }
+  return os << ")";
+}
+
+Datatype getValueCodeType(ValueEncoding valueEncoding, Datatype componentType) {
+  switch (valueEncoding) {
+    case ValueEncoding::Plain:
+      return componentType;
+    case ValueEncoding::Pattern:
+      return Datatype();
+    case ValueEncoding::Dictionary8:
+      return UInt8;
+    case ValueEncoding::Dictionary16:
+      return UInt16;
+  }
+  taco_ierror;
+  return Datatype();
+}
+
+size_t getValueDictionaryCapacity(ValueEncoding valueEncoding) {
+  switch (valueEncoding) {
+    case ValueEncoding::Dictionary8:
+      return (size_t)UINT8_MAX + 1;
+    case ValueEncoding::Dictionary16:
+      return (size_t)UINT16_MAX + 1;
+    default:
+      return 0;
+  }
+}
+
+std::ostream& operator<<(std::ostream& os, const ValueEncoding& valueEncoding) {
+  switch (valueEncoding) {
+    case ValueEncoding::Plain:
+      return os << "plain";
+    case ValueEncoding::Pattern:
+      return os << "pattern";
+    case ValueEncoding::Dictionary8:
+      return os << "dictionary8";
+    case ValueEncoding::Dictionary16:
+      return os << "dictionary16";
+  }
+  return os;
 }
 
 
@@ -384,21 +440,26 @@ ModeFormat ModeFormat::Dense(std::make_shared<DenseModeFormat>());
 ModeFormat ModeFormat::Compressed(std::make_shared<CompressedModeFormat>());
 ModeFormat ModeFormat::Sparse = ModeFormat::Compressed;
 ModeFormat ModeFormat::Singleton(std::make_shared<SingletonModeFormat>());
+ModeFormat ModeFormat::DeltaCompressed(
+    std::make_shared<DeltaCompressedModeFormat>());
 
 ModeFormat ModeFormat::dense = ModeFormat::Dense;
 ModeFormat ModeFormat::compressed = ModeFormat::Compressed;
 ModeFormat ModeFormat::sparse = ModeFormat::Compressed;
 ModeFormat ModeFormat::singleton = ModeFormat::Singleton;
+ModeFormat ModeFormat::deltaCompressed = ModeFormat::DeltaCompressed;
 
 const ModeFormat Dense = ModeFormat::Dense;
 const ModeFormat Compressed = ModeFormat::Compressed;
 const ModeFormat Sparse = ModeFormat::Compressed;
 const ModeFormat Singleton = ModeFormat::Singleton;
+const ModeFormat DeltaCompressed = ModeFormat::DeltaCompressed;
 
 const ModeFormat dense = ModeFormat::Dense;
 const ModeFormat compressed = ModeFormat::Compressed;
 const ModeFormat sparse = ModeFormat::Compressed;
 const ModeFormat singleton = ModeFormat::Singleton;
+const ModeFormat deltaCompressed = ModeFormat::DeltaCompressed;
 
 const Format CSR({Dense, Sparse}, {0,1});
 const Format CSC({Dense, Sparse}, {1,0});
@@ -430,6 +491,44 @@ const Format COO(int order, bool isUnique, bool isOrdered, bool isAoS,
          : Format(modeTypes, modeOrdering);
 }
 
+Format Tiled(const std::vector<int>& tileSizes,
+             const std::vector<int>& modeOrdering) {
+  const int order = (int)tileSizes.size();
+  taco_uassert(order > 0);
+  taco_uassert(modeOrdering.empty() || modeOrdering.size() == (size_t)order);
+
+  std::vector<int> ordering = modeOrdering;
+  if (ordering.empty()) {
+    for (int i = 0; i < order; ++i) {
+      ordering.push_back(i);
+    }
+  }
+
+  // Each level needs the volume of the tiles of its ancestor levels to find
+  // its position within a tile.
+  std::vector<ModeFormatPack> modeTypes;
+  int tileVolume = 1;
+  for (int level = 0; level < order; ++level) {
+    const int tileSize = tileSizes[ordering[level]];
+    modeTypes.push_back(ModeFormat(
+        std::make_shared<TiledModeFormat>(tileSize, tileVolume)));
+    tileVolume *= tileSize;
+  }
+  return Format(modeTypes, ordering);
+}
+
+bool isTiled(const ModeFormat& modeFormat) {
+  return modeFormat.defined() && modeFormat.getName() == "tiled";
+}
+
+int getTileSize(const ModeFormat& modeFormat) {
+  if (!isTiled(modeFormat)) {
+    return 1;
+  }
+  return std::static_pointer_cast<const TiledModeFormat>(
+      modeFormat.impl)->getTileSize();
+}
+
 bool isDense(const Format& format) {
   for (ModeFormat modeFormat : format.getModeFormats()) {
     if (modeFormat != Dense) {
@@ -0,0 +1,429 @@
+#include "taco/tensor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <map>
+
+#include "taco/index_notation/index_notation.h"
+#include "taco/index_notation/index_notation_nodes.h"
+#include "taco/storage/statistics.h"
+#include "taco/util/collections.h"
+
+using namespace std;
+
+namespace taco {
+
+// A level is stored dense if at least this fraction of its coordinates are
+// nonzero. Iterating over a dense level costs one iteration per coordinate,
+// whereas a compressed level costs a segment bound load per fiber and a
+// coordinate load per nonzero.
+static const double denseLevelDensity = 0.5;
+
+// A tensor is stored as a coordinate list if its levels below the first hold
+// at most this many nonzeros per fiber on average, since compressed levels
+// would then spend most of their loads on segment bounds.
+static const double coordinateListFanout = 1.1;
+
+/// Returns the index variables of an expression in the order that loops over
+/// them are likely to be nested in: free variables in order of appearance
+/// followed by reduction variables.
+static vector<IndexVar> getLoopOrder(IndexExpr expr) {
+  vector<IndexVar> freeVars;
+  vector<IndexVar> reductionVars;
+  match(expr,
+    function<void(const AccessNode*)>([&](const AccessNode* op) {
+      for (auto& var : op->indexVars) {
+        if (!util::contains(freeVars, var) &&
+            !util::contains(reductionVars, var)) {
+          freeVars.push_back(var);
+        }
+      }
+    }),
+    function<void(const ReductionNode*,Matcher*)>([&](const ReductionNode* op,
+                                                      Matcher* ctx) {
+      if (!util::contains(reductionVars, op->var)) {
+        reductionVars.push_back(op->var);
+      }
+      ctx->match(op->a);
+    })
+  );
+  freeVars.insert(freeVars.end(), reductionVars.begin(), reductionVars.end());
+  return freeVars;
+}
+
+/// Returns the mode ordering in which the tensor is iterated by the loops over
+/// the context expression, or the current mode ordering if the context does
+/// not access the tensor.
+static vector<int> getPreferredModeOrdering(const TensorBase& tensor,
+                                            IndexExpr context) {
+  vector<int> modeOrdering = tensor.getFormat().getModeOrdering();
+  if (!context.defined()) {
+    return modeOrdering;
+  }
+
+  vector<IndexVar> accessVars;
+  match(context,
+    function<void(const AccessNode*)>([&](const AccessNode* op) {
+      if (accessVars.empty() && op->tensorVar == tensor.getTensorVar()) {
+        accessVars = op->indexVars;
+      }
+    })
+  );
+  if (accessVars.size() != (size_t)tensor.getOrder()) {
+    return modeOrdering;
+  }
+
+  const vector<IndexVar> loopOrder = getLoopOrder(context);
+  auto loopPosition = [&](int mode) {
+    return std::find(loopOrder.begin(), loopOrder.end(), accessVars[mode]) -
+           loopOrder.begin();
+  };
+  std::stable_sort(modeOrdering.begin(), modeOrdering.end(),
+                   [&](int a, int b) { return loopPosition(a) <
+                                              loopPosition(b); });
+  return modeOrdering;
+}
+
+/// Estimates the number of fibers of each level if the tensor were stored in
+/// the given mode ordering. The estimates are exact for the first level, the
+/// last level and for the mode ordering the statistics were collected in.
+static vector<double> estimateNumFibers(const TensorStatistics& stats,
+                                        const vector<int>& modeOrdering) {
+  const int order = stats.getOrder();
+  const bool isCollectedOrdering = (modeOrdering == stats.getModeOrdering());
+  vector<double> numFibers(order);
+  for (int l = 0; l < order; ++l) {
+    if (isCollectedOrdering) {
+      numFibers[l] = stats.getNumFibers(l);
+    } else if (l == order - 1) {
+      numFibers[l] = stats.getNumNonzeros();
+    } else if (l == 0) {
+      numFibers[l] = stats.getNumNonEmptySlices(modeOrdering[l]);
+    } else {
+      numFibers[l] = std::min((double)stats.getNumNonzeros(),
+          numFibers[l-1] * stats.getNumNonEmptySlices(modeOrdering[l]));
+    }
+  }
+  return numFibers;
+}
+
+Format suggestFormat(const TensorBase& tensor, IndexExpr context) {
+  const TensorStatistics& stats = tensor.getStatistics();
+  const int order = tensor.getOrder();
+  if (!stats.defined() || order == 0) {
+    return tensor.getFormat();
+  }
+
+  const vector<int> modeOrdering = getPreferredModeOrdering(tensor, context);
+  const vector<double> numFibers = estimateNumFibers(stats, modeOrdering);
+
+  vector<double> densities(order);
+  vector<double> fanouts(order);
+  for (int l = 0; l < order; ++l) {
+    const double parentFibers = (l == 0) ? 1.0 : numFibers[l-1];
+    const double dimension = stats.getDimension(modeOrdering[l]);
+    densities[l] = (parentFibers * dimension > 0)
+                   ? numFibers[l] / (parentFibers * dimension) : 0.0;
+    fanouts[l] = (parentFibers > 0) ? numFibers[l] / parentFibers : 0.0;
+  }
+
+  // Hypersparse tensors, whose fibers below the first level mostly hold a
+  // single nonzero, are stored as coordinate lists.
+  if (order > 1 && densities[0] < denseLevelDensity &&
+      std::all_of(fanouts.begin() + 1, fanouts.end(),
+                  [](double fanout) { return fanout <= coordinateListFanout; })) {
+    return COO(order, true, true, false, modeOrdering);
+  }
+
+  // Otherwise, store each level dense if it is dense enough and compressed if
+  // not, which yields e.g. CSR, DCSR and CSF as well as their transposes.
+  vector<ModeFormatPack> modeFormats;
+  for (int l = 0; l < order; ++l) {
+    modeFormats.push_back(densities[l] >= denseLevelDensity ? Dense
+                                                            : Compressed);
+  }
+  return Format(modeFormats, modeOrdering);
+}
+
+
+/// The layout of a tensor access: the index variables of its levels in storage
+/// order, whether the loops over the ancestors of each level must enclose the
+/// loop over it, and the number of fibers of each level if they are known.
+struct AccessLayout {
+  TensorVar tensorVar;
+  vector<int> modes;
+  vector<IndexVar> levelVars;
+  vector<bool> isConstrained;
+  vector<double> numFibers;
+};
+
+static AccessLayout getLayout(const AccessNode* access, const Format& format,
+                              bool isResult) {
+  AccessLayout layout;
+  layout.tensorVar = access->tensorVar;
+  for (int l = 0; l < format.getOrder(); ++l) {
+    const int mode = format.getModeOrdering()[l];
+    const ModeFormat modeFormat = format.getModeFormats()[l];
+    layout.modes.push_back(mode);
+    layout.levelVars.push_back(access->indexVars[mode]);
+    // Operands constrain the loop order at levels that cannot be randomly
+    // accessed and results at levels that cannot be randomly inserted into.
+    layout.isConstrained.push_back(isResult ? !modeFormat.hasInsert()
+                                            : !modeFormat.hasLocate());
+  }
+  return layout;
+}
+
+/// Returns true if the loop order iterates over the constrained levels of the
+/// access after their ancestors.
+static bool agrees(const AccessLayout& layout, const vector<IndexVar>& order) {
+  auto position = [&](const IndexVar& var) {
+    return std::find(order.begin(), order.end(), var) - order.begin();
+  };
+  for (size_t l = 0; l < layout.levelVars.size(); ++l) {
+    if (!layout.isConstrained[l]) {
+      continue;
+    }
+    for (size_t a = 0; a < l; ++a) {
+      if (position(layout.levelVars[a]) > position(layout.levelVars[l])) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/// Orders the loops the way reorderLoopsTopologically does: each loop is the
+/// first variable in the preferred order whose constraints are satisfied.
+/// Returns an empty vector if the constraints are cyclic.
+static vector<IndexVar> orderLoops(vector<IndexVar> preferred,
+                                   const vector<AccessLayout>& layouts) {
+  vector<IndexVar> order;
+  while (!preferred.empty()) {
+    auto next = std::find_if(preferred.begin(), preferred.end(),
+                             [&](const IndexVar& var) {
+      for (auto& layout : layouts) {
+        for (size_t l = 0; l < layout.levelVars.size(); ++l) {
+          if (layout.levelVars[l] != var || !layout.isConstrained[l]) {
+            continue;
+          }
+          for (size_t a = 0; a < l; ++a) {
+            if (layout.levelVars[a] != var &&
+                !util::contains(order, layout.levelVars[a])) {
+              return false;
+            }
+          }
+        }
+      }
+      return true;
+    });
+    if (next == preferred.end()) {
+      return {};
+    }
+    order.push_back(*next);
+    preferred.erase(next);
+  }
+  return order;
+}
+
+/// Estimates the cost of a loop order as the number of loop iterations it
+/// executes.  A loop over a variable that indexes constrained operand levels
+/// co-iterates over their fibers; other loops iterate over the dimension.  If
+/// the loops over a sparse result are nested inside a reduction loop, then
+/// the result must be scattered into a dense workspace that is swept once for
+/// every iteration of the loops outside of the reduction.
+static double estimateCost(const vector<IndexVar>& order,
+                           const vector<AccessLayout>& operands,
+                           const AccessLayout& result,
+                           const map<IndexVar,double>& dimensions) {
+  double cost = 0.0;
+  double iterations = 1.0;
+  double workspaceSweeps = -1.0;
+  double workspaceSize = 1.0;
+  for (auto& var : order) {
+    const double dimension = dimensions.at(var);
+    double coiterated = 0.0;
+    double intersected = dimension;
+    bool isSparse = false;
+    for (auto& layout : operands) {
+      for (size_t l = 0; l < layout.levelVars.size(); ++l) {
+        if (layout.levelVars[l] != var || !layout.isConstrained[l]) {
+          continue;
+        }
+        double fanout = dimension;
+        if (!layout.numFibers.empty()) {
+          const double parentFibers = (l == 0) ? 1.0 : layout.numFibers[l-1];
+          fanout = (parentFibers > 0) ? layout.numFibers[l] / parentFibers
+                                      : 0.0;
+        }
+        coiterated += fanout;
+        intersected = std::min(intersected, fanout);
+        isSparse = true;
+      }
+    }
+
+    const bool isFree = util::contains(result.levelVars, var);
+    if (!isFree && workspaceSweeps < 0.0) {
+      workspaceSweeps = iterations;
+    } else if (isFree && workspaceSweeps >= 0.0) {
+      const size_t level = std::find(result.levelVars.begin(),
+                                     result.levelVars.end(), var) -
+                           result.levelVars.begin();
+      if (result.isConstrained[level]) {
+        workspaceSize *= dimension;
+      }
+    }
+
+    cost += iterations * (isSparse ? coiterated : dimension);
+    iterations *= isSparse ? intersected : dimension;
+  }
+  if (workspaceSweeps >= 0.0 && workspaceSize > 1.0) {
+    cost += workspaceSweeps * workspaceSize;
+  }
+  return cost;
+}
+
+map<TensorVar,Format> suggestOperandFormats(Assignment assignment,
+                                            const vector<TensorBase>& operands) {
+  const Access lhs = assignment.getLhs();
+  const TensorVar result = lhs.getTensorVar();
+
+  map<TensorVar,TensorBase> tensors;
+  for (auto& operand : operands) {
+    tensors.insert({operand.getTensorVar(), operand});
+  }
+
+  // Collect the layouts of the operand accesses.  Operands that are accessed
+  // more than once, windowed, or that are not packed tensors keep their format.
+  vector<AccessLayout> layouts;
+  map<TensorVar,int> numAccesses;
+  bool isStatisticsDefined = true;
+  map<IndexVar,double> dimensions;
+  match(assignment.getRhs(),
+    function<void(const AccessNode*)>([&](const AccessNode* op) {
+      const TensorVar& var = op->tensorVar;
+      for (int mode = 0; mode < var.getOrder(); ++mode) {
+        Dimension dimension = var.getType().getShape().getDimension(mode);
+        if (dimension.isFixed()) {
+          dimensions[op->indexVars[mode]] = dimension.getSize();
+        }
+      }
+      numAccesses[var]++;
+      if (var.getOrder() == 0) {
+        return;
+      }
+      AccessLayout layout = getLayout(op, var.getFormat(), false);
+      if (util::contains(tensors, var)) {
+        const TensorStatistics& stats = tensors.at(var).getStatistics();
+        if (stats.defined()) {
+          layout.numFibers = estimateNumFibers(stats, layout.modes);
+        } else {
+          isStatisticsDefined = false;
+        }
+      }
+      if (!op->windowedModes.empty() || !op->indexSetModes.empty() ||
+          op->isAccessingStructure) {
+        numAccesses[var]++;
+      }
+      layouts.push_back(layout);
+    })
+  );
+  const AccessLayout resultLayout = getLayout(getNode(lhs),
+                                              result.getFormat(), true);
+  for (int mode = 0; mode < result.getOrder(); ++mode) {
+    Dimension dimension = result.getType().getShape().getDimension(mode);
+    if (dimension.isFixed()) {
+      dimensions[lhs.getIndexVars()[mode]] = dimension.getSize();
+    }
+  }
+
+  // The preferred loop order iterates over the result in its storage order
+  // before reducing, so that the result is never scattered into.
+  vector<IndexVar> preferred = resultLayout.levelVars;
+  for (auto& var : getLoopOrder(assignment.getRhs())) {
+    if (!util::contains(preferred, var)) {
+      preferred.push_back(var);
+    }
+  }
+  for (auto& var : preferred) {
+    if (!util::contains(dimensions, var)) {
+      return {};
+    }
+  }
+
+  // Plan A: keep every format and let the loops be reordered, which may
+  // nest reductions outside of result loops.
+  vector<AccessLayout> constraints = layouts;
+  constraints.push_back(resultLayout);
+  const vector<IndexVar> keptOrder = orderLoops(preferred, constraints);
+  const bool isKeptOrderValid = !keptOrder.empty();
+
+  // Plan B: convert the operands that disagree with the preferred loop order.
+  map<TensorVar,Format> formats;
+  double conversionCost = 0.0;
+  vector<AccessLayout> convertedLayouts;
+  for (auto layout : layouts) {
+    if (!agrees(layout, preferred)) {
+      const TensorVar& var = layout.tensorVar;
+      if (!util::contains(tensors, var) || numAccesses.at(var) > 1 ||
+          var == result) {
+        return {};
+      }
+      const TensorBase& tensor = tensors.at(var);
+      const Format& format = tensor.getFormat();
+
+      // Order the modes the way the preferred loop order iterates over them.
+      vector<int> modeOrdering = layout.modes;
+      vector<IndexVar> accessVars(var.getOrder());
+      for (size_t l = 0; l < layout.modes.size(); ++l) {
+        accessVars[layout.modes[l]] = layout.levelVars[l];
+      }
+      auto position = [&](int mode) {
+        return std::find(preferred.begin(), preferred.end(),
+                         accessVars[mode]) - preferred.begin();
+      };
+      std::stable_sort(modeOrdering.begin(), modeOrdering.end(),
+                       [&](int a, int b) { return position(a) < position(b); });
+      Format converted(format.getModeFormatPacks(), modeOrdering);
+      converted.setValueEncoding(format.getValueEncoding());
+      formats.insert({var, converted});
+
+      layout.modes = modeOrdering;
+      for (size_t l = 0; l < modeOrdering.size(); ++l) {
+        layout.levelVars[l] = accessVars[modeOrdering[l]];
+      }
+      if (tensor.getStatistics().defined()) {
+        const TensorStatistics& stats = tensor.getStatistics();
+        const double nnz = stats.getNumNonzeros();
+        layout.numFibers = estimateNumFibers(stats, modeOrdering);
+        conversionCost += nnz * std::log2(nnz + 1.0) + nnz;
+      }
+    }
+    convertedLayouts.push_back(layout);
+  }
+  if (formats.empty()) {
+    return {};
+  }
+
+  // Converting costs a sort of the operand's nonzeros, which pays off when
+  // the loop order and workspace forced by the current formats costs more.
+  // Without statistics, operands are only converted when they have to be.
+  if (isKeptOrderValid) {
+    if (!isStatisticsDefined) {
+      return {};
+    }
+    const double keptCost = estimateCost(keptOrder, layouts, resultLayout,
+                                         dimensions);
+    const double convertedCost = estimateCost(preferred, convertedLayouts,
+                                              resultLayout, dimensions) +
+                                 conversionCost;
+    if (keptCost <= convertedCost) {
+      return {};
+    }
+  }
+  return formats;
+}
+
+}
@@ -17,6 +17,7 @@
 #include "taco/index_notation/properties.h"
 #include "taco/index_notation/intrinsic.h"
 #include "taco/index_notation/schedule.h"
+#include "taco/index_notation/semiring.h"
 #include "taco/index_notation/transformations.h"
 #include "taco/index_notation/index_notation_nodes.h"
 #include "taco/index_notation/index_notation_rewriter.h"
@@ -1165,6 +1166,31 @@ static void check(Assignment assignment) {
   taco_uassert(typecheck.first) << error::expr_dimension_mismatch << " " << typecheck.second;
 }
 
+static bool isMaskCall(IndexExpr expr) {
+  if (!isa<CallNode>(expr.ptr)) {
+    return false;
+  }
+  const CallNode* call = to<CallNode>(expr.ptr);
+  return (call->name == "mask" || call->name == "complement_mask" ||
+          call->name == "mask_accumulate" ||
+          call->name == "complement_mask_accumulate") &&
+         call->args.size() == 2 && isa<AccessNode>(call->args[0].ptr);
+}
+
+/// Masked compound assignments accumulate into the values that the result
+/// holds, which the lowerer must then preserve, so they are marked in the
+/// name of the mask call.
+static IndexExpr accumulateIntoMasked(IndexExpr expr) {
+  if (!isMaskCall(expr) ||
+      to<CallNode>(expr.ptr)->name.find("_accumulate") != string::npos) {
+    return expr;
+  }
+  const CallNode* call = to<CallNode>(expr.ptr);
+  return new CallNode(call->name + "_accumulate", call->args,
+                      call->defaultLowerFunc, call->iterAlg, call->properties,
+                      call->regionDefinitions, call->definedRegions);
+}
+
 Assignment Access::operator=(const IndexExpr& expr) {
   TensorVar result = getTensorVar();
   Assignment assignment = Assignment(*this, expr);
@@ -1186,7 +1212,7 @@ Assignment Access::operator+=(const IndexExpr& expr) {
   Assignment assignment = Assignment(
     result,
     getIndexVars(),
-    expr,
+    accumulateIntoMasked(expr),
     Add(),
     // Include any windows on LHS index vars.
     getNode(*this)->packageModifiers()
@@ -1246,6 +1272,12 @@ Literal::Literal(long long val) : Literal(new LiteralNode(val)) {
 Literal::Literal(int8_t val) : Literal(new LiteralNode(val)) {
 }
 
+Literal::Literal(float16 val) : Literal(new LiteralNode(val)) {
+}
+
+Literal::Literal(bfloat16 val) : Literal(new LiteralNode(val)) {
+}
+
 Literal::Literal(float val) : Literal(new LiteralNode(val)) {
 }
 
@@ -1269,6 +1301,8 @@ Literal Literal::zero(Datatype type) {
     case Datatype::Int16:       return Literal(int16_t(0));
     case Datatype::Int32:       return Literal(int32_t(0));
     case Datatype::Int64:       return Literal(int64_t(0));
+    case Datatype::Float16:     return Literal(float16(0.0f));
+    case Datatype::BFloat16:    return Literal(bfloat16(0.0f));
     case Datatype::Float32:     return Literal(float(0.0));
     case Datatype::Float64:     return Literal(double(0.0));
     case Datatype::Complex64:   return Literal(std::complex<float>());
@@ -1294,6 +1328,8 @@ template int Literal::getVal() const;
 template long Literal::getVal() const;
 template long long Literal::getVal() const;
 template int8_t Literal::getVal() const;
+template float16 Literal::getVal() const;
+template bfloat16 Literal::getVal() const;
 template float Literal::getVal() const;
 template double Literal::getVal() const;
 template std::complex<float> Literal::getVal() const;
@@ -1532,6 +1568,47 @@ template <> Call to<Call>(IndexExpr e) {
   return Call(to<CallNode>(e.ptr));
 }
 
+
+// class Mask
+Mask::Mask(Access mask, bool complement) : mask(mask), complement(complement) {
+}
+
+Access Mask::getAccess() const {
+  return mask;
+}
+
+bool Mask::isComplemented() const {
+  return complement;
+}
+
+bool Mask::defined() const {
+  return mask.defined();
+}
+
+bool Mask::accumulates() const {
+  return accumulate;
+}
+
+Call Mask::operator()(IndexExpr expr) const {
+  taco_uassert(defined()) << "Cannot apply an undefined mask";
+
+  // Sum the variables that do not index the mask inside the mask, so that the
+  // mask's sparsity bounds iteration before the reductions.
+  expr = makeReductionNotation(Assignment(mask, expr)).getRhs();
+
+  const bool complemented = complement;
+  auto algebra = [complemented](const std::vector<IndexExpr>& args) {
+    return complemented ? IterationAlgebra(Intersect(Complement(args[0]), args[1]))
+                        : IterationAlgebra(Intersect(args[0], args[1]));
+  };
+  auto lowerFunc = [](const std::vector<ir::Expr>& args) {
+    return args[1];
+  };
+  std::vector<IndexExpr> args = {mask, expr};
+  return Call(new CallNode(complement ? "complement_mask" : "mask", args,
+                           lowerFunc, algebra(args), {}, {}));
+}
+
 // class CallIntrinsic
 CallIntrinsic::CallIntrinsic(const CallIntrinsicNode* n) : IndexExpr(n) {
 }
@@ -2063,6 +2140,32 @@ Assignment::Assignment(Access lhs, IndexExpr rhs, IndexExpr op)
     : Assignment(new AssignmentNode(lhs, rhs, op)) {
 }
 
+Assignment::Assignment(Access lhs, IndexExpr rhs, Mask mask, IndexExpr op)
+    : Assignment(lhs, op.defined() ? accumulateIntoMasked(mask(rhs))
+                                   : IndexExpr(mask(rhs)), op) {
+  taco_uassert(util::toSet(mask.getAccess().getIndexVars()) ==
+               util::toSet(lhs.getIndexVars()))
+      << "The mask " << mask.getAccess() << " must be indexed by the free "
+      << "variables of " << lhs;
+}
+
+static IndexExpr semiringOperator(const Semiring& semiring, IndexExpr op) {
+  if (!op.defined()) {
+    return op;
+  }
+  taco_uassert(isa<Add>(op)) << "Only additions can be evaluated over the "
+                             << semiring << " semiring";
+  Func add = semiring.getAdd();
+  return add();
+}
+
+Assignment::Assignment(Access lhs, IndexExpr rhs, const Semiring& semiring,
+                       IndexExpr op)
+    : Assignment(lhs, semiring(makeReductionNotation(Assignment(lhs, rhs))
+                               .getRhs()),
+                 semiringOperator(semiring, op)) {
+}
+
 Assignment::Assignment(TensorVar tensor, vector<IndexVar> indices,
                        IndexExpr rhs, IndexExpr op,
                        const std::map<int, std::shared_ptr<IndexVarIterationModifier>>& modifiers)
@@ -2102,6 +2205,17 @@ std::vector<IndexVar> Assignment::getReductionVars() const {
   return reductionVars;
 }
 
+Mask Assignment::getMask() const {
+  if (!isMaskCall(getRhs())) {
+    return Mask();
+  }
+  Call call = to<Call>(getRhs());
+  Mask mask(to<Access>(call.getArgs()[0]),
+            call.getName().find("complement_") == 0);
+  mask.accumulate = call.getName().find("_accumulate") != string::npos;
+  return mask;
+}
+
 template <> bool isa<Assignment>(IndexStmt s) {
   return isa<AssignmentNode>(s.ptr);
 }
@@ -2559,6 +2673,13 @@ void TensorVar::setName(std::string name) {
   content->name = name;
 }
 
+void TensorVar::setFormat(const Format& format) {
+  taco_uassert(format.getOrder() == getOrder())
+      << "The format order (" << format.getOrder() << ") must match the "
+      << "order of " << getName() << " (" << getOrder() << ")";
+  content->format = format;
+}
+
 bool TensorVar::defined() const {
   return content != nullptr;
 }
@@ -3030,8 +3151,16 @@ struct ReplaceReductionsWithWheres : IndexNotationRewriter {
     }
 
     reduction = node;
+    Literal fill;
+    if (isa<Call>(node->op)) {
+      Identity identity =
+          findProperty<Identity>(to<Call>(node->op).getProperties());
+      if (identity.defined() && identity.positions().empty()) {
+        fill = identity.identity();
+      }
+    }
     t = TensorVar("t" + util::toString(node->var),
-                  node->getDataType());
+                  node->getDataType(), fill);
     expr = t;
   }
 };
@@ -67,6 +67,12 @@ void IndexNotationPrinter::visit(const LiteralNode* op) {
     case Datatype::Int128:
       taco_not_supported_yet;
       break;
+    case Datatype::Float16:
+      os << float(op->getVal<float16>());
+      break;
+    case Datatype::BFloat16:
+      os << float(op->getVal<bfloat16>());
+      break;
     case Datatype::Float32:
       os << op->getVal<float>();
       break;
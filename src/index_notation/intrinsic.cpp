@@ -43,6 +43,8 @@ ir::Expr ModIntrinsic::lower(const std::vector<ir::Expr>& args) const {
     case Datatype::Int32:
     case Datatype::Int64:
       return ir::Rem::make(a, b);
+    case Datatype::Float16:
+    case Datatype::BFloat16:
     case Datatype::Float32:
       return ir::Call::make("fmodf", args, a.type());
     case Datatype::Float64:
@@ -93,6 +95,8 @@ ir::Expr AbsIntrinsic::lower(const std::vector<ir::Expr>& args) const {
       return ir::Call::make("abs", args, arg.type());
     case Datatype::Int64:
       return ir::Call::make("labs", args, arg.type());
+    case Datatype::Float16:
+    case Datatype::BFloat16:
     case Datatype::Float32:
       return ir::Call::make("fabsf", args, arg.type());
     case Datatype::Float64:
@@ -143,6 +147,8 @@ ir::Expr PowIntrinsic::lower(const std::vector<ir::Expr>& args) const {
                              ir::to<ir::Literal>(exponent)->equalsScalar(0.0));
 
   switch (base.type().getKind()) {
+    case Datatype::Float16:
+    case Datatype::BFloat16:
     case Datatype::Float32:
       return exponentZero ? ir::Literal::make((float)1.0) : 
              ir::Call::make("powf", args, base.type());
@@ -251,6 +257,8 @@ ir::Expr SqrtIntrinsic::lower(const std::vector<ir::Expr>& args) const {
   }
 
   switch (arg.type().getKind()) {
+    case Datatype::Float16:
+    case Datatype::BFloat16:
     case Datatype::Float32:
       return ir::Call::make("sqrtf", args, arg.type());
     case Datatype::Float64:
@@ -296,6 +304,8 @@ ir::Expr CbrtIntrinsic::lower(const std::vector<ir::Expr>& args) const {
   }
 
   switch (arg.type().getKind()) {
+    case Datatype::Float16:
+    case Datatype::BFloat16:
     case Datatype::Float32:
       return ir::Call::make("cbrtf", args, arg.type());
     case Datatype::Float64:
@@ -332,6 +342,8 @@ ir::Expr ExpIntrinsic::lower(const std::vector<ir::Expr>& args) const {
                         ir::to<ir::Literal>(arg)->equalsScalar(0.0));
 
   switch (arg.type().getKind()) {
+    case Datatype::Float16:
+    case Datatype::BFloat16:
     case Datatype::Float32:
       return argZero ? ir::Literal::make((float)1.0) : 
              ir::Call::make("expf", args, arg.type());
@@ -379,6 +391,8 @@ ir::Expr LogIntrinsic::lower(const std::vector<ir::Expr>& args) const {
   }
   
   switch (arg.type().getKind()) {
+    case Datatype::Float16:
+    case Datatype::BFloat16:
     case Datatype::Float32:
       return ir::Call::make("logf", args, arg.type());
     case Datatype::Float64:
@@ -422,6 +436,8 @@ ir::Expr Log10Intrinsic::lower(const std::vector<ir::Expr>& args) const {
   }
   
   switch (arg.type().getKind()) {
+    case Datatype::Float16:
+    case Datatype::BFloat16:
     case Datatype::Float32:
     case Datatype::Float64:
       return ir::Call::make("log10", args, arg.type());
@@ -460,6 +476,8 @@ ir::Expr SinIntrinsic::lower(const std::vector<ir::Expr>& args) const {
   }
 
   switch (arg.type().getKind()) {
+    case Datatype::Float16:
+    case Datatype::BFloat16:
     case Datatype::Float32:
       return ir::Call::make("sinf", args, arg.type());
     case Datatype::Float64:
@@ -500,6 +518,8 @@ ir::Expr CosIntrinsic::lower(const std::vector<ir::Expr>& args) const {
                         ir::to<ir::Literal>(arg)->equalsScalar(0.0));
 
   switch (arg.type().getKind()) {
+    case Datatype::Float16:
+    case Datatype::BFloat16:
     case Datatype::Float32:
       return argZero ? ir::Literal::make((float)1.0) : 
              ir::Call::make("cosf", args, arg.type());
@@ -547,6 +567,8 @@ ir::Expr TanIntrinsic::lower(const std::vector<ir::Expr>& args) const {
   }
 
   switch (arg.type().getKind()) {
+    case Datatype::Float16:
+    case Datatype::BFloat16:
     case Datatype::Float32:
       return ir::Call::make("tanf", args, arg.type());
     case Datatype::Float64:
@@ -590,6 +612,8 @@ ir::Expr AsinIntrinsic::lower(const std::vector<ir::Expr>& args) const {
   }
 
   switch (arg.type().getKind()) {
+    case Datatype::Float16:
+    case Datatype::BFloat16:
     case Datatype::Float32:
       return ir::Call::make("asinf", args, arg.type());
     case Datatype::Float64:
@@ -628,6 +652,8 @@ ir::Expr AcosIntrinsic::lower(const std::vector<ir::Expr>& args) const {
   ir::Expr arg = args[0];
 
   switch (arg.type().getKind()) {
+    case Datatype::Float16:
+    case Datatype::BFloat16:
     case Datatype::Float32:
       return ir::Call::make("acosf", args, arg.type());
     case Datatype::Float64:
@@ -671,6 +697,8 @@ ir::Expr AtanIntrinsic::lower(const std::vector<ir::Expr>& args) const {
   }
 
   switch (arg.type().getKind()) {
+    case Datatype::Float16:
+    case Datatype::BFloat16:
     case Datatype::Float32:
       return ir::Call::make("atanf", args, arg.type());
     case Datatype::Float64:
@@ -718,6 +746,8 @@ ir::Expr Atan2Intrinsic::lower(const std::vector<ir::Expr>& args) const {
   }
 
   switch (a.type().getKind()) {
+    case Datatype::Float16:
+    case Datatype::BFloat16:
     case Datatype::Float32:
       return ir::Call::make("atan2f", args, a.type());
     case Datatype::Float64:
@@ -777,6 +807,8 @@ ir::Expr SinhIntrinsic::lower(const std::vector<ir::Expr>& args) const {
   }
 
   switch (arg.type().getKind()) {
+    case Datatype::Float16:
+    case Datatype::BFloat16:
     case Datatype::Float32:
       return ir::Call::make("sinhf", args, arg.type());
     case Datatype::Float64:
@@ -817,6 +849,8 @@ ir::Expr CoshIntrinsic::lower(const std::vector<ir::Expr>& args) const {
                         ir::to<ir::Literal>(arg)->equalsScalar(0.0));
 
   switch (arg.type().getKind()) {
+    case Datatype::Float16:
+    case Datatype::BFloat16:
     case Datatype::Float32:
       return argZero ? ir::Literal::make((float)1.0) : 
              ir::Call::make("coshf", args, arg.type());
@@ -864,6 +898,8 @@ ir::Expr TanhIntrinsic::lower(const std::vector<ir::Expr>& args) const {
   }
 
   switch (arg.type().getKind()) {
+    case Datatype::Float16:
+    case Datatype::BFloat16:
     case Datatype::Float32:
       return ir::Call::make("tanhf", args, arg.type());
     case Datatype::Float64:
@@ -907,6 +943,8 @@ ir::Expr AsinhIntrinsic::lower(const std::vector<ir::Expr>& args) const {
   }
 
   switch (arg.type().getKind()) {
+    case Datatype::Float16:
+    case Datatype::BFloat16:
     case Datatype::Float32:
       return ir::Call::make("asinhf", args, arg.type());
     case Datatype::Float64:
@@ -945,6 +983,8 @@ ir::Expr AcoshIntrinsic::lower(const std::vector<ir::Expr>& args) const {
   ir::Expr arg = args[0];
 
   switch (arg.type().getKind()) {
+    case Datatype::Float16:
+    case Datatype::BFloat16:
     case Datatype::Float32:
       return ir::Call::make("acoshf", args, arg.type());
     case Datatype::Float64:
@@ -988,6 +1028,8 @@ ir::Expr AtanhIntrinsic::lower(const std::vector<ir::Expr>& args) const {
   }
 
   switch (arg.type().getKind()) {
+    case Datatype::Float16:
+    case Datatype::BFloat16:
     case Datatype::Float32:
       return ir::Call::make("atanhf", args, arg.type());
     case Datatype::Float64:
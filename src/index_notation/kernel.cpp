@@ -59,10 +59,11 @@ void unpackResults(size_t numResults, const vector<void*> arguments,
     size_t num = 1;
     for (int i = 0; i < storage.getOrder(); i++) {
       ModeFormat modeType = format.getModeFormats()[i];
-      if (modeType.getName() == Dense.getName()) {
-        Array size = makeArray({*(int*)tensorData->indices[i][0]});
-        modeIndices.push_back(ModeIndex({size}));
-        num *= ((int*)tensorData->indices[i][0])[0];
+      if (modeType.getName() == Dense.getName() || isTiled(modeType)) {
+        const int size = *(int*)tensorData->indices[i][0];
+        const int tileSize = getTileSize(modeType);
+        modeIndices.push_back(ModeIndex({makeArray({size})}));
+        num *= (size + tileSize - 1) / tileSize * tileSize;
       } else if (modeType.getName() == Sparse.getName()) {
         auto size = ((int*)tensorData->indices[i][0])[num];
         Array pos = Array(type<int>(), tensorData->indices[i][0],
@@ -523,6 +523,12 @@ std::vector<ir::Expr> PosRelNode::locateBounds(std::vector<ir::Expr> coordBounds
   if (isa<ir::GetProperty>(simplifiedParentBound) && to<ir::GetProperty>(simplifiedParentBound)->property == ir::TensorProperty::Dimension) {
     end = segment_bounds[1];
   }
+  // fixed dimensions are lowered to literals
+  Dimension dimension = accessIterator.getMode().getSize();
+  if (isa<ir::Literal>(simplifiedParentBound) && dimension.isFixed() &&
+      to<ir::Literal>(simplifiedParentBound)->equalsScalar(dimension.getSize())) {
+    end = segment_bounds[1];
+  }
   return {start, end};
 }
 
@@ -0,0 +1,130 @@
+#include "taco/index_notation/semiring.h"
+
+#include <limits>
+
+#include "taco/index_notation/index_notation_nodes.h"
+#include "taco/index_notation/index_notation_rewriter.h"
+#include "taco/index_notation/properties.h"
+#include "taco/error.h"
+#include "taco/ir/ir.h"
+
+using namespace std;
+
+namespace taco {
+
+Semiring::Semiring(string name, Func add, Func multiply, Literal zero)
+    : name(name), add(add), multiply(multiply), zero(zero) {
+}
+
+const string& Semiring::getName() const {
+  return name;
+}
+
+const Func& Semiring::getAdd() const {
+  return add;
+}
+
+const Func& Semiring::getMultiply() const {
+  return multiply;
+}
+
+const Literal& Semiring::getZero() const {
+  return zero;
+}
+
+IndexExpr Semiring::operator()(IndexExpr expr) const {
+  struct RewriteSemiring : public IndexNotationRewriter {
+    using IndexNotationRewriter::visit;
+
+    Func add;
+    Func multiply;
+
+    RewriteSemiring(Func add, Func multiply) : add(add), multiply(multiply) {}
+
+    void visit(const AddNode* op) {
+      expr = add(rewrite(op->a), rewrite(op->b));
+    }
+
+    void visit(const MulNode* op) {
+      expr = multiply(rewrite(op->a), rewrite(op->b));
+    }
+
+    void visit(const ReductionNode* op) {
+      IndexExpr body = rewrite(op->a);
+      expr = isa<taco::Add>(op->op) ? Reduction(add(), op->var, body)
+                                    : Reduction(op->op, op->var, body);
+    }
+  };
+  return RewriteSemiring(add, multiply).rewrite(expr);
+}
+
+static Literal literal(Datatype type, double value) {
+  switch (type.getKind()) {
+    case Datatype::Bool:     return Literal(value != 0.0);
+    case Datatype::UInt8:    return Literal(uint8_t(value));
+    case Datatype::UInt16:   return Literal(uint16_t(value));
+    case Datatype::UInt32:   return Literal(uint32_t(value));
+    case Datatype::UInt64:   return Literal(uint64_t(value));
+    case Datatype::Int8:     return Literal(int8_t(value));
+    case Datatype::Int16:    return Literal(int16_t(value));
+    case Datatype::Int32:    return Literal(int32_t(value));
+    case Datatype::Int64:    return Literal(int64_t(value));
+    case Datatype::Float16:  return Literal(float16(float(value)));
+    case Datatype::BFloat16: return Literal(bfloat16(float(value)));
+    case Datatype::Float32:  return Literal(float(value));
+    case Datatype::Float64:  return Literal(double(value));
+    default:
+      taco_uerror << "Semirings are not supported for " << type;
+  }
+  return Literal();
+}
+
+Semiring Semiring::minPlus(Datatype type) {
+  taco_uassert(type.isFloat()) << "The min-plus semiring requires a floating "
+                               << "point type to represent infinity";
+  const double inf = numeric_limits<double>::infinity();
+  Func min("min", [](const vector<ir::Expr>& v) {
+             return ir::Min::make(v[0], v[1]);
+           },
+           {Identity(literal(type, inf)), Annihilator(literal(type, -inf)),
+            Associative(), Commutative()});
+  Func plus("plus", [](const vector<ir::Expr>& v) {
+              return ir::Add::make(v[0], v[1]);
+            },
+            {Annihilator(literal(type, inf)), Identity(literal(type, 0.0)),
+             Associative(), Commutative()});
+  return Semiring("min_plus", min, plus, literal(type, inf));
+}
+
+Semiring Semiring::maxTimes(Datatype type) {
+  Func max("max", [](const vector<ir::Expr>& v) {
+             return ir::Max::make(v[0], v[1]);
+           },
+           {Identity(literal(type, 0.0)), Associative(), Commutative()});
+  Func times("times", [](const vector<ir::Expr>& v) {
+               return ir::Mul::make(v[0], v[1]);
+             },
+             {Annihilator(literal(type, 0.0)), Identity(literal(type, 1.0)),
+              Associative(), Commutative()});
+  return Semiring("max_times", max, times, literal(type, 0.0));
+}
+
+Semiring Semiring::orAnd(Datatype type) {
+  Func lor("or", [](const vector<ir::Expr>& v) {
+             return ir::Or::make(v[0], v[1]);
+           },
+           {Identity(literal(type, 0.0)), Annihilator(literal(type, 1.0)),
+            Associative(), Commutative()});
+  Func land("and", [](const vector<ir::Expr>& v) {
+              return ir::And::make(v[0], v[1]);
+            },
+            {Annihilator(literal(type, 0.0)), Identity(literal(type, 1.0)),
+             Associative(), Commutative()});
+  return Semiring("or_and", lor, land, literal(type, 0.0));
+}
+
+std::ostream& operator<<(std::ostream& os, const Semiring& semiring) {
+  return os << semiring.getName();
+}
+
+}
@@ -3,6 +3,7 @@
 #include "taco/index_notation/index_notation.h"
 #include "taco/index_notation/index_notation_rewriter.h"
 #include "taco/index_notation/index_notation_nodes.h"
+#include "taco/index_notation/properties.h"
 #include "taco/error/error_messages.h"
 #include "taco/util/collections.h"
 #include "taco/lower/iterator.h"
@@ -11,6 +12,7 @@
 #include "taco/lower/mode_format_impl.h"
 
 #include <iostream>
+#include <functional>
 #include <algorithm>
 #include <limits>
 #include <set>
@@ -834,6 +836,15 @@ IndexStmt Parallelize::apply(IndexStmt stmt, std::string* reason) const {
       definedIndexVars.insert(foralli.getIndexVar());
 
       if (foralli.getIndexVar() == i) {
+        // Task-parallel loops have no synchronization to resolve races with
+        if (parallelize.getParallelUnit() == ParallelUnit::CPUTask &&
+            parallelize.getOutputRaceStrategy() != OutputRaceStrategy::NoRaces &&
+            parallelize.getOutputRaceStrategy() != OutputRaceStrategy::IgnoreRaces) {
+          reason = "Precondition failed: CPUTask loops only support the "
+                   "NoRaces and IgnoreRaces output race strategies";
+          return;
+        }
+
         // Precondition 1: No parallelization of reduction variables
         if (parallelize.getOutputRaceStrategy() == OutputRaceStrategy::NoRaces &&
             util::contains(reductionIndexVars, i)) {
@@ -920,6 +931,31 @@ IndexStmt Parallelize::apply(IndexStmt stmt, std::string* reason) const {
           );
           taco_iassert(!precomputeAssignments.empty());
 
+          // On CPUs, reductions into tensors are lowered by giving every
+          // thread a private copy of the (dense) results instead
+          bool privatizeResults = !should_use_CUDA_codegen();
+          for (auto assignment : precomputeAssignments) {
+            privatizeResults &= (assignment->lhs.getIndexVars().size() > 0);
+          }
+          if (privatizeResults) {
+            for (auto assignment : precomputeAssignments) {
+              const Format& format = assignment->lhs.getTensorVar().getFormat();
+              for (const auto& modeFormat : format.getModeFormats()) {
+                if (modeFormat.getName() != Dense.getName()) {
+                  reason = "Precondition failed: Results that are reduced "
+                           "into using the Temporary output race strategy "
+                           "must be dense";
+                  return;
+                }
+              }
+            }
+            stmt = forall(i, foralli.getStmt(), foralli.getMergeStrategy(),
+                          parallelize.getParallelUnit(),
+                          parallelize.getOutputRaceStrategy(),
+                          foralli.getUnrollFactor());
+            return;
+          }
+
           IndexStmt precomputed_stmt = forall(i, foralli.getStmt(), foralli.getMergeStrategy(), parallelize.getParallelUnit(), parallelize.getOutputRaceStrategy(), foralli.getUnrollFactor());
           for (auto assignment : precomputeAssignments) {
             // Construct temporary of correct type and size of outer loop
@@ -1069,7 +1105,8 @@ IndexStmt SetAssembleStrategy::apply(IndexStmt stmt, string* reason) const {
 
   // If attribute query computation should be independently schedulable, then 
   // need to use fresh index variables
-  if (getSeparatelySchedulable()) {
+  const bool symbolic = (getAssembleStrategy() == AssembleStrategy::Symbolic);
+  if (getSeparatelySchedulable() || symbolic) {
     std::map<IndexVar,IndexVar> ivReplacements;
     for (const auto& indexVar : getIndexVars(stmt)) {
       ivReplacements[indexVar] = IndexVar("q" + indexVar.getName());
@@ -1428,7 +1465,29 @@ IndexStmt SetAssembleStrategy::apply(IndexStmt stmt, string* reason) const {
   loweredQueries = 
       EliminateRedundantTemps(inlinedResults).rewrite(loweredQueries);
 
-  return Assemble(loweredQueries, stmt, queryResults);
+  IndexStmt assembled = Assemble(loweredQueries, stmt, queryResults);
+  if (symbolic && !should_use_CUDA_codegen()) {
+    // Count the nonzeros of each row, and then insert them, in parallel.  The
+    // outermost loops are left serial if they cannot be parallelized.
+    const IndexStmt queryLoop = isa<Where>(loweredQueries)
+                              ? to<Where>(loweredQueries).getConsumer()
+                              : loweredQueries;
+    for (IndexStmt loop : {queryLoop, stmt}) {
+      if (!isa<Forall>(loop) ||
+          to<Forall>(loop).getParallelUnit() != ParallelUnit::NotParallel) {
+        continue;
+      }
+      string parallelizeReason;
+      IndexStmt parallelized = Parallelize(to<Forall>(loop).getIndexVar(),
+                                           ParallelUnit::CPUThread,
+                                           OutputRaceStrategy::NoRaces)
+                               .apply(assembled, &parallelizeReason);
+      if (parallelized.defined()) {
+        assembled = parallelized;
+      }
+    }
+  }
+  return assembled;
 }
 
 void SetAssembleStrategy::print(std::ostream& os) const {
@@ -1445,6 +1504,34 @@ std::ostream& operator<<(std::ostream& os,
 
 // Autoscheduling functions
 
+#if USE_OPENMP
+/// Returns true if some operand stores i in a dense level directly above a
+/// compressed level (e.g. the rows of a CSR matrix), in which case splitting
+/// the loop over i by nonzeros balances the work better than by rows.
+static bool hasCompressedRows(IndexStmt stmt, IndexVar i) {
+  bool found = false;
+  match(stmt,
+        function<void(const AssignmentNode*)>([&](const AssignmentNode* op) {
+          match(op->rhs,
+                function<void(const AccessNode*)>([&](const AccessNode* node) {
+                  const Format& format = node->tensorVar.getFormat();
+                  if (format.getOrder() < 2 || node->isAccessingStructure) {
+                    return;
+                  }
+                  const auto& modeFormats = format.getModeFormats();
+                  int outer = format.getModeOrdering()[0];
+                  if (node->indexVars[outer] == i &&
+                      modeFormats[0].getName() == Dense.getName() &&
+                      modeFormats[1].getName() == Compressed.getName()) {
+                    found = true;
+                  }
+                }));
+        })
+  );
+  return found;
+}
+#endif
+
 IndexStmt parallelizeOuterLoop(IndexStmt stmt) {
   // get outer ForAll
   Forall forall;
@@ -1482,7 +1569,16 @@ IndexStmt parallelizeOuterLoop(IndexStmt stmt) {
     return parallelized256;
   }
   else {
-    IndexStmt parallelized = Parallelize(forall.getIndexVar(), ParallelUnit::CPUThread, OutputRaceStrategy::NoRaces).apply(stmt, &reason);
+#if USE_OPENMP
+    ParallelUnit unit = hasCompressedRows(stmt, forall.getIndexVar())
+                        ? ParallelUnit::CPUThreadBalanced
+                        : ParallelUnit::CPUThread;
+#else
+    // Without OpenMP the parallel pragmas are ignored, so run the loop on the
+    // task runtime instead, which also balances skewed rows by stealing.
+    ParallelUnit unit = ParallelUnit::CPUTask;
+#endif
+    IndexStmt parallelized = Parallelize(forall.getIndexVar(), unit, OutputRaceStrategy::NoRaces).apply(stmt, &reason);
     if (parallelized == IndexStmt()) {
       // can't parallelize
       return stmt;
@@ -1657,7 +1753,35 @@ IndexStmt reorderLoopsTopologically(IndexStmt stmt) {
     tensorVarOrders[tensorLevelVar.first] = 
         varOrderFromTensorLevels(tensorLevelVar.second);
   }
-  const auto hardDeps = depsFromVarOrders(tensorVarOrders);
+  auto hardDeps = depsFromVarOrders(tensorVarOrders);
+
+  // A masked assignment computes only the entries sampled by its mask, so its
+  // free variables, which iterate over the mask, are ordered before the
+  // variables that are reduced inside the mask unless a tensor's storage order
+  // requires otherwise.
+  if (isa<Assignment>(dagBuilder.innerBody) &&
+      to<Assignment>(dagBuilder.innerBody).getMask().defined()) {
+    Assignment assignment = to<Assignment>(dagBuilder.innerBody);
+    std::function<bool(IndexVar,IndexVar)> dependsOn = [&](IndexVar var,
+                                                           IndexVar dep) {
+      if (!hardDeps.count(var)) {
+        return false;
+      }
+      for (const IndexVar& hardDep : hardDeps.at(var)) {
+        if (hardDep == dep || dependsOn(hardDep, dep)) {
+          return true;
+        }
+      }
+      return false;
+    };
+    for (const IndexVar& reductionVar : assignment.getReductionVars()) {
+      for (const IndexVar& freeVar : assignment.getFreeVars()) {
+        if (!dependsOn(freeVar, reductionVar)) {
+          hardDeps[reductionVar].insert(freeVar);
+        }
+      }
+    }
+  }
 
   struct CollectSoftDependencies : public IndexNotationVisitor {
     using IndexNotationVisitor::visit;
@@ -1836,13 +1960,28 @@ IndexStmt scalarPromote(IndexStmt stmt, ProvenanceGraph provGraph,
           // This assumes the index expression yields at most one result tensor; 
           // will not work correctly if there are multiple results.
           TensorVar resultVar = resultAccess.first.getTensorVar();
+          IndexExpr op = util::contains(reduceOp, resultAccess.first) 
+                       ? reduceOp.at(resultAccess.first) : IndexExpr();
+
+          // Reductions with user-defined operators start from the operator's 
+          // identity rather than from zero.
+          Literal fill;
+          match(body,
+            function<void(const AssignmentNode*)>([&](const AssignmentNode* n) {
+              if (n->lhs == resultAccess.first && isa<Call>(n->op)) {
+                Identity identity = 
+                    findProperty<Identity>(to<Call>(n->op).getProperties());
+                if (identity.defined() && identity.positions().empty()) {
+                  fill = identity.identity();
+                }
+              }
+            })
+          );
           TensorVar val("t" + i.getName() + resultVar.getName(), 
-                        Type(resultVar.getType().getDataType(), {}));
+                        Type(resultVar.getType().getDataType(), {}), fill);
           body = ReplaceReductionExpr(
               map<Access,Access>({{resultAccess.first, val()}})).rewrite(body);
 
-          IndexExpr op = util::contains(reduceOp, resultAccess.first) 
-                       ? reduceOp.at(resultAccess.first) : IndexExpr();
           IndexStmt consumer = Assignment(Access(resultAccess.first), val(), op);
           consumers.push_back(consumer);
         }
@@ -1869,6 +2008,29 @@ IndexStmt scalarPromote(IndexStmt stmt) {
   return scalarPromote(stmt, ProvenanceGraph(stmt), true, false);
 }
 
+IndexStmt widenAccumulators(IndexStmt stmt, Datatype type) {
+  map<TensorVar,TensorVar> accumulators;
+  match(stmt,
+    function<void(const WhereNode*)>([&](const WhereNode* op) {
+      Where where(op);
+      TensorVar temporary = where.getTemporary();
+      Datatype temporaryType = temporary.getType().getDataType();
+      if (temporary.getOrder() != 0 || temporaryType == type ||
+          max_type(temporaryType, type) != type ||
+          getResultAccesses(where.getProducer()).second.empty()) {
+        return;
+      }
+      Literal fill = temporary.getFill();
+      if (equals(fill, Literal::zero(temporaryType))) {
+        fill = Literal::zero(type);
+      }
+      accumulators.insert({temporary, TensorVar(temporary.getName(),
+                                                Type(type, {}), fill)});
+    })
+  );
+  return accumulators.empty() ? stmt : replace(stmt, accumulators);
+}
+
 static bool compare(std::vector<IndexVar> vars1, std::vector<IndexVar> vars2) {
   return vars1 == vars2;
 }
@@ -1987,4 +2149,402 @@ IndexStmt insertTemporaries(IndexStmt stmt)
   return stmt;
 }
 
+IndexStmt eliminateCommonSubexpressions(IndexStmt stmt) {
+  // Only perfect loop nests around a single assignment are optimized
+  vector<Forall> loops;
+  IndexStmt body = stmt;
+  while (isa<Forall>(body)) {
+    loops.push_back(to<Forall>(body));
+    body = loops.back().getStmt();
+  }
+  if (loops.empty() || !isa<Assignment>(body)) {
+    return stmt;
+  }
+  Assignment assignment = to<Assignment>(body);
+  const TensorVar result = assignment.getLhs().getTensorVar();
+
+  vector<IndexVar> loopVars;
+  for (auto& loop : loops) {
+    if (loop.getParallelUnit() != ParallelUnit::NotParallel ||
+        loop.getUnrollFactor() != 0) {
+      return stmt;
+    }
+    loopVars.push_back(loop.getIndexVar());
+  }
+
+  // Collects the unary, binary, and cast subexpressions of an expression,
+  // outer subexpressions first.  If a filter is set, the subexpressions that
+  // it accepts are collected without their own subexpressions.
+  struct CollectSubexpressions : public IndexNotationVisitor {
+    using IndexNotationVisitor::visit;
+
+    std::function<bool(IndexExpr)> filter;
+    vector<IndexExpr> subexprs;
+
+    bool collect(IndexExpr expr) {
+      if (!filter) {
+        subexprs.push_back(expr);
+        return false;
+      }
+      if (filter(expr)) {
+        subexprs.push_back(expr);
+        return true;
+      }
+      return false;
+    }
+
+    void visit(const UnaryExprNode* op) {
+      if (!collect(op)) {
+        IndexNotationVisitor::visit(op);
+      }
+    }
+
+    void visit(const BinaryExprNode* op) {
+      if (!collect(op)) {
+        IndexNotationVisitor::visit(op);
+      }
+    }
+
+    void visit(const CastNode* op) {
+      if (!collect(op)) {
+        IndexNotationVisitor::visit(op);
+      }
+    }
+  };
+
+  // The position of the loop over each variable
+  map<IndexVar,size_t> loopPositions;
+  for (size_t l = 0; l < loopVars.size(); l++) {
+    loopPositions.insert({loopVars[l], l});
+  }
+
+  // Returns the dimensions of the variables that a subexpression depends on,
+  // or false if it reads anything but dense tensors whose dimensions are fixed
+  auto getDimensions = [&](IndexExpr expr, map<IndexVar,Dimension>* dims) {
+    bool isDenseExpr = true;
+    bool readsTensor = false;
+    match(expr,
+      function<void(const AccessNode*)>([&](const AccessNode* op) {
+        const TensorVar& var = op->tensorVar;
+        readsTensor = true;
+        if (var == result || !isDense(var.getFormat()) ||
+            !op->windowedModes.empty() || !op->indexSetModes.empty() ||
+            op->isAccessingStructure) {
+          isDenseExpr = false;
+          return;
+        }
+        for (size_t mode = 0; mode < op->indexVars.size(); mode++) {
+          Dimension dim = var.getType().getShape().getDimension(mode);
+          if (!dim.isFixed()) {
+            isDenseExpr = false;
+          }
+          dims->insert({op->indexVars[mode], dim});
+        }
+      }),
+      function<void(const IndexVarNode*)>([&](const IndexVarNode*) {
+        isDenseExpr = false;
+      }),
+      function<void(const ReductionNode*)>([&](const ReductionNode*) {
+        isDenseExpr = false;
+      })
+    );
+    for (auto& dim : *dims) {
+      isDenseExpr &= util::contains(loopPositions, dim.first);
+    }
+    return isDenseExpr && readsTensor;
+  };
+
+  CollectSubexpressions collectAll;
+  assignment.getRhs().accept(&collectAll);
+  auto countOccurrences = [&](IndexExpr expr) {
+    return std::count_if(collectAll.subexprs.begin(), collectAll.subexprs.end(),
+                         [&](IndexExpr other) { return equals(expr, other); });
+  };
+
+  CollectSubexpressions collectHoisted;
+  collectHoisted.filter = [&](IndexExpr expr) {
+    map<IndexVar,Dimension> dims;
+    if (!getDimensions(expr, &dims)) {
+      return false;
+    }
+    return dims.size() < loopVars.size() || countOccurrences(expr) > 1;
+  };
+  assignment.getRhs().accept(&collectHoisted);
+  if (collectHoisted.subexprs.empty()) {
+    return stmt;
+  }
+
+  // Precompute each distinct subexpression into a temporary, which is placed
+  // inside the loop at a given level (-1 places it outside of the nest)
+  struct Hoisted {
+    int level;
+    IndexStmt producer;
+  };
+  vector<Hoisted> hoisted;
+  map<IndexExpr,IndexExpr> substitutions;
+  for (auto& expr : collectHoisted.subexprs) {
+    bool isPrecomputed = false;
+    for (auto& substitution : substitutions) {
+      if (equals(substitution.first, expr)) {
+        substitutions.insert({expr, substitution.second});
+        isPrecomputed = true;
+        break;
+      }
+    }
+    if (isPrecomputed) {
+      continue;
+    }
+
+    map<IndexVar,Dimension> dims;
+    getDimensions(expr, &dims);
+    int prefix = 0;
+    while (prefix < (int)loopVars.size() &&
+           util::contains(dims, loopVars[prefix])) {
+      prefix++;
+    }
+    vector<IndexVar> tempVars;
+    int innermost = -1;
+    for (auto& dim : dims) {
+      if ((int)loopPositions.at(dim.first) >= prefix) {
+        tempVars.push_back(dim.first);
+      }
+      innermost = std::max(innermost, (int)loopPositions.at(dim.first));
+    }
+
+    // Subexpressions that would need a matrix temporary are recomputed in
+    // the innermost loop they depend on instead
+    int level = prefix - 1;
+    if (tempVars.size() > 1) {
+      tempVars.clear();
+      level = innermost;
+    }
+    if (level == (int)loopVars.size() - 1 && countOccurrences(expr) < 2) {
+      continue;
+    }
+
+    vector<Dimension> tempDims;
+    for (auto& var : tempVars) {
+      tempDims.push_back(dims.at(var));
+    }
+    TensorVar temp("cse" + to_string(hoisted.size()),
+                   Type(expr.getDataType(), Shape(tempDims)),
+                   Format(std::vector<ModeFormatPack>(tempVars.size(),
+                                                      taco::dense)));
+    IndexStmt producer = Assignment(temp(tempVars), expr);
+    for (auto& var : util::reverse(tempVars)) {
+      producer = forall(var, producer);
+    }
+    hoisted.push_back({level, producer});
+    substitutions.insert({expr, temp(tempVars)});
+  }
+  if (hoisted.empty()) {
+    return stmt;
+  }
+
+  IndexStmt optimized = Assignment(assignment.getLhs(),
+                                   replace(assignment.getRhs(), substitutions),
+                                   assignment.getOperator());
+  for (int level = (int)loops.size() - 1; level >= -1; level--) {
+    for (auto& temp : hoisted) {
+      if (temp.level == level) {
+        optimized = where(optimized, temp.producer);
+      }
+    }
+    if (level >= 0) {
+      const Forall& loop = loops[level];
+      optimized = forall(loop.getIndexVar(), optimized, loop.getMergeStrategy(),
+                         loop.getParallelUnit(), loop.getOutputRaceStrategy(),
+                         loop.getUnrollFactor());
+    }
+  }
+  return optimized;
+}
+
+IndexStmt optimizeContractionOrder(Assignment assignment,
+                                   const map<TensorVar,size_t>& nonzeros) {
+  if (assignment.getOperator().defined()) {
+    return assignment;
+  }
+
+  // Collect the factors of the product, which must all be plain accesses.
+  // Summations are moved out of the product, which does not change its value.
+  vector<Access> operands;
+  bool isProduct = true;
+  function<void(IndexExpr)> collectFactors = [&](IndexExpr expr) {
+    if (isa<Reduction>(expr) && isa<Add>(to<Reduction>(expr).getOp())) {
+      collectFactors(to<Reduction>(expr).getExpr());
+    } else if (isa<Mul>(expr)) {
+      collectFactors(to<Mul>(expr).getA());
+      collectFactors(to<Mul>(expr).getB());
+    } else if (isa<Access>(expr)) {
+      operands.push_back(to<Access>(expr));
+    } else {
+      isProduct = false;
+    }
+  };
+  collectFactors(assignment.getRhs());
+  // The search below considers every subset of the operands
+  if (!isProduct || operands.size() < 3 || operands.size() > 12) {
+    return assignment;
+  }
+
+  map<IndexVar,double> dimensions;
+  vector<set<IndexVar>> operandVars;
+  vector<double> densities;
+  for (auto& operand : operands) {
+    const TensorVar& tensor = operand.getTensorVar();
+    if (operand.hasWindowedModes() || operand.hasIndexSetModes() ||
+        getNode(operand)->isAccessingStructure) {
+      return assignment;
+    }
+    set<IndexVar> vars;
+    double size = 1.0;
+    for (size_t mode = 0; mode < operand.getIndexVars().size(); mode++) {
+      const IndexVar& var = operand.getIndexVars()[mode];
+      Dimension dimension = tensor.getType().getShape().getDimension(mode);
+      if (!dimension.isFixed() || util::contains(vars, var)) {
+        return assignment;
+      }
+      vars.insert(var);
+      dimensions[var] = dimension.getSize();
+      size *= dimension.getSize();
+    }
+    operandVars.push_back(vars);
+    densities.push_back((util::contains(nonzeros, tensor) && size > 0)
+                        ? std::min(1.0, nonzeros.at(tensor) / size) : 1.0);
+  }
+  const set<IndexVar> resultVars(assignment.getFreeVars().begin(),
+                                 assignment.getFreeVars().end());
+
+  // The index variables of the tensor that contracts a subset of the
+  // operands, which are those that the result or other operands also use
+  const size_t numOperands = operands.size();
+  const uint32_t all = (1u << numOperands) - 1;
+  auto getVars = [&](uint32_t subset) -> set<IndexVar> {
+    if (subset == all) {
+      return resultVars;
+    }
+    set<IndexVar> vars;
+    set<IndexVar> usedElsewhere = resultVars;
+    for (size_t operand = 0; operand < numOperands; operand++) {
+      auto& target = (subset & (1u << operand)) ? vars : usedElsewhere;
+      target.insert(operandVars[operand].begin(), operandVars[operand].end());
+    }
+    set<IndexVar> contracted;
+    std::set_intersection(vars.begin(), vars.end(),
+                          usedElsewhere.begin(), usedElsewhere.end(),
+                          std::inserter(contracted, contracted.begin()));
+    return contracted;
+  };
+  auto getSize = [&](const set<IndexVar>& vars) {
+    double size = 1.0;
+    for (auto& var : vars) {
+      size *= dimensions.at(var);
+    }
+    return size;
+  };
+
+  // Find the cheapest way to contract each subset of the operands, where
+  // contracting two tensors costs a multiplication per nonzero pair in the
+  // iteration space of their index variables, and temporaries are dense.
+  vector<set<IndexVar>> subsetVars(all + 1);
+  vector<double> density(all + 1, 1.0);
+  vector<double> cost(all + 1, std::numeric_limits<double>::infinity());
+  vector<uint32_t> split(all + 1, 0);
+  for (uint32_t subset = 1; subset <= all; subset++) {
+    subsetVars[subset] = getVars(subset);
+  }
+  for (size_t operand = 0; operand < numOperands; operand++) {
+    subsetVars[1u << operand] = operandVars[operand];
+    density[1u << operand] = densities[operand];
+    cost[1u << operand] = 0.0;
+  }
+  for (uint32_t subset = 1; subset <= all; subset++) {
+    if (__builtin_popcount(subset) < 2) {
+      continue;
+    }
+    for (uint32_t lhs = (subset - 1) & subset; lhs > 0;
+         lhs = (lhs - 1) & subset) {
+      uint32_t rhs = subset ^ lhs;
+      if (lhs < rhs) {
+        continue;
+      }
+      set<IndexVar> iterationVars = subsetVars[lhs];
+      iterationVars.insert(subsetVars[rhs].begin(), subsetVars[rhs].end());
+      double contractionCost = cost[lhs] + cost[rhs] +
+          getSize(iterationVars) * density[lhs] * density[rhs] +
+          ((subset != all) ? getSize(subsetVars[subset]) : 0.0);
+      if (contractionCost < cost[subset]) {
+        cost[subset] = contractionCost;
+        split[subset] = lhs;
+      }
+    }
+  }
+
+  set<IndexVar> allVars;
+  double fusedCost = 1.0;
+  for (size_t operand = 0; operand < numOperands; operand++) {
+    allVars.insert(operandVars[operand].begin(), operandVars[operand].end());
+    fusedCost *= densities[operand];
+  }
+  fusedCost *= getSize(allVars);
+  if (cost[all] >= fusedCost) {
+    return assignment;
+  }
+
+  // Emit the contractions of the cheapest order, temporaries first
+  vector<IndexStmt> producers;
+  auto makeContraction = [&](Assignment contraction) {
+    IndexStmt stmt = makeConcreteNotation(makeReductionNotation(contraction));
+    stmt = reorderLoopsTopologically(stmt);
+    return insertTemporaries(stmt);
+  };
+  function<IndexExpr(uint32_t)> contract = [&](uint32_t subset) -> IndexExpr {
+    if (__builtin_popcount(subset) == 1) {
+      return operands[__builtin_ctz(subset)];
+    }
+    IndexExpr product = contract(split[subset]) *
+                        contract(subset ^ split[subset]);
+    if (subset == all) {
+      return product;
+    }
+
+    // Order the temporary's modes by their first use in the operands
+    vector<IndexVar> tempVars;
+    for (size_t operand = 0; operand < numOperands; operand++) {
+      if (!(subset & (1u << operand))) {
+        continue;
+      }
+      for (auto& var : operands[operand].getIndexVars()) {
+        if (util::contains(subsetVars[subset], var) &&
+            !util::contains(tempVars, var)) {
+          tempVars.push_back(var);
+        }
+      }
+    }
+    vector<Dimension> tempDimensions;
+    for (auto& var : tempVars) {
+      tempDimensions.push_back((int)dimensions.at(var));
+    }
+    TensorVar temp("t" + to_string(producers.size()),
+                   Type(product.getDataType(), Shape(tempDimensions)),
+                   Format(std::vector<ModeFormatPack>(tempVars.size(),
+                                                      taco::dense)));
+    producers.push_back(makeContraction(Assignment(temp(tempVars), product)));
+    return temp(tempVars);
+  };
+  IndexExpr product = contract(all);
+
+  IndexStmt stmt = makeContraction(Assignment(assignment.getLhs(), product));
+  // Results with sparse modes cannot be scattered into
+  if (!isDense(assignment.getLhs().getTensorVar().getFormat()) &&
+      !isa<Where>(stmt) && !allForFreeLoopsBeforeAllReductionLoops(stmt)) {
+    return assignment;
+  }
+  for (auto& producer : util::reverse(producers)) {
+    stmt = where(stmt, producer);
+  }
+  return stmt;
+}
+
 }
@@ -85,6 +85,12 @@ Expr Literal::zero(Datatype datatype) {
     case Datatype::Int128:
       taco_not_supported_yet;
       break;
+    case Datatype::Float16:
+      zero = Literal::make(float16(0.0f));
+      break;
+    case Datatype::BFloat16:
+      zero = Literal::make(bfloat16(0.0f));
+      break;
     case Datatype::Float32:
       zero = Literal::make((float)0.0);
       break;
@@ -157,6 +163,10 @@ uint64_t Literal::getUIntValue() const {
 double Literal::getFloatValue() const {
   taco_iassert(type.isFloat()) << "Type must be floating point";
   switch (type.getKind()) {
+    case Datatype::Float16:
+      return getValue<float16>();
+    case Datatype::BFloat16:
+      return getValue<bfloat16>();
     case Datatype::Float32:
       static_assert(sizeof(float) == 4, "Float not 32 bits");
       return getValue<float>();
@@ -224,6 +234,12 @@ bool Literal::equalsScalar(double scalar) const {
     case Datatype::Int128:
       taco_not_supported_yet;
     break;
+    case Datatype::Float16:
+      return compare<float16>(this, scalar);
+    break;
+    case Datatype::BFloat16:
+      return compare<bfloat16>(this, scalar);
+    break;
     case Datatype::Float32:
       return compare<float>(this, scalar);
     break;
@@ -836,7 +852,8 @@ Expr GetProperty::make(Expr tensor, TensorProperty property, int mode,
   gp->index = index;
   
   //TODO: deal with the fact that some of these are pointers
-  if (property == TensorProperty::Values)
+  if (property == TensorProperty::Values ||
+      property == TensorProperty::ValueDictionary)
     gp->type = tensor.type();
   else
     gp->type = Int();
@@ -860,7 +877,8 @@ Expr GetProperty::make(Expr tensor, TensorProperty property, int mode) {
   gp->mode = mode;
   
   //TODO: deal with the fact that these are pointers.
-  if (property == TensorProperty::Values)
+  if (property == TensorProperty::Values ||
+      property == TensorProperty::ValueDictionary)
     gp->type = tensor.type();
   else
     gp->type = Int();
@@ -894,10 +912,26 @@ Expr GetProperty::make(Expr tensor, TensorProperty property, int mode) {
     case TensorProperty::FillValue:
       gp->name = tensorVar->name + "_fill_value";
       break;
+    case TensorProperty::ValueDictionary:
+      gp->name = tensorVar->name + "_vals_dict";
+      break;
   }
   
   return gp;
 }
+
+Expr GetProperty::make(Expr tensor, TensorProperty property, Datatype type) {
+  taco_iassert(property == TensorProperty::Values ||
+               property == TensorProperty::ValueDictionary);
+  const Expr prop = make(tensor, property);
+  GetProperty* gp = new GetProperty;
+  gp->tensor = tensor;
+  gp->property = property;
+  gp->mode = 0;
+  gp->name = to<GetProperty>(prop)->name;
+  gp->type = type;
+  return gp;
+}
   
 // visitor methods
 template<> void ExprNode<Literal>::accept(IRVisitorStrict *v)
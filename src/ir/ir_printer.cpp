@@ -1,3 +1,4 @@
+#include <cmath>
 #include <sstream>
 #include <iostream>
 
@@ -45,6 +46,10 @@ void IRPrinter::setColor(bool color) {
 }
 
 void IRPrinter::print(Stmt stmt) {
+  getPrintedStmt(stmt).accept(this);
+}
+
+Stmt IRPrinter::getPrintedStmt(Stmt stmt) {
   if (isa<Scope>(stmt)) {
     stmt = to<Scope>(stmt)->scopedStmt;
   }
@@ -55,7 +60,7 @@ void IRPrinter::print(Stmt stmt) {
       stmt = ir::simplify(stmt);
     } while (stmt != oldStmt);
   }
-  stmt.accept(this);
+  return stmt;
 }
 
 void IRPrinter::visit(const Literal* op) {
@@ -97,11 +102,30 @@ void IRPrinter::visit(const Literal* op) {
     case Datatype::Int128:
       taco_not_supported_yet;
     break;
+    case Datatype::Float16:
+    case Datatype::BFloat16: {
+      // Kernels compute on 16-bit floats in float
+      const float value = (float)op->getFloatValue();
+      if (std::isinf(value)) {
+        stream << (value < 0 ? "-INFINITY" : "INFINITY");
+        break;
+      }
+      stream << ((value != 0.0) ? util::toString(value) : "0.0");
+    }
+    break;
     case Datatype::Float32:
+      if (std::isinf(op->getValue<float>())) {
+        stream << (op->getValue<float>() < 0 ? "-INFINITY" : "INFINITY");
+        break;
+      }
       stream << ((op->getValue<float>() != 0.0)
                  ? util::toString(op->getValue<float>()) : "0.0");
     break;
     case Datatype::Float64:
+      if (std::isinf(op->getValue<double>())) {
+        stream << (op->getValue<double>() < 0 ? "-INFINITY" : "INFINITY");
+        break;
+      }
       stream << ((op->getValue<double>()!=0.0)
                  ? util::toString(op->getValue<double>()) : "0.0");
     break;
@@ -488,6 +488,10 @@ void IRRewriter::visit(const GetProperty* op) {
   if (tensor == op->tensor) {
     expr = op;
   }
+  else if (op->property == TensorProperty::Values &&
+           op->type != tensor.type()) {
+    expr = GetProperty::make(tensor, op->property, op->type);
+  }
   else {
     expr = GetProperty::make(tensor, op->property, op->mode, op->index, op->name);
   }
@@ -2,10 +2,10 @@
 
 namespace taco {
 
-const char *ParallelUnit_NAMES[] = {"NotParallel", "DefaultUnit", "GPUBlock", "GPUWarp", "GPUThread", "CPUThread", "CPUVector", "CPUThreadGroupReduction", "GPUBlockReduction", "GPUWarpReduction"};
+const char *ParallelUnit_NAMES[] = {"NotParallel", "DefaultUnit", "GPUBlock", "GPUWarp", "GPUThread", "CPUThread", "CPUVector", "CPUThreadGroupReduction", "GPUBlockReduction", "GPUWarpReduction", "CPUThreadBalanced", "CPUTask"};
 const char *OutputRaceStrategy_NAMES[] = {"IgnoreRaces", "NoRaces", "Atomics", "Temporary", "ParallelReduction"};
 const char *BoundType_NAMES[] = {"MinExact", "MinConstraint", "MaxExact", "MaxConstraint"};
-const char *AssembleStrategy_NAMES[] = {"Append", "Insert"};
-const char *MergeStrategy_NAMES[] = {"TwoFinger", "Gallop"};
+const char *AssembleStrategy_NAMES[] = {"Append", "Insert", "Symbolic"};
+const char *MergeStrategy_NAMES[] = {"TwoFinger", "Gallop", "SimdBlock"};
 
 }
@@ -11,6 +11,7 @@
 #include "taco/ir/ir.h"
 #include "taco/ir/ir_generators.h"
 #include "taco/ir/ir_visitor.h"
+#include "taco/ir/ir_rewriter.h"
 #include "taco/ir/simplify.h"
 #include "taco/lower/iterator.h"
 #include "taco/lower/merge_lattice.h"
@@ -25,6 +26,13 @@ using taco::util::combine;
 
 namespace taco {
 
+// Sorted workspace indices are recovered by scanning the workspace's bit guard
+// rather than by sorting its index list when the list holds at least one index
+// per this many workspace entries.  Sorting n indices calls a comparison
+// function O(n log n) times, and each call costs about as much as scanning
+// ten or more entries.
+static const int denseScanRatio = 128;
+
 class LowererImplImperative::Visitor : public IndexNotationVisitorStrict {
 public:
   Visitor(LowererImplImperative* impl) : impl(impl) {}
@@ -109,6 +117,11 @@ static void getDependentTensors(IndexStmt stmt, std::set<TensorVar>& tensors) {
   } while (prev != tensors);
 }
 
+static bool isCPUThreadUnit(ParallelUnit unit) {
+  return unit == ParallelUnit::CPUThread ||
+         unit == ParallelUnit::CPUThreadBalanced;
+}
+
 static bool returnsTrue(IndexExpr expr) {
   struct ReturnsTrue : public IndexExprRewriterStrict {
     void visit(const AccessNode* op) {
@@ -230,6 +243,33 @@ static std::set<Expr> hasSparseInserts(IndexStmt stmt, Iterators iterators,
   return ret;
 }
 
+/// Returns the set of result tensors that masked assignments accumulate into,
+/// which keep the values they hold outside of the mask.
+static std::set<TensorVar> getAccumulatedResults(IndexStmt stmt) {
+  std::set<TensorVar> ret;
+  match(stmt,
+    function<void(const AssignmentNode*)>([&](const AssignmentNode* op) {
+      if (Assignment(op).getMask().accumulates()) {
+        ret.insert(op->lhs.getTensorVar());
+      }
+    }),
+    function<void(const WhereNode*,Matcher*)>([&](const WhereNode* op,
+                                                  Matcher* ctx) {
+      ctx->match(op->producer);
+      ctx->match(op->consumer);
+      // Scalar promotion moves masked reductions into temporaries
+      for (const auto& temporary : getResultAccesses(op->producer).first) {
+        if (util::contains(ret, temporary.getTensorVar())) {
+          for (const auto& result : getResultAccesses(op->consumer).first) {
+            ret.insert(result.getTensorVar());
+          }
+        }
+      }
+    })
+  );
+  return ret;
+}
+
 Stmt
 LowererImplImperative::lower(IndexStmt stmt, string name,
                    bool assemble, bool compute, bool pack, bool unpack)
@@ -243,7 +283,19 @@ LowererImplImperative::lower(IndexStmt stmt, string name,
   // Create result and parameter variables
   vector<TensorVar> results = getResults(stmt);
   vector<TensorVar> arguments = getArguments(stmt);
+  resultTensors = set<TensorVar>(results.begin(), results.end());
   vector<TensorVar> temporaries = getTemporaries(stmt);
+  for (auto& result : results) {
+    taco_uassert(result.getFormat().getValueEncoding() == ValueEncoding::Plain)
+        << "Result tensor " << result.getName() << " cannot have encoded "
+        << "values (" << result.getFormat().getValueEncoding() << ")";
+    for (auto& modeFormat : result.getFormat().getModeFormats()) {
+      taco_uassert(modeFormat.hasAppend() || modeFormat.hasInsert())
+          << "Result tensor " << result.getName() << " cannot be assembled "
+          << "since " << modeFormat << " levels support neither append nor "
+          << "insert";
+    }
+  }
 
   needCompute = {};
   if (generateAssembleCode()) {
@@ -342,6 +394,13 @@ LowererImplImperative::lower(IndexStmt stmt, string name,
         // If the mode has an index set, then the dimension is the size of
         // the index set.
         return ir::Literal::make(a.getIndexSet(mode).size());
+      } else if (tv.getType().getShape().getDimension(mode).isFixed()) {
+        // Fixed dimensions are compile-time constants, which gives loops over
+        // them constant trip counts that the C compiler can unroll and
+        // vectorize.  Kernels are cached by tensor type, so a kernel is only
+        // reused for tensors with the same dimensions.
+        return ir::Literal::make(
+            (int)tv.getType().getShape().getDimension(mode).getSize());
       } else {
         return GetProperty::make(tensorVars.at(tv), TensorProperty::Dimension, mode);
       }
@@ -409,6 +468,22 @@ LowererImplImperative::lower(IndexStmt stmt, string name,
   
   // Identify the set of result tensors that must be explicitly initialized
   nonFullyInitializedResults = hasSparseInserts(stmt, iterators, provGraph);
+  accumulatedResults = getAccumulatedResults(stmt);
+
+  // Results computed by loops that are distributed over CPU threads with the
+  // runtime schedule are initialized with the same schedule
+  resultInitLoopKind = LoopKind::Static_Chunked;
+  match(stmt,
+    function<void(const ForallNode*, Matcher*)>([&](const ForallNode* n,
+                                                     Matcher* m) {
+      if (n->parallel_unit == ParallelUnit::CPUThread &&
+          n->output_race_strategy != OutputRaceStrategy::ParallelReduction) {
+        resultInitLoopKind = LoopKind::Runtime;
+        return;
+      }
+      m->match(n->stmt);
+    })
+  );
 
   // Allocate and initialize append and insert mode indices
   Stmt initializeResults = initResultArrays(resultAccesses, reducedAccesses);
@@ -646,6 +721,20 @@ LowererImplImperative::splitAppenderAndInserters(const vector<Iterator>& results
 
 Stmt LowererImplImperative::lowerForall(Forall forall)
 {
+  if (!loweringBlasFallback && generateComputeCode() &&
+      !should_use_CUDA_codegen()) {
+    Stmt blasCall = lowerForallBlas(forall);
+    if (blasCall.defined()) {
+      return blasCall;
+    }
+  }
+
+  if (forall.getOutputRaceStrategy() == OutputRaceStrategy::Temporary &&
+      isCPUThreadUnit(forall.getParallelUnit()) && !privatizingResults &&
+      generateComputeCode() && !should_use_CUDA_codegen()) {
+    return lowerForallPrivatized(forall);
+  }
+
   bool hasExactBound = provGraph.hasExactBound(forall.getIndexVar());
   bool forallNeedsUnderivedGuards = !hasExactBound && emitUnderivedGuards;
   if (!ignoreVectorize && forallNeedsUnderivedGuards &&
@@ -788,8 +877,8 @@ Stmt LowererImplImperative::lowerForall(Forall forall)
   if (temp != temporaryInitialization.end() && forall.getParallelUnit() ==
       ParallelUnit::NotParallel && !isScalar(temp->second.getTemporary().getType()))
     temporaryValuesInitFree = codeToInitializeTemporary(temp->second);
-  else if (temp != temporaryInitialization.end() && forall.getParallelUnit() ==
-           ParallelUnit::CPUThread && !isScalar(temp->second.getTemporary().getType())) {
+  else if (temp != temporaryInitialization.end() &&
+           isCPUThreadUnit(forall.getParallelUnit()) && !isScalar(temp->second.getTemporary().getType())) {
     temporaryValuesInitFree = codeToInitializeTemporaryParallel(temp->second, forall.getParallelUnit());
   }
 
@@ -896,6 +985,343 @@ Stmt LowererImplImperative::lowerForall(Forall forall)
                        temporaryValuesInitFree[1]);
 }
 
+namespace {
+
+/// Redirects writes to the values of privatized results to the copy owned by
+/// the executing thread, which is declared at the top of the parallel loop.
+class PrivatizeResults : public IRRewriter {
+public:
+  PrivatizeResults(const map<Expr, Expr, ExprCompare>& copies,
+                   const vector<Stmt>& declarations)
+      : copies(copies), declarations(declarations) {}
+
+private:
+  using IRRewriter::visit;
+
+  const map<Expr, Expr, ExprCompare>& copies;
+  const vector<Stmt>& declarations;
+  bool declared = false;
+
+  void visit(const GetProperty* op) {
+    if (op->property == TensorProperty::Values && copies.count(op->tensor)) {
+      expr = copies.at(op->tensor);
+    }
+    else {
+      expr = op;
+    }
+  }
+
+  void visit(const For* op) {
+    if (declared || op->kind == LoopKind::Serial) {
+      IRRewriter::visit(op);
+      return;
+    }
+    declared = true;
+    Stmt contents = Block::make(Block::make(declarations), rewrite(op->contents));
+    stmt = For::make(op->var, op->start, op->end, op->increment, contents,
+                     op->kind, op->parallel_unit, op->unrollFactor,
+                     op->vec_width);
+  }
+};
+
+}
+
+Stmt LowererImplImperative::lowerForallPrivatized(Forall forall) {
+  // Find the results that different iterations of the forall may write to
+  vector<IndexVar> loopVars = provGraph.getUnderivedAncestors(forall.getIndexVar());
+  loopVars.push_back(forall.getIndexVar());
+  vector<Access> writes;
+  match(forall.getStmt(),
+    function<void(const AssignmentNode*)>([&](const AssignmentNode* op) {
+      TensorVar result = op->lhs.getTensorVar();
+      if (result.getOrder() == 0 || !util::contains(resultTensors, result)) {
+        return;
+      }
+      for (const IndexVar& var : op->lhs.getIndexVars()) {
+        if (util::contains(loopVars, var)) {
+          return;
+        }
+      }
+      for (const Access& write : writes) {
+        if (write.getTensorVar() == result) {
+          return;
+        }
+      }
+      writes.push_back(op->lhs);
+    })
+  );
+
+  privatizingResults = true;
+  Stmt loop = lowerForall(forall);
+  privatizingResults = false;
+  if (writes.empty()) {
+    return loop;
+  }
+
+  string name = forall.getIndexVar().getName();
+  Expr numThreads = Var::make(name + "_threads", Int32);
+  Expr threadId = ir::Call::make("omp_get_thread_num", {}, Int32);
+  vector<Stmt> allocate = {VarDecl::make(numThreads,
+      ir::Call::make("omp_get_max_threads", {}, Int32))};
+  vector<Stmt> reduce;
+  vector<Stmt> declarations;
+  map<Expr, Expr, ExprCompare> threadCopies;
+  for (const Access& write : writes) {
+    TensorVar result = write.getTensorVar();
+    for (const auto& modeFormat : result.getFormat().getModeFormats()) {
+      taco_uassert(modeFormat.getName() == Dense.getName())
+          << "Result " << result.getName() << " of a loop parallelized with "
+          << "the Temporary output race strategy must be dense";
+    }
+
+    Expr size = 1;
+    for (const Iterator& iterator : getIterators(write)) {
+      size = ir::Mul::make(size, iterator.getWidth());
+    }
+    size = ir::simplify(size);
+
+    // One zeroed copy of the result per thread, allocated once per call
+    Datatype type = result.getType().getDataType();
+    Expr tensor = getTensorVar(result);
+    Expr copies = Var::make(result.getName() + "_copies", type, true);
+    Expr threadCopy = Var::make(result.getName() + "_thread_vals", type, true);
+    allocate.push_back(VarDecl::make(copies, 0));
+    allocate.push_back(Allocate::make(copies, ir::Mul::make(numThreads, size),
+                                      false, Expr(), true));
+    declarations.push_back(VarDecl::make(threadCopy,
+        ir::Add::make(copies, ir::Mul::make(threadId, size))));
+    threadCopies.insert({tensor, threadCopy});
+
+    // Sum the copies pairwise, in parallel over the result values
+    Expr p = Var::make("p" + result.getName(), Int32);
+    Expr stride = Var::make(result.getName() + "_stride", Int32);
+    Expr thread = Var::make(result.getName() + "_thread", Int32);
+    Stmt addPairs = For::make(thread, 0, ir::Sub::make(numThreads, stride),
+        ir::Mul::make(2, stride),
+        compoundStore(copies, ir::Add::make(ir::Mul::make(thread, size), p),
+            Load::make(copies, ir::Add::make(ir::Mul::make(
+                ir::Add::make(thread, stride), size), p))));
+    Stmt tree = Block::make(VarDecl::make(stride, 1),
+        While::make(Lt::make(stride, numThreads),
+                    Block::make(addPairs,
+                                Assign::make(stride, ir::Mul::make(stride, 2)))));
+    Expr values = GetProperty::make(tensor, TensorProperty::Values);
+    Stmt store = compoundStore(values, p, Load::make(copies, p));
+    reduce.push_back(For::make(p, 0, size, 1, Block::make(tree, store),
+                               LoopKind::Static_Chunked, ParallelUnit::CPUThread));
+    reduce.push_back(Free::make(copies));
+  }
+
+  loop = PrivatizeResults(threadCopies, declarations).rewrite(loop);
+  return Block::blanks(Block::make(allocate), loop, Block::make(reduce));
+}
+
+namespace {
+
+/// A nest of foralls that adds the product of a dense matrix and a dense
+/// matrix or vector to a dense result, as in `A(i,j) += B(i,k) * C(k,j)`.
+struct DenseProduct {
+  Access result;
+  Access matrix;
+  Access operand;
+
+  /// Whether the product is added to the result or overwrites it
+  bool accumulate = true;
+
+  set<IndexVar> loopVars;
+};
+
+/// Returns the index variables of an access in the order its modes are stored.
+vector<IndexVar> getStoredIndexVars(const Access& access) {
+  vector<IndexVar> vars;
+  for (int mode : access.getTensorVar().getFormat().getModeOrdering()) {
+    vars.push_back(access.getIndexVars()[mode]);
+  }
+  return vars;
+}
+
+bool isDenseArrayAccess(const Access& access, Datatype type) {
+  TensorVar var = access.getTensorVar();
+  if (var.getType().getDataType() != type ||
+      var.getFormat().getValueEncoding() != ValueEncoding::Plain) {
+    return false;
+  }
+  for (const auto& modeFormat : var.getFormat().getModeFormats()) {
+    if (modeFormat.getName() != Dense.getName()) {
+      return false;
+    }
+  }
+  for (int mode = 0; mode < var.getOrder(); mode++) {
+    if (access.isModeWindowed(mode) || access.isModeIndexSet(mode)) {
+      return false;
+    }
+  }
+  const vector<IndexVar>& vars = access.getIndexVars();
+  return set<IndexVar>(vars.begin(), vars.end()).size() == vars.size();
+}
+
+/// Matches a perfect nest of foralls around `result += matrix * operand`, or
+/// around the reduction of the product into a scalar temporary that is then
+/// stored in the result, as produced by scalar promotion.
+bool matchDenseProduct(Forall forall, DenseProduct* product) {
+  IndexStmt stmt = forall;
+  TensorVar promoted;
+  while (isa<Forall>(stmt) || (isa<Where>(stmt) && !promoted.defined())) {
+    if (isa<Forall>(stmt)) {
+      product->loopVars.insert(to<Forall>(stmt).getIndexVar());
+      stmt = to<Forall>(stmt).getStmt();
+      continue;
+    }
+    Where where = to<Where>(stmt);
+    if (!isa<Assignment>(where.getConsumer())) {
+      return false;
+    }
+    Assignment consumer = to<Assignment>(where.getConsumer());
+    if (!isa<Access>(consumer.getRhs()) || consumer.getMask().defined() ||
+        (consumer.getOperator().defined() &&
+         !isa<taco::Add>(consumer.getOperator()))) {
+      return false;
+    }
+    promoted = to<Access>(consumer.getRhs()).getTensorVar();
+    if (promoted.getOrder() != 0) {
+      return false;
+    }
+    product->result = consumer.getLhs();
+    product->accumulate = consumer.getOperator().defined();
+    stmt = where.getProducer();
+  }
+
+  if (!isa<Assignment>(stmt)) {
+    return false;
+  }
+  Assignment assignment = to<Assignment>(stmt);
+  if (!assignment.getOperator().defined() ||
+      !isa<taco::Add>(assignment.getOperator()) ||
+      assignment.getMask().defined() || !isa<taco::Mul>(assignment.getRhs())) {
+    return false;
+  }
+  if (!promoted.defined()) {
+    product->result = assignment.getLhs();
+  }
+  else if (assignment.getLhs().getTensorVar() != promoted) {
+    return false;
+  }
+
+  taco::Mul mul = to<taco::Mul>(assignment.getRhs());
+  if (!isa<Access>(mul.getA()) || !isa<Access>(mul.getB())) {
+    return false;
+  }
+  product->matrix = to<Access>(mul.getA());
+  product->operand = to<Access>(mul.getB());
+  if (product->matrix.getTensorVar().getOrder() <
+      product->operand.getTensorVar().getOrder()) {
+    swap(product->matrix, product->operand);
+  }
+
+  // GEMM computes A(i,j) += B(i,k) * C(k,j) and GEMV y(i) += A(i,j) * x(j)
+  const TensorVar result = product->result.getTensorVar();
+  const int order = result.getOrder();
+  if ((order != 1 && order != 2) ||
+      product->matrix.getTensorVar().getOrder() != 2 ||
+      product->operand.getTensorVar().getOrder() != order ||
+      product->loopVars.size() != (size_t)order + 1 ||
+      result == product->matrix.getTensorVar() ||
+      result == product->operand.getTensorVar()) {
+    return false;
+  }
+  const Datatype type = result.getType().getDataType();
+  if (type != Float64 && type != Float32) {
+    return false;
+  }
+  set<IndexVar> accessVars;
+  for (const Access& access : {product->result, product->matrix,
+                               product->operand}) {
+    if (!isDenseArrayAccess(access, type)) {
+      return false;
+    }
+    accessVars.insert(access.getIndexVars().begin(),
+                      access.getIndexVars().end());
+  }
+  return accessVars == product->loopVars;
+}
+
+}
+
+Stmt LowererImplImperative::lowerForallBlas(Forall forall) {
+  DenseProduct product;
+  if (!matchDenseProduct(forall, &product)) {
+    return Stmt();
+  }
+  for (const IndexVar& var : product.loopVars) {
+    if (!provGraph.isUnderived(var) || !util::contains(dimensions, var)) {
+      return Stmt();
+    }
+  }
+
+  // The result is row-major in the order of its stored modes, and operands
+  // that store the reduction variable first are transposed
+  const vector<IndexVar> resultVars = getStoredIndexVars(product.result);
+  IndexVar k;
+  for (const IndexVar& var : product.loopVars) {
+    if (!util::contains(resultVars, var)) {
+      k = var;
+    }
+  }
+  auto hasIndexVars = [](const Access& access, set<IndexVar> vars) {
+    const vector<IndexVar>& accessVars = access.getIndexVars();
+    return set<IndexVar>(accessVars.begin(), accessVars.end()) == vars;
+  };
+  auto transposed = [](const Access& access, IndexVar row) {
+    return ir::Literal::make(getStoredIndexVars(access)[0] == row ? 0 : 1);
+  };
+  auto leadingDimension = [this](const Access& access) {
+    return getDimension(getStoredIndexVars(access)[1]);
+  };
+
+  const Datatype type = product.result.getTensorVar().getType().getDataType();
+  const string prefix = (type == Float64) ? "taco_d" : "taco_s";
+  Expr beta = ir::Literal::make(product.accumulate ? 1.0 : 0.0);
+  Expr call;
+  if (resultVars.size() == 2) {
+    IndexVar i = resultVars[0];
+    IndexVar j = resultVars[1];
+    Access a = product.matrix;
+    Access b = product.operand;
+    if (!util::contains(a.getIndexVars(), i)) {
+      swap(a, b);
+    }
+    if (!hasIndexVars(a, {i, k}) || !hasIndexVars(b, {k, j})) {
+      return Stmt();
+    }
+    call = ir::Call::make(prefix + "gemm",
+        {transposed(a, i), transposed(b, k),
+         getDimension(i), getDimension(j), getDimension(k),
+         getValuesArray(a.getTensorVar()), leadingDimension(a),
+         getValuesArray(b.getTensorVar()), leadingDimension(b),
+         beta, getValuesArray(product.result.getTensorVar()),
+         getDimension(j)}, Int32);
+  }
+  else {
+    IndexVar i = resultVars[0];
+    Access a = product.matrix;
+    if (!hasIndexVars(a, {i, k}) || !hasIndexVars(product.operand, {k})) {
+      return Stmt();
+    }
+    const bool transpose = getStoredIndexVars(a)[0] != i;
+    call = ir::Call::make(prefix + "gemv",
+        {transposed(a, i),
+         getDimension(transpose ? k : i), getDimension(transpose ? i : k),
+         getValuesArray(a.getTensorVar()), leadingDimension(a),
+         getValuesArray(product.operand.getTensorVar()),
+         beta, getValuesArray(product.result.getTensorVar())}, Int32);
+  }
+
+  loweringBlasFallback = true;
+  Stmt loops = lowerForall(forall);
+  loweringBlasFallback = false;
+  return IfThenElse::make(Eq::make(call, 0), loops);
+}
+
 Stmt LowererImplImperative::lowerForallCloned(Forall forall) {
   // want to emit guards outside of loop to prevent unstructured loop exits
 
@@ -1222,7 +1648,16 @@ Stmt LowererImplImperative::lowerForallDimension(Forall forall,
   }
   else if (forall.getParallelUnit() != ParallelUnit::NotParallel
             && forall.getOutputRaceStrategy() != OutputRaceStrategy::ParallelReduction && !ignoreVectorize) {
-    kind = LoopKind::Runtime;
+    kind = (forall.getParallelUnit() == ParallelUnit::CPUTask)
+           ? LoopKind::Tasks : LoopKind::Runtime;
+  }
+
+  if (forall.getParallelUnit() == ParallelUnit::CPUThreadBalanced &&
+      kind == LoopKind::Runtime) {
+    Stmt loop = lowerForallBalanced(forall, coordinate, bounds, locators, body);
+    if (loop.defined()) {
+      return Block::blanks(loop, posAppend);
+    }
   }
 
   return Block::blanks(For::make(coordinate, bounds[0], bounds[1], 1, body,
@@ -1231,6 +1666,72 @@ Stmt LowererImplImperative::lowerForallDimension(Forall forall,
                        posAppend);
 }
 
+Stmt LowererImplImperative::lowerForallBalanced(Forall forall, Expr coordinate,
+                                               vector<Expr> bounds,
+                                               vector<Iterator> locators,
+                                               Stmt body)
+{
+  if (!provGraph.isUnderived(forall.getIndexVar())) {
+    return Stmt();
+  }
+
+  // Find a dense level at the top of an operand that sits above a compressed
+  // level, so that the position of the dense level is the loop coordinate and
+  // the child's pos array gives the number of nonzeros before every row.
+  Expr pos;
+  for (const Iterator& locator : locators) {
+    if (locator.isDimensionIterator() || locator.isLeaf() ||
+        !locator.getParent().isRoot() || locator.isWindowed() ||
+        locator.getMode().getModeFormat().getName() != Dense.getName()) {
+      continue;
+    }
+    Iterator child = locator.getChild();
+    if (child.getMode().getModeFormat().getName() == Compressed.getName() &&
+        !child.isWindowed()) {
+      pos = child.getMode().getModePack().getArray(0);
+      break;
+    }
+  }
+  if (!pos.defined()) {
+    return Stmt();
+  }
+
+  // Chunk c covers the rows [begin, end) where begin is the first row whose
+  // nonzeros start at or after c * chunkSize. Chunks only split between rows,
+  // so they write to disjoint parts of the result like ordinary row chunks.
+  string name = forall.getIndexVar().getName();
+  Expr numChunks = ir::Var::make(name + "_chunks", Int32);
+  Expr chunkSize = ir::Var::make(name + "_chunk_size", Int32);
+  Expr chunk = ir::Var::make(name + "_chunk", Int32);
+  Expr begin = ir::Var::make(name + "_begin", Int32);
+  Expr end = ir::Var::make(name + "_end", Int32);
+
+  Expr nnzBegin = ir::Load::make(pos, bounds[0]);
+  Expr nnz = ir::Sub::make(ir::Load::make(pos, bounds[1]), nnzBegin);
+  Stmt declareNumChunks = ir::VarDecl::make(numChunks,
+      ir::Call::make("omp_get_max_threads", {}, Int32));
+  Stmt declareChunkSize = ir::VarDecl::make(chunkSize,
+      ir::Div::make(ir::Add::make(nnz, ir::Sub::make(numChunks, 1)), numChunks));
+
+  auto search = [&](Expr chunk) {
+    Expr target = ir::Add::make(nnzBegin, ir::Mul::make(chunk, chunkSize));
+    return ir::Call::make("taco_binarySearchFirst",
+                      {pos, bounds[0], bounds[1], target}, Int32);
+  };
+  Stmt declareBegin = ir::VarDecl::make(begin, search(chunk));
+  Stmt declareEnd = ir::VarDecl::make(end, bounds[1]);
+  Expr nextChunk = ir::Add::make(chunk, 1);
+  Stmt searchEnd = ir::IfThenElse::make(ir::Lt::make(nextChunk, numChunks),
+                                    ir::Assign::make(end, search(nextChunk)));
+
+  Stmt rows = ir::For::make(coordinate, begin, end, 1, body, LoopKind::Serial,
+                        ParallelUnit::NotParallel, forall.getUnrollFactor());
+  Stmt chunks = ir::For::make(chunk, 0, numChunks, 1,
+                          ir::Block::make(declareBegin, declareEnd, searchEnd, rows),
+                          LoopKind::Static, ParallelUnit::CPUThreadBalanced);
+  return ir::Block::make(declareNumChunks, declareChunkSize, chunks);
+}
+
   Stmt LowererImplImperative::lowerForallDenseAcceleration(Forall forall,
                                                  vector<Iterator> locators,
                                                  vector<Iterator> inserters,
@@ -1281,7 +1782,8 @@ Stmt LowererImplImperative::lowerForallDimension(Forall forall,
     }
     else if (forall.getParallelUnit() != ParallelUnit::NotParallel
              && forall.getOutputRaceStrategy() != OutputRaceStrategy::ParallelReduction && !ignoreVectorize) {
-      kind = LoopKind::Runtime;
+      kind = (forall.getParallelUnit() == ParallelUnit::CPUTask)
+             ? LoopKind::Tasks : LoopKind::Runtime;
     }
 
     return Block::blanks(For::make(loopVar, 0, indexListSize, 1, body, kind,
@@ -1330,7 +1832,7 @@ Stmt LowererImplImperative::lowerForallPosition(Forall forall, Iterator iterator
       // If this forall is being parallelized via CPU threads (OpenMP), then we can't
       // emit a `break` statement, since OpenMP doesn't support breaking out of a
       // parallel loop. Instead, we'll bound the top of the loop and omit the check.
-      if (forall.getParallelUnit() != ParallelUnit::CPUThread) {
+      if (!isCPUThreadUnit(forall.getParallelUnit())) {
         boundsGuard = this->upperBoundGuardForWindowPosition(iterator, coordinate);
       }
     }
@@ -1374,7 +1876,7 @@ Stmt LowererImplImperative::lowerForallPosition(Forall forall, Iterator iterator
       // As discussed above, if this position loop is parallelized over CPU
       // threads (OpenMP), then we need to have an explicit upper bound to
       // the for loop, instead of breaking out of the loop in the middle.
-      if (forall.getParallelUnit() == ParallelUnit::CPUThread) {
+      if (isCPUThreadUnit(forall.getParallelUnit())) {
         endBound = this->searchForEndOfWindowPosition(iterator, startBoundCopy, endBound);
       }
     }
@@ -1403,7 +1905,8 @@ Stmt LowererImplImperative::lowerForallPosition(Forall forall, Iterator iterator
     else if (forall.getParallelUnit() != ParallelUnit::NotParallel && 
 	     forall.getOutputRaceStrategy() != OutputRaceStrategy::ParallelReduction && 
 	     !ignoreVectorize) {
-      kind = LoopKind::Runtime;
+      kind = (forall.getParallelUnit() == ParallelUnit::CPUTask)
+             ? LoopKind::Tasks : LoopKind::Runtime;
     }
 
     loop = For::make(iterator.getPosVar(), startBound, endBound, 1, loop, kind,
@@ -1525,7 +2028,7 @@ Stmt LowererImplImperative::lowerForallFusedPosition(Forall forall, Iterator ite
   // Code to write results if using temporary and reset temporary
   if (!whereConsumers.empty() && whereConsumers.back().defined()) {
     Expr temp = tensorVars.find(whereTemps.back())->second;
-    Stmt writeResults = Block::make(whereConsumers.back(), ir::Assign::make(temp, ir::Literal::zero(temp.type())));
+    Stmt writeResults = Block::make(whereConsumers.back(), ir::Assign::make(temp, lower(whereTemps.back().getFill())));
     body = Block::make(body, IfThenElse::make(writeResultCond, writeResults));
   }
 
@@ -1567,7 +2070,8 @@ Stmt LowererImplImperative::lowerForallFusedPosition(Forall forall, Iterator ite
   }
   else if (forall.getParallelUnit() != ParallelUnit::NotParallel
            && forall.getOutputRaceStrategy() != OutputRaceStrategy::ParallelReduction && !ignoreVectorize) {
-    kind = LoopKind::Runtime;
+    kind = (forall.getParallelUnit() == ParallelUnit::CPUTask)
+           ? LoopKind::Tasks : LoopKind::Runtime;
   }
   // Loop with preamble and postamble
   return Block::blanks(boundsCompute,
@@ -1703,7 +2207,8 @@ Stmt LowererImplImperative::lowerMergePoint(MergeLattice pointLattice,
 
   // Merge iterator coordinate variables
   bool mergeWithMax;
-  if (mergeStrategy == MergeStrategy::Gallop) {
+  if (mergeStrategy == MergeStrategy::Gallop ||
+      mergeStrategy == MergeStrategy::SimdBlock) {
     mergeWithMax = true;
   } else {
     mergeWithMax = false;
@@ -1921,7 +2426,12 @@ std::vector<ir::Stmt> LowererImplImperative::constructInnerLoopCasePreamble(ir::
   for(auto it : tensorIterators) {
     Access itAccess = iterators.modeAccess(it).getAccess();
     itAccesses.push_back(itAccess);
-    if(it.isLeaf()) {
+    // A value can only be checked once every variable of its access is defined,
+    // which is not the case for operands that are reduced further inside.
+    bool accessDefined = util::all(itAccess.getIndexVars(), [&](const IndexVar& var) {
+      return util::contains(definedIndexVars, var);
+    });
+    if(it.isLeaf() && accessDefined) {
       valueComparisons.push_back(constructCheckForAccessZero(itAccess));
     } else {
       valueComparisons.push_back(Expr());
@@ -1947,6 +2457,9 @@ std::vector<ir::Stmt> LowererImplImperative::constructInnerLoopCasePreamble(ir::
   }
 
   for(size_t i = modeItersWithIndexCases.size(); i < valueComparisons.size(); ++i) {
+    if (!valueComparisons[i].defined()) {
+      continue;
+    }
     Expr caseName = Var::make(itAccesses[i].getTensorVar().getName() + "_isNonZero", taco::Bool);
     Stmt declaration = VarDecl::make(caseName, valueComparisons[i]);
     result.push_back(declaration);
@@ -2124,8 +2637,11 @@ Stmt LowererImplImperative::lowerForallBody(Expr coordinate, IndexStmt stmt,
 
   std::vector<Stmt> stmts;
   
-  // Code to increment iterators when merging by galloping.
-  if (mergeStrategy == MergeStrategy::Gallop && caseLattice.iterators().size() > 1) {
+  // Code to increment iterators when merging by galloping or by comparing
+  // blocks of coordinates.
+  if ((mergeStrategy == MergeStrategy::Gallop ||
+       mergeStrategy == MergeStrategy::SimdBlock) &&
+      caseLattice.iterators().size() > 1) {
     for (auto it : caseLattice.iterators()) {
       Expr ivar = it.getIteratorVar();
       stmts.push_back(compoundAssign(ivar, 1));
@@ -2261,10 +2777,10 @@ vector<Stmt> LowererImplImperative::codeToInitializeDenseAcceleratorArrays(Where
     Stmt inits = Block::make(alreadySetDecl, indexListDecl, allocateAlreadySet, allocateIndexList, zeroInitLoop);
     return {inits, freeTemps};
   } else {
-    Expr sizeOfElt = Sizeof::make(bitGuardType);
-    Expr callocAlreadySet = ir::Call::make("calloc", {bitGuardSize, sizeOfElt}, Int());
-    Stmt allocateAlreadySet = VarDecl::make(alreadySetArr, callocAlreadySet);
-    Stmt inits = Block::make(indexListDecl, allocateIndexList, allocateAlreadySet);
+    Stmt allocateAlreadySet = Allocate::make(alreadySetArr, bitGuardSize, false,
+                                             Expr(), true);
+    Stmt inits = Block::make(alreadySetDecl, indexListDecl, allocateIndexList,
+                             allocateAlreadySet);
     return {inits, freeTemps};
   }
 
@@ -2521,8 +3037,8 @@ Stmt LowererImplImperative::lowerWhere(Where where) {
     if (it->second == where && it->first.getParallelUnit() ==
         ParallelUnit::NotParallel && !isScalar(temporary.getType())) {
       temporaryHoisted = true;
-    } else if (it->second == where && it->first.getParallelUnit() ==
-               ParallelUnit::CPUThread && !isScalar(temporary.getType())) {
+    } else if (it->second == where &&
+               isCPUThreadUnit(it->first.getParallelUnit()) && !isScalar(temporary.getType())) {
       temporaryHoisted = true;
       auto decls = codeToInitializeLocalTemporaryParallel(where, it->first.getParallelUnit());
 
@@ -2547,12 +3063,31 @@ Stmt LowererImplImperative::lowerWhere(Where where) {
 
   Stmt consumer = lower(where.getConsumer());
   if (accelerateDenseWorkSpace && sortAccelerator) {
-    // We need to sort the indices array
+    // We need to sort the indices array.  When the workspace holds few
+    // nonzeros they are sorted, but when it holds many the sorted indices are
+    // recovered by scanning its bit guard instead, which avoids the
+    // comparisons at the cost of a pass over the workspace dimension.
     Expr listOfIndices = tempToIndexList.at(temporary);
     Expr listOfIndicesSize = tempToIndexListSize.at(temporary);
     Expr sizeOfElt = ir::Sizeof::make(listOfIndices.type());
     Stmt sortCall = ir::Sort::make({listOfIndices, listOfIndicesSize, sizeOfElt});
-    consumer = Block::make(sortCall, consumer);
+
+    Expr bitGuard = tempToBitGuard.at(temporary);
+    Expr tempSize = getTemporarySize(where);
+    Expr scanVar = Var::make(temporary.getName() + "_scan_index", Int());
+    Stmt appendIndex = Block::make(
+        Store::make(listOfIndices, listOfIndicesSize, scanVar),
+        Assign::make(listOfIndicesSize, ir::Add::make(listOfIndicesSize, 1)));
+    Stmt scanGuard = Block::make(
+        Assign::make(listOfIndicesSize, ir::Literal::make(0)),
+        For::make(scanVar, 0, tempSize, 1,
+                  IfThenElse::make(Load::make(bitGuard, scanVar),
+                                   appendIndex)));
+    Expr scanIsCheaper = Gte::make(
+        ir::Mul::make(listOfIndicesSize, ir::Literal::make(denseScanRatio)),
+        tempSize);
+    consumer = Block::make(IfThenElse::make(scanIsCheaper, scanGuard, sortCall),
+                           consumer);
   }
 
   // Now that temporary allocations are hoisted, we always need to emit an initialization loop before entering the
@@ -2635,7 +3170,11 @@ Stmt LowererImplImperative::lowerAssemble(Assemble assemble) {
       const bool zeroInit = isNonFullyInitialized(getTensorVar(queryResult)) ||
           util::contains(getResultAccesses(assemble.getQueries()).second, 
                          queryAccess);
-      if (zeroInit) {
+      if (zeroInit && !should_use_CUDA_codegen()) {
+        // Cleared allocations are aligned like all other allocations on CPUs
+        allocStmts.push_back(VarDecl::make(values, 0));
+        allocStmts.push_back(Allocate::make(values, size, false, Expr(), true));
+      } else if (zeroInit) {
         Expr sizeOfElt = Sizeof::make(queryResult.getType().getDataType());
         Expr callocValues = ir::Call::make("calloc", {size, sizeOfElt},
                                            queryResult.getType().getDataType());
@@ -2724,7 +3263,10 @@ Stmt LowererImplImperative::lowerAssemble(Assemble assemble) {
     const bool zeroInit = isNonFullyInitialized(resultTensorVar) ||
                           util::contains(reducedAccesses, resultAccess);
     if (generateAssembleCode()) {
-      if (zeroInit && generateComputeCode()) {
+      if (zeroInit && generateComputeCode() && !should_use_CUDA_codegen()) {
+        initAssembleStmts.push_back(Allocate::make(valuesArr, prevSize, false,
+                                                   Expr(), true));
+      } else if (zeroInit && generateComputeCode()) {
         const auto type = resultTensor.getType().getDataType();
         Expr sizeOfElt = Sizeof::make(type);
         Expr callocValues = ir::Call::make("calloc", {prevSize, sizeOfElt}, 
@@ -2811,7 +3353,7 @@ Expr LowererImplImperative::lowerAccess(Access access) {
     return true;
   }
 
-  return Load::make(vals, generateValueLocExpr(access));
+  return generateValueLoadExpr(var, generateValueLocExpr(access));
 }
 
 Expr LowererImplImperative::lowerIndexVar(IndexVar var) {
@@ -2846,6 +3388,10 @@ Expr LowererImplImperative::lowerLiteral(Literal literal) {
     case Datatype::Int128:
       taco_not_supported_yet;
       break;
+    case Datatype::Float16:
+      return ir::Literal::make(literal.getVal<float16>());
+    case Datatype::BFloat16:
+      return ir::Literal::make(literal.getVal<bfloat16>());
     case Datatype::Float32:
       return ir::Literal::make(literal.getVal<float>());
     case Datatype::Float64:
@@ -3132,6 +3678,15 @@ Stmt LowererImplImperative::initResultArrays(vector<Access> writes,
       }
     }
 
+    if (!generateAssembleCode() &&
+        util::contains(accumulatedResults, write.getTensorVar())) {
+      taco_uassert(util::all(iterators,
+                             [](Iterator it) { return it.hasInsert(); }))
+          << "Masked assignments can only accumulate into results whose "
+          << "modes are all dense";
+      continue;
+    }
+
     if (generateComputeCode() && iterators.back().hasInsert() &&
         !isValue(parentSize, 0) && (isNonFullyInitialized(tensor) || 
         util::contains(reducedAccesses, write))) {
@@ -3142,7 +3697,7 @@ Stmt LowererImplImperative::initResultArrays(vector<Access> writes,
       // iteration of all the iterators is not full. We can check this by seeing if we can recover a
       // full iterator from our set of iterators.
       Expr size = generateAssembleCode() ? getCapacityVar(tensor) : parentSize;
-      result.push_back(initValues(tensor, fill, 0, size));
+      result.push_back(initValues(tensor, fill, 0, size, resultInitLoopKind));
     }
   }
   return result.empty() ? Stmt() : Block::blanks(result);
@@ -3199,7 +3754,7 @@ ir::Stmt LowererImplImperative::finalizeResultArrays(std::vector<Access> writes)
 Stmt LowererImplImperative::defineScalarVariable(TensorVar var, bool zero) {
   Datatype type = var.getType().getDataType();
   Expr varValueIR = Var::make(var.getName() + "_val", type, false, false);
-  Expr init = (zero) ? ir::Literal::zero(type)
+  Expr init = (zero) ? lower(var.getFill())
                      : Load::make(GetProperty::make(tensorVars.at(var),
                                                     TensorProperty::Values));
   tensorVars.find(var)->second = varValueIR;
@@ -3340,7 +3895,8 @@ Stmt LowererImplImperative::resizeAndInitValues(const std::vector<Iterator>& app
 }
 
 
-Stmt LowererImplImperative::initValues(Expr tensor, Expr initVal, Expr begin, Expr size) {
+Stmt LowererImplImperative::initValues(Expr tensor, Expr initVal, Expr begin, Expr size,
+                                       LoopKind parallelKind) {
   Expr lower = simplify(ir::Mul::make(begin, size));
   Expr upper = simplify(ir::Mul::make(ir::Add::make(begin, 1), size));
   Expr p = Var::make("p" + util::toString(tensor), Int());
@@ -3348,7 +3904,7 @@ Stmt LowererImplImperative::initValues(Expr tensor, Expr initVal, Expr begin, Ex
   Stmt zeroInit = Store::make(values, p, initVal);
   LoopKind parallel = (isa<ir::Literal>(size) && 
                        to<ir::Literal>(size)->getIntValue() < (1 << 10))
-                      ? LoopKind::Serial : LoopKind::Static_Chunked;
+                      ? LoopKind::Serial : parallelKind;
   if (should_use_CUDA_codegen() && util::contains(parallelUnitSizes, ParallelUnit::GPUBlock)) {
     return ir::VarDecl::make(ir::Var::make("status", Int()),
                          ir::Call::make("cudaMemset", {values, ir::Literal::make(0, Int()),
@@ -3423,13 +3979,12 @@ Stmt LowererImplImperative::reduceDuplicateCoordinates(Expr coordinate,
     Expr iterVar = iterator.getIteratorVar();
     Expr segendVar = iterator.getSegendVar();
     Expr reducedVal = iterator.isLeaf() ? getReducedValueVar(access) : Expr();
-    Expr tensorVar = getTensorVar(access.getTensorVar());
-    Expr tensorVals = GetProperty::make(tensorVar, TensorProperty::Values);
+    TensorVar tensorVar = access.getTensorVar();
 
     // Initialize variable storing reduced component value.
     if (reducedVal.defined()) {
       Expr reducedValInit = alwaysReduce
-                          ? Load::make(tensorVals, iterVar)
+                          ? generateValueLoadExpr(tensorVar, iterVar)
                           : ir::Literal::zero(reducedVal.type());
       result.push_back(VarDecl::make(reducedVal, reducedValInit));
     }
@@ -3449,7 +4004,7 @@ Stmt LowererImplImperative::reduceDuplicateCoordinates(Expr coordinate,
 
     vector<Stmt> dedupStmts;
     if (reducedVal.defined()) {
-      Expr partialVal = Load::make(tensorVals, segendVar);
+      Expr partialVal = generateValueLoadExpr(tensorVar, segendVar);
       dedupStmts.push_back(compoundAssign(reducedVal, partialVal));
     }
     dedupStmts.push_back(compoundAssign(segendVar, 1));
@@ -3639,7 +4194,8 @@ Stmt LowererImplImperative::codeToIncIteratorVars(Expr coordinate, IndexVar coor
       if (iterator.isFull()) {
         Expr increment = 1;
         result.push_back(compoundAssign(ivar, increment));
-      } else if (strategy == MergeStrategy::Gallop) {
+      } else if (strategy == MergeStrategy::Gallop ||
+                 strategy == MergeStrategy::SimdBlock) {
         Expr iteratorParentPos = iterator.getParent().getPosVar();
         ModeFunction iterBounds = iterator.posBounds(iteratorParentPos);
         result.push_back(iterBounds.compute());
@@ -3648,7 +4204,9 @@ Stmt LowererImplImperative::codeToIncIteratorVars(Expr coordinate, IndexVar coor
           ivar, iterBounds[1],
           coordinate,
         };
-        result.push_back(ir::Assign::make(ivar, ir::Call::make("taco_gallop", gallopArgs, ivar.type())));
+        string advance = (strategy == MergeStrategy::Gallop)
+                         ? "taco_gallop" : "taco_simd_advance";
+        result.push_back(ir::Assign::make(ivar, ir::Call::make(advance, gallopArgs, ivar.type())));
       } else { // strategy == MergeStrategy::TwoFinger
         Expr increment = ir::Cast::make(Eq::make(iterator.getCoordVar(), coordinate), ivar.type());
         result.push_back(compoundAssign(ivar, increment));
@@ -3835,6 +4393,33 @@ Expr LowererImplImperative::generateValueLocExpr(Access access) const {
 }
 
 
+Expr LowererImplImperative::generateValueLoadExpr(TensorVar var,
+                                                  Expr loc) const {
+  const ValueEncoding encoding = var.getFormat().getValueEncoding();
+  if (encoding == ValueEncoding::Plain || util::contains(temporaryArrays, var)) {
+    return Load::make(getValuesArray(var), loc);
+  }
+
+  const Datatype ctype = var.getType().getDataType();
+  Expr tensor = getTensorVar(var);
+  switch (encoding) {
+    case ValueEncoding::Pattern:
+      return ir::Literal::make(TypedComponentVal(ctype, 1), ctype);
+    case ValueEncoding::Dictionary8:
+    case ValueEncoding::Dictionary16: {
+      Expr codes = GetProperty::make(tensor, TensorProperty::Values,
+                                     getValueCodeType(encoding, ctype));
+      Expr dictionary = GetProperty::make(tensor,
+                                          TensorProperty::ValueDictionary);
+      return Load::make(dictionary, Load::make(codes, loc));
+    }
+    default:
+      taco_not_supported_yet;
+      return Expr();
+  }
+}
+
+
 Expr LowererImplImperative::checkThatNoneAreExhausted(std::vector<Iterator> iterators)
 {
   taco_iassert(!iterators.empty());
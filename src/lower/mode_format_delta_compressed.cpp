@@ -0,0 +1,120 @@
+#include "taco/lower/mode_format_delta_compressed.h"
+
+#include "taco/ir/ir_generators.h"
+#include "taco/ir/simplify.h"
+#include "taco/util/strings.h"
+
+using namespace std;
+using namespace taco::ir;
+
+namespace taco {
+
+DeltaCompressedModeFormat::DeltaCompressedModeFormat() :
+    DeltaCompressedModeFormat(false, true, true, false) {
+}
+
+DeltaCompressedModeFormat::DeltaCompressedModeFormat(bool isFull,
+                                                     bool isOrdered,
+                                                     bool isUnique,
+                                                     bool isZeroless) :
+    ModeFormatImpl("delta_compressed", isFull, isOrdered, isUnique, false,
+                   true, isZeroless, false, false, true, false, false, false,
+                   false, false, false) {
+}
+
+ModeFormat DeltaCompressedModeFormat::copy(
+    vector<ModeFormat::Property> properties) const {
+  bool isFull = this->isFull;
+  bool isOrdered = this->isOrdered;
+  bool isUnique = this->isUnique;
+  bool isZeroless = this->isZeroless;
+  for (const auto property : properties) {
+    switch (property) {
+      case ModeFormat::FULL:
+        isFull = true;
+        break;
+      case ModeFormat::NOT_FULL:
+        isFull = false;
+        break;
+      case ModeFormat::ORDERED:
+        isOrdered = true;
+        break;
+      case ModeFormat::NOT_ORDERED:
+        isOrdered = false;
+        break;
+      case ModeFormat::UNIQUE:
+        isUnique = true;
+        break;
+      case ModeFormat::NOT_UNIQUE:
+        isUnique = false;
+        break;
+      case ModeFormat::ZEROLESS:
+        isZeroless = true;
+        break;
+      case ModeFormat::NOT_ZEROLESS:
+        isZeroless = false;
+        break;
+      default:
+        break;
+    }
+  }
+  const auto deltaCompressedVariant =
+      std::make_shared<DeltaCompressedModeFormat>(isFull, isOrdered, isUnique,
+                                                  isZeroless);
+  return ModeFormat(deltaCompressedVariant);
+}
+
+ModeFunction DeltaCompressedModeFormat::posIterBounds(Expr parentPos,
+                                                      Mode mode) const {
+  Expr pbegin = Load::make(getPosArray(mode.getModePack()), parentPos);
+  Expr pend = Load::make(getPosArray(mode.getModePack()),
+                         ir::Add::make(parentPos, 1));
+  return ModeFunction(Stmt(), {pbegin, pend});
+}
+
+ModeFunction DeltaCompressedModeFormat::coordBounds(Expr parentPos,
+                                                    Mode mode) const {
+  Expr pend = Load::make(getPosArray(mode.getModePack()),
+                         ir::Add::make(parentPos, 1));
+  Expr coordend = unpackCoord(ir::Sub::make(pend, 1), mode);
+  return ModeFunction(Stmt(), {0, coordend});
+}
+
+ModeFunction DeltaCompressedModeFormat::posIterAccess(ir::Expr pos,
+    std::vector<ir::Expr> coords, Mode mode) const {
+  taco_iassert(mode.getPackLocation() == 0);
+  taco_uassert(mode.getModePack().getNumModes() == 1) <<
+      "Delta compressed levels cannot share storage with other levels";
+  return ModeFunction(Stmt(), {unpackCoord(pos, mode), true});
+}
+
+vector<Expr> DeltaCompressedModeFormat::getArrays(Expr tensor, int mode,
+                                                  int level) const {
+  std::string arraysName = util::toString(tensor) + std::to_string(level);
+  return {GetProperty::make(tensor, TensorProperty::Indices,
+                            level - 1, 0, arraysName + "_pos"),
+          GetProperty::make(tensor, TensorProperty::Indices,
+                            level - 1, 1, arraysName + "_crd"),
+          GetProperty::make(tensor, TensorProperty::Indices,
+                            level - 1, 2, arraysName + "_crd_hdr")};
+}
+
+Expr DeltaCompressedModeFormat::getPosArray(ModePack pack) const {
+  return pack.getArray(0);
+}
+
+Expr DeltaCompressedModeFormat::getCoordArray(ModePack pack) const {
+  return pack.getArray(1);
+}
+
+Expr DeltaCompressedModeFormat::getCoordHeaderArray(ModePack pack) const {
+  return pack.getArray(2);
+}
+
+Expr DeltaCompressedModeFormat::unpackCoord(Expr pos, Mode mode) const {
+  return ir::Call::make("taco_unpack_crd",
+                        {getCoordHeaderArray(mode.getModePack()),
+                         getCoordArray(mode.getModePack()), pos}, Int());
+}
+
+}
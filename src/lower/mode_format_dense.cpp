@@ -60,7 +60,7 @@ Stmt DenseModeFormat::getInsertCoord(Expr p,
 }
 
 Expr DenseModeFormat::getWidth(Mode mode) const {
-  return (mode.getSize().isFixed() && mode.getSize().getSize() < 16) ?
+  return mode.getSize().isFixed() ?
          (int)mode.getSize().getSize() : 
          getSizeArray(mode.getModePack());
 }
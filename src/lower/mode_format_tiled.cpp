@@ -0,0 +1,141 @@
+#include "taco/lower/mode_format_tiled.h"
+
+#include "taco/error.h"
+
+using namespace std;
+using namespace taco::ir;
+
+namespace taco {
+
+TiledModeFormat::TiledModeFormat(int tileSize, int tileVolume)
+    : TiledModeFormat(tileSize, tileVolume, true, true, false) {
+}
+
+TiledModeFormat::TiledModeFormat(int tileSize, int tileVolume,
+                                 const bool isOrdered, const bool isUnique,
+                                 const bool isZeroless) :
+    ModeFormatImpl("tiled", true, isOrdered, isUnique, false, true, isZeroless,
+                   true, false, false, true, true, false, false, false, true),
+    tileSize(tileSize), tileVolume(tileVolume) {
+  taco_uassert(tileSize > 0) << "Tile sizes must be positive";
+  taco_iassert(tileVolume > 0);
+}
+
+ModeFormat TiledModeFormat::copy(
+    std::vector<ModeFormat::Property> properties) const {
+  bool isOrdered = this->isOrdered;
+  bool isUnique = this->isUnique;
+  bool isZeroless = this->isZeroless;
+  for (const auto property : properties) {
+    switch (property) {
+      case ModeFormat::ORDERED:
+        isOrdered = true;
+        break;
+      case ModeFormat::NOT_ORDERED:
+        isOrdered = false;
+        break;
+      case ModeFormat::UNIQUE:
+        isUnique = true;
+        break;
+      case ModeFormat::NOT_UNIQUE:
+        isUnique = false;
+        break;
+      case ModeFormat::ZEROLESS:
+        isZeroless = true;
+        break;
+      case ModeFormat::NOT_ZEROLESS:
+        isZeroless = false;
+        break;
+      default:
+        break;
+    }
+  }
+  return ModeFormat(std::make_shared<TiledModeFormat>(tileSize, tileVolume,
+                                                      isOrdered, isUnique,
+                                                      isZeroless));
+}
+
+ModeFunction TiledModeFormat::locate(ir::Expr parentPos,
+                                     std::vector<ir::Expr> coords,
+                                     Mode mode) const {
+  // The parent position is tile * tileVolume + offset, where tile indexes the
+  // tiles of the ancestor levels and offset indexes the components of a tile.
+  Expr coord = coords.back();
+  Expr numTiles = ir::Div::make(getWidth(mode), tileSize);
+  Expr parentTile = (tileVolume == 1)
+                    ? parentPos : ir::Div::make(parentPos, tileVolume);
+  Expr tile = ir::Add::make(ir::Mul::make(parentTile, numTiles),
+                            ir::Div::make(coord, tileSize));
+  Expr offset = ir::Rem::make(coord, tileSize);
+  if (tileVolume > 1) {
+    Expr parentOffset = ir::Rem::make(parentPos, tileVolume);
+    offset = ir::Add::make(ir::Mul::make(parentOffset, tileSize), offset);
+  }
+  Expr pos = ir::Add::make(ir::Mul::make(tile, tileVolume * tileSize), offset);
+  return ModeFunction(Stmt(), {pos, true});
+}
+
+Stmt TiledModeFormat::getInsertCoord(Expr p,
+    const std::vector<Expr>& i, Mode mode) const {
+  return Stmt();
+}
+
+Expr TiledModeFormat::getWidth(Mode mode) const {
+  // Levels are padded to a whole number of tiles.
+  if (mode.getSize().isFixed()) {
+    const int size = (int)mode.getSize().getSize();
+    return ((size + tileSize - 1) / tileSize) * tileSize;
+  }
+  Expr size = getSizeArray(mode.getModePack());
+  return ir::Mul::make(ir::Div::make(ir::Add::make(size, tileSize - 1),
+                                     tileSize), tileSize);
+}
+
+Stmt TiledModeFormat::getInsertInitCoords(Expr pBegin,
+    Expr pEnd, Mode mode) const {
+  return Stmt();
+}
+
+Stmt TiledModeFormat::getInsertInitLevel(Expr szPrev, Expr sz,
+    Mode mode) const {
+  return Stmt();
+}
+
+Stmt TiledModeFormat::getInsertFinalizeLevel(Expr szPrev,
+    Expr sz, Mode mode) const {
+  return Stmt();
+}
+
+Expr TiledModeFormat::getAssembledSize(Expr prevSize, Mode mode) const {
+  return ir::Mul::make(prevSize, getWidth(mode));
+}
+
+ModeFunction TiledModeFormat::getYieldPos(Expr parentPos,
+    std::vector<Expr> coords, Mode mode) const {
+  return locate(parentPos, coords, mode);
+}
+
+vector<Expr> TiledModeFormat::getArrays(Expr tensor, int mode,
+                                        int level) const {
+  return {GetProperty::make(tensor, TensorProperty::Dimension, mode)};
+}
+
+int TiledModeFormat::getTileSize() const {
+  return tileSize;
+}
+
+int TiledModeFormat::getTileVolume() const {
+  return tileVolume;
+}
+
+bool TiledModeFormat::equals(const ModeFormatImpl& other) const {
+  auto tiled = dynamic_cast<const TiledModeFormat*>(&other);
+  return ModeFormatImpl::equals(other) && tiled != nullptr &&
+         tiled->tileSize == tileSize && tiled->tileVolume == tileVolume;
+}
+
+Expr TiledModeFormat::getSizeArray(ModePack pack) const {
+  return pack.getArray(0);
+}
+
+}
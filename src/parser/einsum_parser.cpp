@@ -12,7 +12,8 @@ namespace parser{
 EinsumParser::EinsumParser(const std::string &expression,
                            std::vector<TensorBase> &tensors,
                            Format &format,
-                           Datatype outType) : outType(outType), format(format), tensors(tensors) {
+                           Datatype outType,
+                           bool optimize) : outType(outType), format(format), optimize(optimize), tensors(tensors) {
 
   einsumSymbols = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
   einSumSymbolsSet = std::set<char>(einsumSymbols.begin(), einsumSymbols.end());
@@ -184,6 +185,7 @@ void EinsumParser::buildResult(std::vector<std::string> subs){
   }
 
   resultTensor = TensorBase(outType, outShape, format);
+  resultTensor.setAutomaticContractionOrdering(optimize);
   resultTensor(vars) = expr;
 }
 
@@ -1,7 +1,12 @@
 #include "taco/storage/array.h"
 
+#include <algorithm>
+#include <cstdlib>
 #include <cstring>
 #include <iostream>
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
 
 #include "taco/type.h"
 #include "taco/error.h"
@@ -13,10 +18,18 @@ using namespace std;
 
 namespace taco {
 
+// The alignment of arrays, and the size of the huge pages that large arrays
+// are aligned to.  These must match TACO_ALIGNMENT and TACO_HUGE_PAGE_SIZE of
+// the generated code.
+static const size_t ALIGNMENT = 64;
+static const size_t HUGE_PAGE_SIZE = 2 << 20;
+
+static ArrayAllocator arrayAllocator = allocateAligned;
+
 struct Array::Content : util::Uncopyable {
   Datatype   type;
-  void*  data;
-  size_t size;
+  void*  data = nullptr;
+  size_t size = 0;
   Policy policy = Array::UserOwns;
 
   ~Content() {
@@ -67,6 +80,12 @@ struct Array::Content : util::Uncopyable {
           case Datatype::Int128:
             delete[] ((long long*)data);
             break;
+          case Datatype::Float16:
+            delete[] ((float16*)data);
+            break;
+          case Datatype::BFloat16:
+            delete[] ((bfloat16*)data);
+            break;
           case Datatype::Float32:
             delete[] ((float*)data);
             break;
@@ -175,6 +194,12 @@ std::ostream& operator<<(std::ostream& os, const Array& array) {
     case Datatype::Int128:
       printData<long long>(os, array);
       break;
+    case Datatype::Float16:
+      printData<float16>(os, array);
+      break;
+    case Datatype::BFloat16:
+      printData<bfloat16>(os, array);
+      break;
     case Datatype::Float32:
       printData<float>(os, array);
       break;
@@ -214,8 +239,28 @@ Array makeArray(Datatype type, size_t size) {
     return Array(type, cuda_unified_alloc(size * type.getNumBytes()), size, Array::Free);
   }
   else {
-    return Array(type, malloc(size * type.getNumBytes()), size, Array::Free);
+    return Array(type, arrayAllocator(size * type.getNumBytes()), size, Array::Free);
   }
 }
 
+void* allocateAligned(size_t bytes) {
+  const size_t alignment = (bytes >= 2 * HUGE_PAGE_SIZE) ? HUGE_PAGE_SIZE
+                                                         : ALIGNMENT;
+  void* data = nullptr;
+  if (posix_memalign(&data, alignment, std::max(bytes, (size_t)1)) != 0) {
+    return nullptr;
+  }
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  if (alignment == HUGE_PAGE_SIZE) {
+    madvise(data, bytes / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE, MADV_HUGEPAGE);
+  }
+#endif
+  return data;
+}
+
+void setArrayAllocator(ArrayAllocator allocator) {
+  taco_uassert(allocator != nullptr) << "The array allocator must be defined";
+  arrayAllocator = allocator;
+}
+
 }
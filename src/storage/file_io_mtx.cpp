@@ -292,6 +292,8 @@ void writeSparse(std::ostream& stream, const TensorBase& tensor) {
     case Datatype::Int32: writeSparseTyped<int32_t>(stream, tensor); break;
     case Datatype::Int64: writeSparseTyped<int64_t>(stream, tensor); break;
     case Datatype::Int128: writeSparseTyped<long long>(stream, tensor); break;
+    case Datatype::Float16: writeSparseTyped<float16>(stream, tensor); break;
+    case Datatype::BFloat16: writeSparseTyped<bfloat16>(stream, tensor); break;
     case Datatype::Float32: writeSparseTyped<float>(stream, tensor); break;
     case Datatype::Float64: writeSparseTyped<double>(stream, tensor); break;
     case Datatype::Complex64: writeSparseTyped<std::complex<float>>(stream, tensor); break;
@@ -342,6 +344,8 @@ void writeDense(std::ostream& stream, const TensorBase& tensor) {
     case Datatype::Int32: writeDenseTyped<int32_t>(stream, tensor); break;
     case Datatype::Int64: writeDenseTyped<int64_t>(stream, tensor); break;
     case Datatype::Int128: writeDenseTyped<long long>(stream, tensor); break;
+    case Datatype::Float16: writeDenseTyped<float16>(stream, tensor); break;
+    case Datatype::BFloat16: writeDenseTyped<bfloat16>(stream, tensor); break;
     case Datatype::Float32: writeDenseTyped<float>(stream, tensor); break;
     case Datatype::Float64: writeDenseTyped<double>(stream, tensor); break;
     case Datatype::Complex64: writeDenseTyped<std::complex<float>>(stream, tensor); break;
@@ -401,6 +401,8 @@ void writeRB(std::ostream& stream, const TensorBase& tensor) {
     case Datatype::Int32: writeRBTyped<int32_t>(stream, tensor); break;
     case Datatype::Int64: writeRBTyped<int64_t>(stream, tensor); break;
 //    case Datatype::Int128: writeRBTyped<long long>(stream, tensor); break;
+    case Datatype::Float16: writeRBTyped<float16>(stream, tensor); break;
+    case Datatype::BFloat16: writeRBTyped<bfloat16>(stream, tensor); break;
     case Datatype::Float32: writeRBTyped<float>(stream, tensor); break;
     case Datatype::Float64: writeRBTyped<double>(stream, tensor); break;
 //    case Datatype::Complex64: writeRBTyped<std::complex<float>>(stream, tensor); break;
@@ -57,7 +57,12 @@ size_t Index::getSize() const {
     auto modeIndex = getModeIndex(i);
     if (modeType.getName() == Dense.getName()) {
       size *= modeIndex.getIndexArray(0).get(0).getAsIndex();
-    } else if (modeType.getName() == Sparse.getName()) {
+    } else if (isTiled(modeType)) {
+      const size_t tileSize = getTileSize(modeType);
+      const size_t dimension = modeIndex.getIndexArray(0).get(0).getAsIndex();
+      size *= (dimension + tileSize - 1) / tileSize * tileSize;
+    } else if (modeType.getName() == Sparse.getName() ||
+               modeType.getName() == DeltaCompressed.getName()) {
       size = modeIndex.getIndexArray(0).get(size).getAsIndex();
     } else {
       taco_not_supported_yet;
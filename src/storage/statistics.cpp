@@ -0,0 +1,141 @@
+#include "taco/storage/statistics.h"
+
+#include <algorithm>
+
+#include "taco/error.h"
+#include "taco/util/strings.h"
+
+using namespace std;
+
+namespace taco {
+
+TensorStatistics::TensorStatistics() : isDefined(false) {
+}
+
+TensorStatistics::TensorStatistics(const vector<int>& dimensions,
+                                   const vector<int>& modeOrdering,
+                                   const char* coordinates,
+                                   size_t numCoordinates, size_t stride)
+    : dimensions(dimensions), modeOrdering(modeOrdering), isDefined(true) {
+  const int order = (int)dimensions.size();
+  taco_iassert(modeOrdering.size() == dimensions.size());
+
+  vector<vector<size_t>> sliceNonzeros(order);
+  for (int i = 0; i < order; ++i) {
+    sliceNonzeros[i] = vector<size_t>(dimensions[i], 0);
+  }
+  numFibers = vector<size_t>(order, 0);
+
+  const int* prev = nullptr;
+  for (size_t k = 0; k < numCoordinates; ++k) {
+    const int* coord = (const int*)&coordinates[k * stride];
+
+    // Find the first level at which the coordinate differs from its
+    // predecessor. Every level from there on starts a new fiber.
+    int level = 0;
+    if (prev != nullptr) {
+      while (level < order && coord[level] == prev[level]) {
+        level++;
+      }
+    }
+    prev = coord;
+    if (level == order) {
+      continue;
+    }
+    for (int l = level; l < order; ++l) {
+      numFibers[l]++;
+    }
+    for (int l = 0; l < order; ++l) {
+      // Compressed levels do not bound their coordinates by the dimension
+      // (index sets, for instance, store arbitrary coordinates), so count
+      // slices past the end too.
+      vector<size_t>& counts = sliceNonzeros[modeOrdering[l]];
+      if (coord[l] < 0) {
+        continue;
+      }
+      if ((size_t)coord[l] >= counts.size()) {
+        counts.resize(coord[l] + 1, 0);
+      }
+      counts[coord[l]]++;
+    }
+  }
+
+  numNonEmptySlices = vector<size_t>(order, 0);
+  maxSliceNonzeros = vector<size_t>(order, 0);
+  for (int i = 0; i < order; ++i) {
+    for (size_t nnz : sliceNonzeros[i]) {
+      if (nnz > 0) {
+        numNonEmptySlices[i]++;
+      }
+      maxSliceNonzeros[i] = max(maxSliceNonzeros[i], nnz);
+    }
+  }
+}
+
+bool TensorStatistics::defined() const {
+  return isDefined;
+}
+
+int TensorStatistics::getOrder() const {
+  return (int)dimensions.size();
+}
+
+int TensorStatistics::getDimension(int mode) const {
+  taco_iassert(mode < getOrder());
+  return dimensions[mode];
+}
+
+size_t TensorStatistics::getNumNonzeros() const {
+  return (getOrder() > 0) ? numFibers.back() : 0;
+}
+
+size_t TensorStatistics::getNumNonEmptySlices(int mode) const {
+  taco_iassert(mode < getOrder());
+  return numNonEmptySlices[mode];
+}
+
+double TensorStatistics::getEmptySliceFraction(int mode) const {
+  taco_iassert(mode < getOrder());
+  if (dimensions[mode] == 0) {
+    return 0.0;
+  }
+  return max(0.0, 1.0 - (double)numNonEmptySlices[mode] / dimensions[mode]);
+}
+
+size_t TensorStatistics::getMaxSliceNonzeros(int mode) const {
+  taco_iassert(mode < getOrder());
+  return maxSliceNonzeros[mode];
+}
+
+const vector<int>& TensorStatistics::getModeOrdering() const {
+  return modeOrdering;
+}
+
+size_t TensorStatistics::getNumFibers(int level) const {
+  taco_iassert(level < getOrder());
+  return numFibers[level];
+}
+
+double TensorStatistics::getLevelDensity(int level) const {
+  taco_iassert(level < getOrder());
+  const size_t parentFibers = (level == 0) ? 1 : numFibers[level - 1];
+  const double size = (double)parentFibers * dimensions[modeOrdering[level]];
+  return (size > 0) ? numFibers[level] / size : 0.0;
+}
+
+std::ostream& operator<<(std::ostream& os, const TensorStatistics& stats) {
+  if (!stats.defined()) {
+    return os << "undefined";
+  }
+  vector<double> emptySliceFractions;
+  vector<double> levelDensities;
+  for (int i = 0; i < stats.getOrder(); ++i) {
+    emptySliceFractions.push_back(stats.getEmptySliceFraction(i));
+    levelDensities.push_back(stats.getLevelDensity(i));
+  }
+  return os << "nnz: " << stats.getNumNonzeros()
+            << ", empty slices: (" << util::join(emptySliceFractions) << ")"
+            << ", level densities: (" << util::join(levelDensities) << ")";
+}
+
+}
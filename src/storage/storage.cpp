@@ -3,12 +3,16 @@
 #include <iostream>
 #include <string>
 #include <climits>
+#include <cstring>
+#include <unordered_map>
+#include <algorithm>
 
 #include "taco/type.h"
 #include "taco/format.h"
 #include "taco/error.h"
 #include "taco/storage/index.h"
 #include "taco/storage/array.h"
+#include "taco/lower/mode_format_delta_compressed.h"
 #include "taco/util/strings.h"
 #include "taco/index_notation/index_notation.h"
 
@@ -26,6 +30,7 @@ struct TensorStorage::Content {
 
   Index         index;
   Array         values;
+  Array         valueDictionary;
 
   Literal       fillValue;
 
@@ -46,12 +51,14 @@ struct TensorStorage::Content {
       dimensionsInt32[i] = dimensions[i];
       modeOrdering[i] = format.getModeOrdering()[i];
       auto modeType  = format.getModeFormats()[i];
-      if (modeType.getName() == Dense.getName()) {
+      if (modeType.getName() == Dense.getName() || isTiled(modeType)) {
         modeTypes[i] = taco_mode_dense;
       } else if (modeType.getName() == Sparse.getName()) {
         modeTypes[i] = taco_mode_sparse;
       } else if (modeType.getName() == Singleton.getName()) {
         modeTypes[i] = taco_mode_sparse;
+      } else if (modeType.getName() == DeltaCompressed.getName()) {
+        modeTypes[i] = taco_mode_sparse;
       } else {
         taco_not_supported_yet;
       }
@@ -105,6 +112,10 @@ Array TensorStorage::getValues() {
   return content->values;
 }
 
+const Array& TensorStorage::getValueDictionary() const {
+  return content->valueDictionary;
+}
+
 Literal TensorStorage::getFillValue() {
   return content->fillValue;
 }
@@ -121,7 +132,13 @@ size_t TensorStorage::getSizeInBytes() {
     }
   }
   const auto& values = getValues();
-  return indexSizeInBytes + values.getSize() * values.getType().getNumBytes();
+  size_t valuesSizeInBytes = values.getSize() * values.getType().getNumBytes();
+  const auto& dictionary = getValueDictionary();
+  if (dictionary.getSize() > 0) {
+    valuesSizeInBytes += dictionary.getSize() *
+                         dictionary.getType().getNumBytes();
+  }
+  return indexSizeInBytes + valuesSizeInBytes;
 }
 
 TensorStorage::operator struct taco_tensor_t*() const {
@@ -137,7 +154,7 @@ TensorStorage::operator struct taco_tensor_t*() const {
     auto modeIndex = index.getModeIndex(i);
 
     // Dense modes don't have indices (they iterate over mode sizes)
-    if (modeType.getName() == Dense.getName()) {
+    if (modeType.getName() == Dense.getName() || isTiled(modeType)) {
       // TODO Uncomment assertion and remove code in this conditional
       // taco_iassert(modeIndex.numIndexArrays() == 0)
       //     << modeIndex.numIndexArrays();
@@ -156,6 +173,17 @@ TensorStorage::operator struct taco_tensor_t*() const {
         tensorData->indices[i][1] = (uint8_t*)idx.getData();
       }
     }
+    // Delta compressed levels have three indices (pos, crd and crd header)
+    else if (modeType.getName() == DeltaCompressed.getName()) {
+      if (modeIndex.numIndexArrays() > 0) {
+        taco_iassert(modeIndex.numIndexArrays() == 3)
+            << modeIndex.numIndexArrays();
+        for (int j = 0; j < 3; ++j) {
+          const Array& indexArray = modeIndex.getIndexArray(j);
+          tensorData->indices[i][j] = (uint8_t*)indexArray.getData();
+        }
+      }
+    }
     else if (modeType.getName() == Singleton.getName()) {
       // TODO Uncomment assert and remove conditional
       // taco_iassert(modeIndex.numIndexArrays() == 2)
@@ -171,6 +199,7 @@ TensorStorage::operator struct taco_tensor_t*() const {
   }
 
   tensorData->vals  = (uint8_t*)getValues().getData();
+  tensorData->vals_dict = (uint8_t*)getValueDictionary().getData();
   tensorData->fill_value = (uint8_t*) content->fillValue.getValPtr();
 
   return content->tensorData;
@@ -184,6 +213,141 @@ void TensorStorage::setValues(const Array& values) {
   content->values = values;
 }
 
+void TensorStorage::setValueDictionary(const Array& dictionary) {
+  content->valueDictionary = dictionary;
+}
+
+template <typename CodeType>
+static Array encodeDictionaryValues(const Array& values, size_t capacity,
+                                    Array* dictionary) {
+  const size_t csize = values.getType().getNumBytes();
+  const char* vals = (const char*)values.getData();
+
+  // Assign codes to distinct values in order of first occurrence.
+  Array codes = makeArray(type<CodeType>(), values.getSize());
+  CodeType* codesData = (CodeType*)codes.getData();
+  std::unordered_map<string,CodeType> valueCodes;
+  vector<size_t> firstOccurrences;
+  for (size_t i = 0; i < values.getSize(); ++i) {
+    const string value(&vals[i * csize], csize);
+    auto it = valueCodes.find(value);
+    if (it == valueCodes.end()) {
+      taco_uassert(valueCodes.size() < capacity) <<
+          "Tensor has more than " << capacity << " distinct values, which " <<
+          "cannot be dictionary-encoded with " << type<CodeType>() << " codes";
+      it = valueCodes.insert({value, (CodeType)valueCodes.size()}).first;
+      firstOccurrences.push_back(i);
+    }
+    codesData[i] = it->second;
+  }
+
+  *dictionary = makeArray(values.getType(), firstOccurrences.size());
+  char* dictionaryData = (char*)dictionary->getData();
+  for (size_t i = 0; i < firstOccurrences.size(); ++i) {
+    memcpy(&dictionaryData[i * csize], &vals[firstOccurrences[i] * csize],
+           csize);
+  }
+  return codes;
+}
+
+/// Delta encode and bit pack the coordinates of a compressed level.  Each
+/// coordinate is stored as the offset from the smallest coordinate of its
+/// block, using the smallest bit width that fits every offset of the level.
+static ModeIndex encodeDeltaCompressedLevel(const ModeIndex& modeIndex) {
+  const int blockSize = DeltaCompressedModeFormat::BlockSize;
+  const Array& pos = modeIndex.getIndexArray(0);
+  const Array& crd = modeIndex.getIndexArray(1);
+  taco_iassert(crd.getType() == Int32);
+  const int32_t* crdData = (const int32_t*)crd.getData();
+  const size_t size = crd.getSize();
+  const size_t numBlocks = (size + blockSize - 1) / blockSize;
+
+  Array header = makeArray(Int32, numBlocks + 1);
+  int32_t* headerData = (int32_t*)header.getData();
+  uint32_t maxOffset = 0;
+  for (size_t b = 0; b < numBlocks; ++b) {
+    const size_t end = std::min(size, (b + 1) * blockSize);
+    int32_t base = crdData[b * blockSize];
+    for (size_t p = b * blockSize; p < end; ++p) {
+      base = std::min(base, crdData[p]);
+    }
+    for (size_t p = b * blockSize; p < end; ++p) {
+      maxOffset = std::max(maxOffset, (uint32_t)(crdData[p] - base));
+    }
+    headerData[b + 1] = base;
+  }
+  uint32_t width = 0;
+  while (width < 32 && (maxOffset >> width) != 0) {
+    width++;
+  }
+  headerData[0] = (int32_t)width;
+
+  // Pad with an extra word so that decoding can always read two words.
+  const size_t numWords = (size * width + 31) / 32 + 1;
+  Array words = makeArray(UInt32, numWords);
+  words.zero();
+  uint32_t* wordsData = (uint32_t*)words.getData();
+  for (size_t p = 0; p < size; ++p) {
+    const uint64_t offset = (uint32_t)(crdData[p] - headerData[1 + p / blockSize]);
+    const uint64_t bit = (uint64_t)p * width;
+    const uint64_t chunk = offset << (bit & 31);
+    wordsData[bit >> 5] |= (uint32_t)chunk;
+    wordsData[(bit >> 5) + 1] |= (uint32_t)(chunk >> 32);
+  }
+  return ModeIndex({pos, words, header});
+}
+
+void encodeCoordinates(TensorStorage storage) {
+  const Format& format = storage.getFormat();
+  Index index = storage.getIndex();
+  vector<ModeIndex> modeIndices;
+  bool encoded = false;
+  for (int i = 0; i < format.getOrder(); ++i) {
+    ModeIndex modeIndex = index.getModeIndex(i);
+    if (format.getModeFormats()[i].getName() == DeltaCompressed.getName() &&
+        modeIndex.numIndexArrays() == 2) {
+      modeIndex = encodeDeltaCompressedLevel(modeIndex);
+      encoded = true;
+    }
+    modeIndices.push_back(modeIndex);
+  }
+  if (encoded) {
+    storage.setIndex(Index(format, modeIndices));
+  }
+}
+
+void encodeValues(TensorStorage storage) {
+  const ValueEncoding encoding = storage.getFormat().getValueEncoding();
+  const Array values = storage.getValues();
+  taco_iassert(values.getType() == storage.getComponentType());
+
+  switch (encoding) {
+    case ValueEncoding::Plain:
+      break;
+    case ValueEncoding::Pattern:
+      for (size_t i = 0; i < values.getSize(); ++i) {
+        taco_uassert(TypedComponentVal(values.get(i)) == 1) <<
+            "Tensors with a pattern value encoding may only store ones";
+      }
+      storage.setValues(Array(values.getType(), nullptr, 0));
+      break;
+    case ValueEncoding::Dictionary8: {
+      Array dictionary;
+      storage.setValues(encodeDictionaryValues<uint8_t>(values,
+          getValueDictionaryCapacity(encoding), &dictionary));
+      storage.setValueDictionary(dictionary);
+      break;
+    }
+    case ValueEncoding::Dictionary16: {
+      Array dictionary;
+      storage.setValues(encodeDictionaryValues<uint16_t>(values,
+          getValueDictionaryCapacity(encoding), &dictionary));
+      storage.setValueDictionary(dictionary);
+      break;
+    }
+  }
+}
+
 bool equals(TensorStorage a, TensorStorage b) {
   return false;
 }
@@ -23,6 +23,8 @@ size_t TypedComponent::getAsIndex(const ComponentTypeUnion &mem) const {
     case Datatype::Int32: return (size_t) mem.int32Value;
     case Datatype::Int64: return (size_t) mem.int64Value;
     case Datatype::Int128: return (size_t) mem.int128Value;
+    case Datatype::Float16: return (size_t) mem.float16Value;
+    case Datatype::BFloat16: return (size_t) mem.bfloat16Value;
     case Datatype::Float32: return (size_t) mem.float32Value;
     case Datatype::Float64: return (size_t) mem.float64Value;
     case Datatype::Complex64: taco_ierror; return 0;
@@ -46,6 +48,8 @@ void TypedComponent::set(ComponentTypeUnion& mem, const ComponentTypeUnion& valu
     case Datatype::Int32: mem.int32Value = value.int32Value; break;
     case Datatype::Int64: mem.int64Value = value.int64Value; break;
     case Datatype::Int128: mem.int128Value = value.int128Value; break;
+    case Datatype::Float16: mem.float16Value = value.float16Value; break;
+    case Datatype::BFloat16: mem.bfloat16Value = value.bfloat16Value; break;
     case Datatype::Float32: mem.float32Value = value.float32Value; break;
     case Datatype::Float64: mem.float64Value = value.float64Value; break;
     case Datatype::Complex64:  mem.complex64Value = value.complex64Value;; break;
@@ -67,6 +71,8 @@ void TypedComponent::setInt(ComponentTypeUnion& mem, const int value) {
     case Datatype::Int32: mem.int32Value = value; break;
     case Datatype::Int64: mem.int64Value = value; break;
     case Datatype::Int128: mem.int128Value = value; break;
+    case Datatype::Float16: mem.float16Value = value; break;
+    case Datatype::BFloat16: mem.bfloat16Value = value; break;
     case Datatype::Float32: mem.float32Value = value; break;
     case Datatype::Float64: mem.float64Value = value; break;
     case Datatype::Complex64:  mem.complex64Value = value; break;
@@ -88,6 +94,8 @@ void TypedComponent::add(ComponentTypeUnion& result, const ComponentTypeUnion& a
     case Datatype::Int32: result.int32Value  = a.int32Value +b.int32Value; break;
     case Datatype::Int64: result.int64Value  = a.int64Value + b.int64Value; break;
     case Datatype::Int128: result.int128Value  = a.int128Value + b.int128Value; break;
+    case Datatype::Float16: result.float16Value  = a.float16Value + b.float16Value; break;
+    case Datatype::BFloat16: result.bfloat16Value  = a.bfloat16Value + b.bfloat16Value; break;
     case Datatype::Float32: result.float32Value  = a.float32Value + b.float32Value; break;
     case Datatype::Float64: result.float64Value  = a.float64Value + b.float64Value; break;
     case Datatype::Complex64: result.complex64Value  = a.complex64Value + b.complex64Value; break;
@@ -109,6 +117,8 @@ void TypedComponent::addInt(ComponentTypeUnion& result, const ComponentTypeUnion
     case Datatype::Int32: result.int32Value  = a.int32Value + b; break;
     case Datatype::Int64: result.int64Value  = a.int64Value + b; break;
     case Datatype::Int128: result.int128Value  = a.int128Value + b; break;
+    case Datatype::Float16: result.float16Value  = a.float16Value + b; break;
+    case Datatype::BFloat16: result.bfloat16Value  = a.bfloat16Value + b; break;
     case Datatype::Float32: result.float32Value  = a.float32Value + b; break;
     case Datatype::Float64: result.float64Value  = a.float64Value + b; break;
     case Datatype::Complex64: result.complex64Value  = a.complex64Value + std::complex<float>(b, 0); break;
@@ -132,6 +142,8 @@ void TypedComponent::negate(ComponentTypeUnion& result, const ComponentTypeUnion
     case Datatype::Int32: result.int32Value  = -a.int32Value; break;
     case Datatype::Int64: result.int64Value  = -a.int64Value; break;
     case Datatype::Int128: result.int128Value  = -a.int128Value; break;
+    case Datatype::Float16: result.float16Value  = -a.float16Value; break;
+    case Datatype::BFloat16: result.bfloat16Value  = -a.bfloat16Value; break;
     case Datatype::Float32: result.float32Value  = -a.float32Value; break;
     case Datatype::Float64: result.float64Value  = -a.float64Value; break;
     case Datatype::Complex64: result.complex64Value  = -a.complex64Value; break;
@@ -153,6 +165,8 @@ void TypedComponent::multiply(ComponentTypeUnion& result, const ComponentTypeUni
     case Datatype::Int32: result.int32Value  = a.int32Value *b.int32Value; break;
     case Datatype::Int64: result.int64Value  = a.int64Value * b.int64Value; break;
     case Datatype::Int128: result.int128Value  = a.int128Value * b.int128Value; break;
+    case Datatype::Float16: result.float16Value  = a.float16Value * b.float16Value; break;
+    case Datatype::BFloat16: result.bfloat16Value  = a.bfloat16Value * b.bfloat16Value; break;
     case Datatype::Float32: result.float32Value  = a.float32Value * b.float32Value; break;
     case Datatype::Float64: result.float64Value  = a.float64Value * b.float64Value; break;
     case Datatype::Complex64: result.complex64Value  = a.complex64Value * b.complex64Value; break;
@@ -174,6 +188,8 @@ void TypedComponent::multiplyInt(ComponentTypeUnion& result, const ComponentType
     case Datatype::Int32: result.int32Value  = a.int32Value *b; break;
     case Datatype::Int64: result.int64Value  = a.int64Value * b; break;
     case Datatype::Int128: result.int128Value  = a.int128Value * b; break;
+    case Datatype::Float16: result.float16Value  = a.float16Value * b; break;
+    case Datatype::BFloat16: result.bfloat16Value  = a.bfloat16Value * b; break;
     case Datatype::Float32: result.float32Value  = a.float32Value * b; break;
     case Datatype::Float64: result.float64Value  = a.float64Value * b; break;
     case Datatype::Complex64: result.complex64Value  = a.complex64Value * std::complex<float>(b, 0); break;
@@ -465,6 +481,8 @@ bool operator>(const TypedComponentVal& a, const TypedComponentVal &other) {
     case Datatype::Int32: return a.get().int32Value > (other.get()).int32Value;
     case Datatype::Int64: return a.get().int64Value > (other.get()).int64Value;
     case Datatype::Int128: return a.get().int128Value > (other.get()).int128Value;
+    case Datatype::Float16: return a.get().float16Value > (other.get()).float16Value;
+    case Datatype::BFloat16: return a.get().bfloat16Value > (other.get()).bfloat16Value;
     case Datatype::Float32: return a.get().float32Value > (other.get()).float32Value;
     case Datatype::Float64: return a.get().float64Value > (other.get()).float64Value;
     case Datatype::Complex64: taco_ierror; return false;
@@ -489,6 +507,8 @@ bool operator==(const TypedComponentVal& a, const TypedComponentVal &other) {
     case Datatype::Int32: return a.get().int32Value == (other.get()).int32Value;
     case Datatype::Int64: return a.get().int64Value == (other.get()).int64Value;
     case Datatype::Int128: return a.get().int128Value == (other.get()).int128Value;
+    case Datatype::Float16: return a.get().float16Value == (other.get()).float16Value;
+    case Datatype::BFloat16: return a.get().bfloat16Value == (other.get()).bfloat16Value;
     case Datatype::Float32: return a.get().float32Value == (other.get()).float32Value;
     case Datatype::Float64: return a.get().float64Value == (other.get()).float64Value;
     case Datatype::Complex64: taco_ierror; return false;
@@ -528,6 +548,8 @@ bool operator>(const TypedComponentVal& a, const int other) {
     case Datatype::Int32: return a.get().int32Value > other;
     case Datatype::Int64: return a.get().int64Value > other;
     case Datatype::Int128: return a.get().int128Value > other;
+    case Datatype::Float16: return a.get().float16Value > other;
+    case Datatype::BFloat16: return a.get().bfloat16Value > other;
     case Datatype::Float32: return a.get().float32Value > other;
     case Datatype::Float64: return a.get().float64Value > other;
     case Datatype::Complex64: taco_ierror; return false;
@@ -551,6 +573,8 @@ bool operator==(const TypedComponentVal& a, const int other) {
     case Datatype::Int32: return a.get().int32Value == other;
     case Datatype::Int64: return a.get().int64Value == other;
     case Datatype::Int128: return a.get().int128Value == other;
+    case Datatype::Float16: return a.get().float16Value == other;
+    case Datatype::BFloat16: return a.get().bfloat16Value == other;
     case Datatype::Float32: return a.get().float32Value == other;
     case Datatype::Float64: return a.get().float64Value == other;
     case Datatype::Complex64: taco_ierror; return false;
@@ -39,6 +39,7 @@ taco_tensor_t* init_taco_tensor_t(int32_t order, int32_t csize,
   t->mode_types = (taco_mode_t *) alloc_mem(order * sizeof(taco_mode_t));
   t->indices = (uint8_t ***) alloc_mem(order * sizeof(uint8_t***));
   t->csize         = csize;
+  t->vals_dict     = NULL;
 
   int fill_bytes = csize / 8;
   t->fill_value = (uint8_t*) alloc_mem(fill_bytes);
@@ -59,7 +60,9 @@ taco_tensor_t* init_taco_tensor_t(int32_t order, int32_t csize,
         t->indices[i] = (uint8_t **) alloc_mem(1 * sizeof(uint8_t **));
         break;
       case taco_mode_sparse:
-        t->indices[i] = (uint8_t **) alloc_mem(2 * sizeof(uint8_t **));
+        // Sparse levels store pos and crd arrays, plus a crd header array if
+        // the coordinates are delta compressed
+        t->indices[i] = (uint8_t **) alloc_mem(3 * sizeof(uint8_t **));
         break;
     }
   }
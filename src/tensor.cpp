@@ -1,6 +1,7 @@
 #include "taco/tensor.h"
 
 #include <set>
+#include <algorithm>
 #include <cstring>
 #include <fstream>
 #include <sstream>
@@ -9,6 +10,11 @@
 #include <vector>
 #include <utility>
 #include <mutex>
+#if defined(__linux__)
+#include <unistd.h>
+#include <dlfcn.h>
+#include <sys/syscall.h>
+#endif
 
 #include "taco/cuda.h"
 #include "taco/format.h"
@@ -21,6 +27,7 @@
 //#include "codegen/codegen_cuda.h"
 //#include "taco/taco_tensor_t.h"
 #include "taco/index_notation/index_notation_visitor.h"
+#include "taco/index_notation/index_notation_rewriter.h"
 #include "taco/index_notation/transformations.h"
 #include "taco/ir/ir.h"
 #include "taco/ir/ir_printer.h"
@@ -34,6 +41,7 @@
 #include "taco/storage/file_io_rb.h"
 #include "taco/storage/typed_vector.h"
 #include "taco/util/collections.h"
+#include "taco/util/env.h"
 #include "taco/util/strings.h"
 #include "taco/util/timers.h"
 #include "taco/util/name_generator.h"
@@ -91,9 +99,10 @@ static Format initFormat(Format format) {
     for (int i = 0; i < format.getOrder(); ++i) {
       std::vector<Datatype> arrayTypes;
       ModeFormat modeType = format.getModeFormats()[i];
-      if (modeType.getName() == Dense.getName()) {
+      if (modeType.getName() == Dense.getName() || isTiled(modeType)) {
         arrayTypes.push_back(Int32);
-      } else if (modeType.getName() == Sparse.getName()) {
+      } else if (modeType.getName() == Sparse.getName() ||
+                 modeType.getName() == DeltaCompressed.getName()) {
         arrayTypes.push_back(Int32);
         arrayTypes.push_back(Int32);
       } else if (modeType.getName() == Singleton.getName()) {
@@ -129,7 +138,8 @@ TensorBase::TensorBase(string name, Datatype ctype, vector<int> dimensions,
   // Initialize dense storage modes
   // TODO: Get rid of this and make code use dimensions instead of dense indices
   for (int i = 0; i < format.getOrder(); ++i) {
-    if (format.getModeFormats()[i].getName() == Dense.getName()) {
+    if (format.getModeFormats()[i].getName() == Dense.getName() ||
+        isTiled(format.getModeFormats()[i])) {
       const size_t idx = format.getModeOrdering()[i];
       modeIndices[i] = ModeIndex({makeArray({content->dimensions[idx]})});
     }
@@ -145,6 +155,9 @@ TensorBase::TensorBase(string name, Datatype ctype, vector<int> dimensions,
   content->needsAssemble = false;
   content->needsCompute = false;
 
+  content->automaticFormatSelection = false;
+  content->automaticContractionOrdering = false;
+
   content->coordinateBuffer = shared_ptr<vector<char>>(new vector<char>);
   content->coordinateBufferUsed = 0;
   content->coordinateSize = getOrder()*sizeof(int) + ctype.getNumBytes();
@@ -189,6 +202,10 @@ const TensorVar& TensorBase::getTensorVar() const {
   return content->tensorVar;
 }
 
+const TensorStatistics& TensorBase::getStatistics() const {
+  return content->statistics;
+}
+
 const TensorStorage& TensorBase::getStorage() const {
   return content->storage;
 }
@@ -260,6 +277,73 @@ static int lexicographicalCmp(const void* a, const void* b) {
   return 0;
 }
 
+static NumaPolicy taco_numa_policy = NumaPolicy::FirstTouch;
+
+/// Returns a mask of the online NUMA nodes, or an empty mask if there are
+/// fewer than two.
+static vector<unsigned long> getNumaNodeMask() {
+  const size_t bitsPerWord = 8 * sizeof(unsigned long);
+  vector<unsigned long> mask;
+  int numNodes = 0;
+  std::ifstream online("/sys/devices/system/node/online");
+  string range;
+  while (std::getline(online, range, ',')) {
+    int first = 0, last = -1;
+    if (sscanf(range.c_str(), "%d-%d", &first, &last) < 2) {
+      last = first;
+    }
+    for (int node = first; node <= last; node++) {
+      if (mask.size() <= (size_t)node / bitsPerWord) {
+        mask.resize(node / bitsPerWord + 1, 0);
+      }
+      mask[node / bitsPerWord] |= 1ul << (node % bitsPerWord);
+      numNodes++;
+    }
+  }
+  return (numNodes > 1) ? mask : vector<unsigned long>();
+}
+
+/// Spreads the whole pages of an array round-robin across the NUMA nodes,
+/// moving the pages that were already placed.
+static void interleaveArray(const Array& array) {
+#if defined(__linux__) && defined(SYS_mbind)
+  static const vector<unsigned long> nodeMask = getNumaNodeMask();
+  const uintptr_t pageSize = sysconf(_SC_PAGESIZE);
+  const uintptr_t data = (uintptr_t)array.getData();
+  const uintptr_t begin = (data + pageSize - 1) / pageSize * pageSize;
+  const uintptr_t end =
+      (data + array.getSize() * array.getType().getNumBytes()) / pageSize *
+      pageSize;
+  if (nodeMask.empty() || data == 0 || end <= begin) {
+    return;
+  }
+  const int MPOL_INTERLEAVE = 3;
+  const unsigned MPOL_MF_MOVE = 1 << 1;
+  // The policy is a hint, so failures (e.g. because of a seccomp filter) are
+  // ignored.
+  syscall(SYS_mbind, begin, end - begin, MPOL_INTERLEAVE, nodeMask.data(),
+          nodeMask.size() * 8 * sizeof(unsigned long) + 1, MPOL_MF_MOVE);
+#else
+  (void)array;
+#endif
+}
+
+/// Places the arrays of a packed tensor according to the NUMA policy.
+static void placeStorage(const TensorStorage& storage) {
+  if (taco_numa_policy != NumaPolicy::Interleave ||
+      should_use_CUDA_unified_memory()) {
+    return;
+  }
+  const Index& index = storage.getIndex();
+  for (int i = 0; i < index.numModeIndices(); i++) {
+    const ModeIndex& modeIndex = index.getModeIndex(i);
+    for (int j = 0; j < modeIndex.numIndexArrays(); j++) {
+      interleaveArray(modeIndex.getIndexArray(j));
+    }
+  }
+  interleaveArray(storage.getValues());
+}
+
 static size_t unpackTensorData(const taco_tensor_t& tensorData,
                                const TensorBase& tensor) {
   auto storage = tensor.getStorage();
@@ -269,11 +353,16 @@ static size_t unpackTensorData(const taco_tensor_t& tensorData,
   size_t numVals = 1;
   for (int i = 0; i < tensor.getOrder(); i++) {
     ModeFormat modeType = format.getModeFormats()[i];
-    if (modeType.getName() == Dense.getName()) {
-      Array size = makeArray({*(int*)tensorData.indices[i][0]});
-      modeIndices.push_back(ModeIndex({size}));
-      numVals *= ((int*)tensorData.indices[i][0])[0];
-    } else if (modeType.getName() == Sparse.getName()) {
+    if (modeType.getName() == Dense.getName() || isTiled(modeType)) {
+      // Tiled levels are padded to a whole number of tiles.
+      const int size = *(int*)tensorData.indices[i][0];
+      const int tileSize = getTileSize(modeType);
+      modeIndices.push_back(ModeIndex({makeArray({size})}));
+      numVals *= (size + tileSize - 1) / tileSize * tileSize;
+    } else if (modeType.getName() == Sparse.getName() ||
+               modeType.getName() == DeltaCompressed.getName()) {
+      // Delta compressed levels are packed as compressed levels and encoded
+      // afterwards (see `encodeCoordinates`).
       auto size = ((int*)tensorData.indices[i][0])[numVals];
       Array pos = Array(type<int>(), tensorData.indices[i][0], numVals+1, Array::UserOwns);
       Array idx = Array(type<int>(), tensorData.indices[i][1], size, Array::UserOwns);
@@ -291,12 +380,146 @@ static size_t unpackTensorData(const taco_tensor_t& tensorData,
   return numVals;
 }
 
+void TensorBase::reinsertPackedComponents(TensorBase tensor,
+                                          Datatype ctype) {
+  switch (ctype.getKind()) {
+    case Datatype::Bool:
+      reinsertPackedComponents<bool>(tensor);
+      break;
+    case Datatype::UInt8:
+      reinsertPackedComponents<uint8_t>(tensor);
+      break;
+    case Datatype::UInt16:
+      reinsertPackedComponents<uint16_t>(tensor);
+      break;
+    case Datatype::UInt32:
+      reinsertPackedComponents<uint32_t>(tensor);
+      break;
+    case Datatype::UInt64:
+      reinsertPackedComponents<uint64_t>(tensor);
+      break;
+    case Datatype::Int8:
+      reinsertPackedComponents<int8_t>(tensor);
+      break;
+    case Datatype::Int16:
+      reinsertPackedComponents<int16_t>(tensor);
+      break;
+    case Datatype::Int32:
+      reinsertPackedComponents<int32_t>(tensor);
+      break;
+    case Datatype::Int64:
+      reinsertPackedComponents<int64_t>(tensor);
+      break;
+    case Datatype::Float32:
+      reinsertPackedComponents<float>(tensor);
+      break;
+    case Datatype::Float64:
+      reinsertPackedComponents<double>(tensor);
+      break;
+    case Datatype::Complex64:
+      reinsertPackedComponents<std::complex<float>>(tensor);
+      break;
+    case Datatype::Complex128:
+      reinsertPackedComponents<std::complex<double>>(tensor);
+      break;
+    default:
+      taco_ierror << "unsupported type";
+      break;
+  };
+}
+
+void TensorBase::repack(Format format) {
+  format = initFormat(format);
+  taco_uassert(format.getOrder() == getOrder()) <<
+      "The number of format mode types (" << format.getOrder() << ") " <<
+      "must match the tensor order (" << getOrder() << ").";
+  if (format == getFormat()) {
+    return;
+  }
+  syncValues();
+
+  // Move the packed components back into the coordinate buffer, and then pack
+  // them into fresh storage of the new format.
+  reinsertPackedComponents(*this, getComponentType());
+  content->storage = TensorStorage(getComponentType(), getDimensions(), format,
+                                   getStorage().getFillValue());
+  vector<ModeIndex> modeIndices(format.getOrder());
+  for (int i = 0; i < format.getOrder(); ++i) {
+    if (format.getModeFormats()[i].getName() == Dense.getName() ||
+        isTiled(format.getModeFormats()[i])) {
+      const size_t idx = format.getModeOrdering()[i];
+      modeIndices[i] = ModeIndex({makeArray({content->dimensions[idx]})});
+    }
+  }
+  content->storage.setIndex(Index(format, modeIndices));
+  content->tensorVar.setFormat(format);
+  content->neverPacked = true;
+  setNeedsPack(true);
+  pack();
+
+  // Kernels that read the tensor were generated for its old format.
+  evictComputeKernels(getTensorVar());
+  for (TensorBase dependent : getDependentTensors()) {
+    dependent.setNeedsCompile(true);
+  }
+}
+
+TensorBase TensorBase::convert(Format format) {
+  format = initFormat(format);
+  taco_uassert(format.getOrder() == getOrder()) <<
+      "The number of format mode types (" << format.getOrder() << ") " <<
+      "must match the tensor order (" << getOrder() << ").";
+  syncValues();
+  if (format == getFormat()) {
+    return *this;
+  }
+  for (auto& conversion : content->conversions) {
+    if (conversion.getFormat() == format) {
+      return conversion;
+    }
+  }
+
+  TensorBase conversion(util::uniqueName(getName()), getComponentType(),
+                        getDimensions(), format, getFillValue());
+  reinsertPackedComponents(conversion, getComponentType());
+  conversion.setNeedsPack(true);
+  conversion.pack();
+  content->conversions.push_back(conversion);
+  return conversion;
+}
+
+void TensorBase::setAutomaticFormatSelection(bool automaticFormatSelection) {
+  content->automaticFormatSelection = automaticFormatSelection;
+}
+
+void TensorBase::setAutomaticContractionOrdering(
+    bool automaticContractionOrdering) {
+  content->automaticContractionOrdering = automaticContractionOrdering;
+}
+
+void TensorBase::setAccumulationType(Datatype accumulationType) {
+  taco_uassert(max_type(getComponentType(), accumulationType) ==
+               accumulationType)
+      << "Cannot accumulate " << getComponentType() << " values in "
+      << accumulationType;
+  content->accumulationType = accumulationType;
+}
+
+Datatype TensorBase::getAccumulationType() const {
+  if (content->accumulationType != Datatype()) {
+    return content->accumulationType;
+  }
+  return getComponentType().isReducedPrecision() ? Float32
+                                                 : getComponentType();
+}
+
 /// Pack coordinates into a data structure given by the tensor format.
 void TensorBase::pack() {
   if (!needsPack()) {
     return;
   }
   setNeedsPack(false);
+  content->conversions.clear();
 
   if (neverPacked()) {
     unsetNeverPacked();
@@ -308,50 +531,7 @@ void TensorBase::pack() {
     //       data structure) with unpacked components (stored in temporary
     //       buffer). We can already generate such code, but currently
     //       compiling it is too expensive.
-    switch (getComponentType().getKind()) {
-      case Datatype::Bool:
-        reinsertPackedComponents<bool>();
-        break;
-      case Datatype::UInt8:
-        reinsertPackedComponents<uint8_t>();
-        break;
-      case Datatype::UInt16:
-        reinsertPackedComponents<uint16_t>();
-        break;
-      case Datatype::UInt32:
-        reinsertPackedComponents<uint32_t>();
-        break;
-      case Datatype::UInt64:
-        reinsertPackedComponents<uint64_t>();
-        break;
-      case Datatype::Int8:
-        reinsertPackedComponents<int8_t>();
-        break;
-      case Datatype::Int16:
-        reinsertPackedComponents<int16_t>();
-        break;
-      case Datatype::Int32:
-        reinsertPackedComponents<int32_t>();
-        break;
-      case Datatype::Int64:
-        reinsertPackedComponents<int64_t>();
-        break;
-      case Datatype::Float32:
-        reinsertPackedComponents<float>();
-        break;
-      case Datatype::Float64:
-        reinsertPackedComponents<double>();
-        break;
-      case Datatype::Complex64:
-        reinsertPackedComponents<std::complex<float>>();
-        break;
-      case Datatype::Complex128:
-        reinsertPackedComponents<std::complex<double>>();
-        break;
-      default:
-        taco_ierror << "unsupported type";
-        break;
-    };
+    reinsertPackedComponents(*this, getComponentType());
   }
 
   const int order = getOrder();
@@ -386,6 +566,9 @@ void TensorBase::pack() {
     std::vector<void*> arguments = {content->storage, bufferStorage};
     helperFuncs->callFuncPacked("pack", arguments.data());
     content->valuesSize = unpackTensorData(*((taco_tensor_t*)arguments[0]), *this);
+    encodeCoordinates(getStorage());
+    encodeValues(getStorage());
+    placeStorage(getStorage());
 
     deinit_taco_tensor_t(bufferStorage);
     content->coordinateBuffer->clear();
@@ -421,6 +604,11 @@ void TensorBase::pack() {
   numIntegersToCompare = order;
   qsort(coordinatesPtr, numCoordinates, coordSize, lexicographicalCmp);
 
+  // Collect nonzero statistics while the coordinates are sorted
+  content->statistics = TensorStatistics(dimensions, permutation,
+                                         coordinatesPtr, numCoordinates,
+                                         coordSize);
+
 
   // Move coords into separate arrays
   std::vector<std::vector<int>> coordinates(order);
@@ -457,6 +645,9 @@ void TensorBase::pack() {
   std::vector<void*> arguments = {content->storage, bufferStorage};
   helperFuncs->callFuncPacked("pack", arguments.data());
   content->valuesSize = unpackTensorData(*((taco_tensor_t*)arguments[0]), *this);
+  encodeCoordinates(getStorage());
+  encodeValues(getStorage());
+  placeStorage(getStorage());
 
   free(values);
   deinit_taco_tensor_t(bufferStorage);
@@ -602,11 +793,183 @@ void TensorBase::cacheComputeKernel(const IndexStmt stmt,
   computeKernelsMutex.unlock();
 }
 
+void TensorBase::evictComputeKernels(const TensorVar& tensorVar) {
+  computeKernelsMutex.lock();
+  computeKernels.erase(std::remove_if(computeKernels.begin(),
+                                      computeKernels.end(),
+      [&](const std::pair<IndexStmt,std::shared_ptr<Module>>& computeKernel) {
+        return util::contains(getTensorVars(computeKernel.first), tensorVar);
+      }), computeKernels.end());
+  computeKernelsMutex.unlock();
+}
+
+static bool taco_fusion = false;
+
+/// Renames the index variables of an expression, keeping the tensors that its
+/// accesses read.
+struct RenameIndexVars : public IndexNotationRewriter {
+  using IndexNotationRewriter::visit;
+
+  map<IndexVar,IndexVar> renames;
+
+  IndexVar rename(const IndexVar& var) {
+    return util::contains(renames, var) ? renames.at(var) : var;
+  }
+
+  void visit(const AccessNode* op) {
+    vector<IndexVar> indexVars;
+    for (auto& var : op->indexVars) {
+      indexVars.push_back(rename(var));
+    }
+    if (isa<AccessTensorNode>(op)) {
+      expr = Access(new AccessTensorNode(to<AccessTensorNode>(op)->tensor,
+                                         indexVars));
+    } else {
+      expr = Access(op->tensorVar, indexVars, op->packageModifiers(),
+                    op->isAccessingStructure);
+    }
+  }
+
+  void visit(const ReductionNode* op) {
+    expr = new ReductionNode(op->op, rename(op->var), rewrite(op->a));
+  }
+
+  void visit(const IndexVarNode* op) {
+    expr = rename(IndexVar(op));
+  }
+};
+
+/// Inlines the expressions of operands that have been assigned but not yet
+/// computed into the expression that reads them, so that their values never
+/// have to be stored.  An operand is only fused if it is read once, and
+/// operands that reduce are only fused into dense results, where the
+/// reductions become scalar temporaries.
+struct FuseProducers : public IndexNotationRewriter {
+  using IndexNotationRewriter::visit;
+
+  TensorBase consumer;
+  bool denseConsumer;
+  map<TensorVar,int> reads;
+  vector<TensorBase> fused;
+
+  FuseProducers(TensorBase consumer)
+      : consumer(consumer), denseConsumer(isDense(consumer.getFormat())) {}
+
+  IndexExpr fuse(IndexExpr expr) {
+    reads.clear();
+    match(expr,
+      function<void(const AccessNode*)>([&](const AccessNode* op) {
+        reads[op->tensorVar]++;
+      })
+    );
+    return rewrite(expr);
+  }
+
+  bool isFusable(TensorBase producer, const AccessNode* access) {
+    Assignment assignment = producer.getAssignment();
+    if (producer == consumer || !producer.needsCompute() ||
+        producer.needsPack() || !assignment.defined() ||
+        assignment.getOperator().defined() ||
+        reads.at(access->tensorVar) != 1 ||
+        !access->windowedModes.empty() || !access->indexSetModes.empty() ||
+        !equals(producer.getFillValue(),
+                Literal::zero(producer.getComponentType()))) {
+      return false;
+    }
+    set<IndexVar> indexVars(access->indexVars.begin(),
+                            access->indexVars.end());
+    if (indexVars.size() != access->indexVars.size()) {
+      return false;
+    }
+
+    // The reductions of a fused producer are nested inside the loops over its
+    // result, so the sparse operands it reads must store the reduced modes
+    // below the others
+    bool fusable = true;
+    set<IndexVar> reductionVars;
+    match(assignment.getRhs(),
+      function<void(const ReductionNode*)>([&](const ReductionNode* op) {
+        fusable &= denseConsumer;
+        reductionVars.insert(op->var);
+      })
+    );
+    match(assignment.getRhs(),
+      function<void(const AccessNode*)>([&](const AccessNode* op) {
+        if (!isa<AccessTensorNode>(op) || !op->windowedModes.empty() ||
+            !op->indexSetModes.empty() ||
+            to<AccessTensorNode>(op)->tensor == consumer) {
+          fusable = false;
+          return;
+        }
+        const Format& format = to<AccessTensorNode>(op)->tensor.getFormat();
+        if (isDense(format)) {
+          return;
+        }
+        bool reduced = false;
+        for (int mode : format.getModeOrdering()) {
+          bool isReductionVar = util::contains(reductionVars,
+                                               op->indexVars[mode]);
+          fusable &= (isReductionVar || !reduced);
+          reduced |= isReductionVar;
+        }
+      })
+    );
+    return fusable;
+  }
+
+  void visit(const AccessNode* op) {
+    if (!isa<AccessTensorNode>(op) ||
+        !isFusable(to<AccessTensorNode>(op)->tensor, op)) {
+      expr = op;
+      return;
+    }
+    TensorBase producer = to<AccessTensorNode>(op)->tensor;
+    Assignment assignment = producer.getAssignment();
+
+    // Rename the producer's variables to those it is accessed with, and give
+    // its reductions fresh variables
+    RenameIndexVars renamer;
+    for (auto var : util::zip(assignment.getLhs().getIndexVars(),
+                               op->indexVars)) {
+      renamer.renames.insert(var);
+    }
+    match(assignment.getRhs(),
+      function<void(const ReductionNode*)>([&](const ReductionNode* reduction) {
+        renamer.renames.insert({reduction->var, IndexVar()});
+      })
+    );
+    fused.push_back(producer);
+
+    // Fuse the producer's own pending operands
+    map<TensorVar,int> consumerReads = reads;
+    expr = fuse(renamer.rewrite(assignment.getRhs()));
+    reads = consumerReads;
+  }
+};
+
 void TensorBase::compile() {
   Assignment assignment = getAssignment();
   taco_uassert(assignment.defined())
       << error::compile_without_expr;
 
+  // Fuse operands that have yet to be computed into this computation.  They
+  // stay pending, and are computed on their own if they are read later.
+  if (taco_fusion) {
+    FuseProducers fuser(*this);
+    IndexExpr rhs = fuser.fuse(assignment.getRhs());
+    if (rhs != assignment.getRhs()) {
+      for (TensorBase& producer : fuser.fused) {
+        producer.removeDependentTensor(*this);
+      }
+      for (auto& operand : getTensors(rhs)) {
+        operand.second.addDependentTensor(*this);
+      }
+      assignment = Assignment(assignment.getLhs(), rhs,
+                              assignment.getOperator());
+      content->assignment = assignment;
+    }
+  }
+
   struct CollisionFinder : public IndexNotationVisitor {
     using IndexNotationVisitor::visit;
 
@@ -634,9 +997,74 @@ void TensorBase::compile() {
   assignment.getLhs().accept(&dupes);
   assignment.accept(&dupes);
 
+  // Repack operands that have automatic format selection enabled into the
+  // format that best suits this expression.
+  for (auto& operand : getTensors(assignment.getRhs())) {
+    TensorBase tensor = operand.second;
+    if (tensor.content->automaticFormatSelection) {
+      tensor.pack();
+      tensor.repack(suggestFormat(tensor, assignment.getRhs()));
+    }
+  }
+
+  // Read operands whose formats disagree with the loop order from converted
+  // copies, when the loops cannot or should not be reordered around them.
+  auto operands = getTensors(assignment.getRhs());
+  vector<TensorBase> operandTensors;
+  for (auto& operand : operands) {
+    operandTensors.push_back(operand.second);
+  }
+  auto operandFormats = suggestOperandFormats(assignment, operandTensors);
+  if (!operandFormats.empty()) {
+    struct ConvertOperands : public IndexNotationRewriter {
+      using IndexNotationRewriter::visit;
+      map<TensorVar,TensorBase> conversions;
+
+      void visit(const AccessNode* op) {
+        if (util::contains(conversions, op->tensorVar)) {
+          expr = conversions.at(op->tensorVar)(op->indexVars);
+        } else {
+          expr = op;
+        }
+      }
+    };
+    ConvertOperands convertOperands;
+    for (auto& operandFormat : operandFormats) {
+      TensorBase operand = operands.at(operandFormat.first);
+      convertOperands.conversions.insert({operandFormat.first,
+                                          operand.convert(operandFormat.second)});
+    }
+    assignment = to<Assignment>(convertOperands.rewrite(assignment));
+    content->assignment = assignment;
+  }
+
+  // Contract long products pairwise, in the order that the nonzero counts of
+  // the operands suggest is cheapest.
+  if (content->automaticContractionOrdering && !should_use_CUDA_codegen()) {
+    map<TensorVar,size_t> nonzeros;
+    for (auto& operand : getTensors(assignment.getRhs())) {
+      TensorBase tensor = operand.second;
+      if (tensor.needsPack()) {
+        tensor.pack();
+      }
+      if (tensor.getStatistics().defined()) {
+        nonzeros.insert({operand.first,
+                         tensor.getStatistics().getNumNonzeros()});
+      }
+    }
+    IndexStmt stmt = optimizeContractionOrder(assignment, nonzeros);
+    if (isa<Where>(stmt)) {
+      compile(stmt, content->assembleWhileCompute);
+      return;
+    }
+  }
+
   IndexStmt stmt = makeConcreteNotation(makeReductionNotation(assignment));
   stmt = reorderLoopsTopologically(stmt);
   stmt = insertTemporaries(stmt);
+  if (!should_use_CUDA_codegen()) {
+    stmt = eliminateCommonSubexpressions(stmt);
+  }
   stmt = parallelizeOuterLoop(stmt);
   compile(stmt, content->assembleWhileCompute);
 }
@@ -650,6 +1078,12 @@ void TensorBase::compile(taco::IndexStmt stmt, bool assembleWhileCompute) {
   IndexStmt concretizedAssign = stmt;
   IndexStmt stmtToCompile = stmt.concretize();
   stmtToCompile = scalarPromote(stmtToCompile);
+  if (getAccumulationType() != getComponentType()) {
+    stmtToCompile = widenAccumulators(stmtToCompile, getAccumulationType());
+  }
+  // Temporaries can reorder the kernel's parameters, so the operands are
+  // packed in the order of the lowered statement's arguments
+  content->arguments = getArguments(stmtToCompile);
 
   if (!std::getenv("CACHE_KERNELS") ||
       std::string(std::getenv("CACHE_KERNELS")) != "0") {
@@ -776,7 +1210,8 @@ static inline map<TensorVar, TensorBase> getTensors(const IndexExpr& expr) {
 }
 
 static inline
-vector<void*> packArguments(const TensorBase& tensor) {
+vector<void*> packArguments(const TensorBase& tensor,
+                            vector<TensorVar> operands) {
   vector<void*> arguments;
 
   // Pack the result tensor
@@ -794,7 +1229,9 @@ vector<void*> packArguments(const TensorBase& tensor) {
   }
 
   // Pack operand tensors
-  auto operands = getArguments(makeConcreteNotation(tensor.getAssignment()));
+  if (operands.empty()) {
+    operands = getArguments(makeConcreteNotation(tensor.getAssignment()));
+  }
 
   auto tensors = getTensors(tensor.getAssignment().getRhs());
   for (auto& operand : operands) {
@@ -816,7 +1253,7 @@ void TensorBase::assemble() {
     operand.second.syncValues();
   }
 
-  auto arguments = packArguments(*this);
+  auto arguments = packArguments(*this, content->arguments);
   content->module->callFuncPacked("assemble", arguments.data());
 
   if (!content->assembleWhileCompute) {
@@ -832,6 +1269,8 @@ void TensorBase::compute() {
     return;
   }
   setNeedsCompute(false);
+  content->statistics = TensorStatistics();
+  content->conversions.clear();
   // Sync operand tensors if needed.
   auto operands = getTensors(getAssignment().getRhs());
   for (auto& operand : operands) {
@@ -839,7 +1278,7 @@ void TensorBase::compute() {
     operand.second.removeDependentTensor(*this);
   }
 
-  auto arguments = packArguments(*this);
+  auto arguments = packArguments(*this, content->arguments);
   this->content->module->callFuncPacked("compute", arguments.data());
 
   if (content->assembleWhileCompute) {
@@ -912,6 +1351,7 @@ void TensorBase::compileSource(std::string source) {
   stmt = parallelizeOuterLoop(stmt);
   content->assembleFunc = lower(stmt, "assemble", true, false);
   content->computeFunc = lower(stmt, "compute",  false, true);
+  content->arguments = getArguments(stmt);
 
   stringstream ss;
   if (should_use_CUDA_codegen()) {
@@ -929,6 +1369,32 @@ void TensorBase::compileSource(std::string source) {
   setNeedsCompile(false);
 }
 
+/// Returns the format with delta compressed levels replaced by compressed
+/// levels and without any value encoding.
+static Format getPlainFormat(const Format& format) {
+  vector<ModeFormatPack> modeFormatPacks;
+  for (const auto& modeFormatPack : format.getModeFormatPacks()) {
+    vector<ModeFormat> modeFormats;
+    for (const auto& modeFormat : modeFormatPack.getModeFormats()) {
+      if (modeFormat.getName() == DeltaCompressed.getName()) {
+        modeFormats.push_back(Compressed({
+            modeFormat.isFull() ? ModeFormat::FULL : ModeFormat::NOT_FULL,
+            modeFormat.isOrdered() ? ModeFormat::ORDERED
+                                   : ModeFormat::NOT_ORDERED,
+            modeFormat.isUnique() ? ModeFormat::UNIQUE : ModeFormat::NOT_UNIQUE,
+            modeFormat.isZeroless() ? ModeFormat::ZEROLESS
+                                    : ModeFormat::NOT_ZEROLESS}));
+      } else {
+        modeFormats.push_back(modeFormat);
+      }
+    }
+    modeFormatPacks.push_back(ModeFormatPack(modeFormats));
+  }
+  Format plainFormat(modeFormatPacks, format.getModeOrdering());
+  plainFormat.setLevelArrayTypes(format.getLevelArrayTypes());
+  return plainFormat;
+}
+
 TensorBase::HelperFuncsCache TensorBase::helperFunctions;
 std::mutex TensorBase::helperFunctionsMutex;
 
@@ -958,17 +1424,23 @@ TensorBase::getHelperFunctions(const Format& format, Datatype ctype,
   };
   const auto dims = util::map(dimensions, getDim);
 
+  // Coordinates and values are packed in plain form and then encoded by the
+  // host (see `encodeCoordinates` and `encodeValues`), whereas the iterator
+  // decodes them on the fly.
+  const Format plainFormat = getPlainFormat(format);
+
   if (format.getOrder() > 0) {
     const Format bufferFormat = COO(format.getOrder(), false, true, false,
                                     format.getModeOrdering());
     TensorVar bufferTensor(Type(ctype, Shape(dims)), bufferFormat);
-    TensorVar packedTensor(Type(ctype, Shape(dims)), format);
+    TensorVar packedTensor(Type(ctype, Shape(dims)), plainFormat);
+    TensorVar encodedTensor(Type(ctype, Shape(dims)), format);
 
     // Define packing and iterator routines in index notation.
     // TODO: Use `generatePackCOOStmt` function to generate pack routine.
     std::vector<IndexVar> indexVars(format.getOrder());
     IndexStmt packStmt = (packedTensor(indexVars) = bufferTensor(indexVars));
-    IndexStmt iterateStmt = Yield(indexVars, packedTensor(indexVars));
+    IndexStmt iterateStmt = Yield(indexVars, encodedTensor(indexVars));
     for (int i = format.getOrder() - 1; i >= 0; --i) {
       int mode = format.getModeOrdering()[i];
       packStmt = forall(indexVars[mode], packStmt);
@@ -996,7 +1468,8 @@ TensorBase::getHelperFunctions(const Format& format, Datatype ctype,
   } else {
     const Format bufferFormat = COO(1, false, true, false);
     TensorVar bufferVector(Type(ctype, Shape({1})), bufferFormat);
-    TensorVar packedScalar(Type(ctype, dims), format);
+    TensorVar packedScalar(Type(ctype, dims), plainFormat);
+    TensorVar encodedScalar(Type(ctype, dims), format);
 
     // Define and lower packing routine.
     // TODO: Redefine as reduction into packed scalar once reduction bug
@@ -1007,7 +1480,7 @@ TensorBase::getHelperFunctions(const Format& format, Datatype ctype,
     helperModule->addFunction(lower(packStmt, "pack", true, true));
 
     // Define and lower iterator code.
-    IndexStmt iterateStmt = Yield({}, packedScalar());
+    IndexStmt iterateStmt = Yield({}, encodedScalar());
     helperModule->addFunction(lower(iterateStmt, "iterate", false, true));
   }
   helperModule->compile();
@@ -1138,6 +1611,8 @@ bool equals(const TensorBase& a, const TensorBase& b) {
     case Datatype::Int32: return equalsTyped<int32_t>(a, b);
     case Datatype::Int64: return equalsTyped<int64_t>(a, b);
     case Datatype::Int128: return equalsTyped<long long>(a, b);
+    case Datatype::Float16: return equalsTyped<float16>(a, b);
+    case Datatype::BFloat16: return equalsTyped<bfloat16>(a, b);
     case Datatype::Float32: return equalsTyped<float>(a, b);
     case Datatype::Float64: return equalsTyped<double>(a, b);
     case Datatype::Complex64: return equalsTyped<std::complex<float>>(a, b);
@@ -1197,6 +1672,8 @@ ostream& operator<<(ostream& os, const TensorBase& tensor) {
       case Datatype::Int32: os << ((int32_t*)(ptr+tensor.getOrder()))[0] << std::endl; break;
       case Datatype::Int64: os << ((int64_t*)(ptr+tensor.getOrder()))[0] << std::endl; break;
       case Datatype::Int128: os << ((long long*)(ptr+tensor.getOrder()))[0] << std::endl; break;
+      case Datatype::Float16: os << ((float16*)(ptr+tensor.getOrder()))[0] << std::endl; break;
+      case Datatype::BFloat16: os << ((bfloat16*)(ptr+tensor.getOrder()))[0] << std::endl; break;
       case Datatype::Float32: os << ((float*)(ptr+tensor.getOrder()))[0] << std::endl; break;
       case Datatype::Float64: os << ((double*)(ptr+tensor.getOrder()))[0] << std::endl; break;
       case Datatype::Complex64: os << ((std::complex<float>*)(ptr+tensor.getOrder()))[0] << std::endl; break;
@@ -1237,6 +1714,8 @@ ostream& operator<<(ostream& os, TensorBase& tensor) {
       case Datatype::Int32: os << ((int32_t*)(ptr+tensor.getOrder()))[0] << std::endl; break;
       case Datatype::Int64: os << ((int64_t*)(ptr+tensor.getOrder()))[0] << std::endl; break;
       case Datatype::Int128: os << ((long long*)(ptr+tensor.getOrder()))[0] << std::endl; break;
+      case Datatype::Float16: os << ((float16*)(ptr+tensor.getOrder()))[0] << std::endl; break;
+      case Datatype::BFloat16: os << ((bfloat16*)(ptr+tensor.getOrder()))[0] << std::endl; break;
       case Datatype::Float32: os << ((float*)(ptr+tensor.getOrder()))[0] << std::endl; break;
       case Datatype::Float64: os << ((double*)(ptr+tensor.getOrder()))[0] << std::endl; break;
       case Datatype::Complex64: os << ((std::complex<float>*)(ptr+tensor.getOrder()))[0] << std::endl; break;
@@ -1310,6 +1789,44 @@ TensorBase read(std::string filename, Format format, bool pack) {
   return dispatchRead(filename, format, pack);
 }
 
+template <typename T>
+static TensorBase convertComponents(const TensorBase& tensor, Datatype ctype) {
+  TensorBase converted(tensor.getName(), ctype, tensor.getDimensions(),
+                       tensor.getFormat());
+  std::vector<int> coordinate(tensor.getOrder());
+  for (auto& component : iterate<double>(tensor)) {
+    for (int i = 0; i < tensor.getOrder(); ++i) {
+      coordinate[i] = component.first[i];
+    }
+    converted.insert(coordinate, T(component.second));
+  }
+  return converted;
+}
+
+TensorBase read(std::string filename, Format format, Datatype ctype,
+                bool pack) {
+  TensorBase tensor = read(filename, format, true);
+  switch (ctype.getKind()) {
+    case Datatype::Float16:
+      tensor = convertComponents<float16>(tensor, ctype);
+      break;
+    case Datatype::BFloat16:
+      tensor = convertComponents<bfloat16>(tensor, ctype);
+      break;
+    case Datatype::Float32:
+      tensor = convertComponents<float>(tensor, ctype);
+      break;
+    case Datatype::Float64:
+      break;
+    default:
+      taco_uerror << "Cannot read tensors with components of type " << ctype;
+  }
+  if (pack) {
+    tensor.pack();
+  }
+  return tensor;
+}
+
 TensorBase read(string filename, FileType filetype, ModeFormat modetype,
                 bool pack) {
   return dispatchRead(filename, filetype, modetype, pack);
@@ -1408,4 +1925,42 @@ int taco_get_num_threads() {
   return taco_num_threads;
 }
 
+void taco_set_numa_policy(NumaPolicy policy) {
+  taco_numa_policy = policy;
+}
+
+NumaPolicy taco_get_numa_policy() {
+  return taco_numa_policy;
+}
+
+void taco_set_fusion(bool fusion) {
+  taco_fusion = fusion;
+}
+
+bool taco_get_fusion() {
+  return taco_fusion;
+}
+
+static void* taco_blas = nullptr;
+static bool taco_blas_initialized = false;
+
+bool taco_set_blas(const std::string& library) {
+  // Libraries are never closed, since loaded kernels may still call them
+  void* handle = library.empty()
+                 ? nullptr : dlopen(library.c_str(), RTLD_NOW | RTLD_LOCAL);
+  if (handle && !dlsym(handle, "cblas_dgemm")) {
+    handle = nullptr;
+  }
+  taco_blas = handle;
+  taco_blas_initialized = true;
+  return taco_blas != nullptr;
+}
+
+void* taco_get_blas() {
+  if (!taco_blas_initialized) {
+    taco_set_blas(util::getFromEnv("TACO_BLAS", ""));
+  }
+  return taco_blas;
+}
+
 }
@@ -8,11 +8,116 @@
 #include <ostream>
 #include <set>
 #include <complex>
+#include <cstring>
 
 using namespace std;
 
 namespace taco {
 
+// class float16
+float16::float16(float value) {
+  uint32_t f;
+  memcpy(&f, &value, sizeof(f));
+  const uint16_t sign = (f >> 16) & 0x8000;
+  const uint32_t mantissa = f & 0x7fffff;
+  const int exponent = (int)((f >> 23) & 0xff) - 127 + 15;
+  if (exponent == 0xff - 127 + 15) {
+    // Infinity, or a quiet NaN
+    bits = sign | 0x7c00 | (mantissa ? 0x200 : 0);
+    return;
+  }
+  if (exponent >= 0x1f) {
+    bits = sign | 0x7c00;
+    return;
+  }
+  if (exponent < -10) {
+    bits = sign;
+    return;
+  }
+
+  // Round the significand to nearest, ties to even.  A carry out of the
+  // significand correctly increments the exponent.
+  uint32_t half, remainder, halfway;
+  if (exponent <= 0) {
+    const int shift = 14 - exponent;
+    half = (mantissa | 0x800000) >> shift;
+    remainder = (mantissa | 0x800000) & ((1u << shift) - 1);
+    halfway = 1u << (shift - 1);
+  } else {
+    half = (exponent << 10) | (mantissa >> 13);
+    remainder = mantissa & 0x1fff;
+    halfway = 0x1000;
+  }
+  if (remainder > halfway || (remainder == halfway && (half & 1))) {
+    half++;
+  }
+  bits = sign | half;
+}
+
+float16::operator float() const {
+  const uint32_t sign = (uint32_t)(bits & 0x8000) << 16;
+  uint32_t exponent = (bits >> 10) & 0x1f;
+  uint32_t mantissa = bits & 0x3ff;
+  uint32_t f;
+  if (exponent == 0x1f) {
+    f = sign | 0x7f800000 | (mantissa << 13);
+  } else if (exponent != 0) {
+    f = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+  } else if (mantissa == 0) {
+    f = sign;
+  } else {
+    // Normalize the subnormal
+    exponent = 127 - 15 + 1;
+    while (!(mantissa & 0x400)) {
+      mantissa <<= 1;
+      exponent--;
+    }
+    f = sign | (exponent << 23) | ((mantissa & 0x3ff) << 13);
+  }
+  float value;
+  memcpy(&value, &f, sizeof(value));
+  return value;
+}
+
+float16 float16::fromBits(uint16_t bits) {
+  float16 value;
+  value.bits = bits;
+  return value;
+}
+
+uint16_t float16::getBits() const {
+  return bits;
+}
+
+// class bfloat16
+bfloat16::bfloat16(float value) {
+  uint32_t f;
+  memcpy(&f, &value, sizeof(f));
+  if ((f & 0x7fffffff) > 0x7f800000) {
+    // Keep NaNs quiet rather than rounding them to infinity
+    bits = (f >> 16) | 0x40;
+    return;
+  }
+  bits = (f + 0x7fff + ((f >> 16) & 1)) >> 16;
+}
+
+bfloat16::operator float() const {
+  const uint32_t f = (uint32_t)bits << 16;
+  float value;
+  memcpy(&value, &f, sizeof(value));
+  return value;
+}
+
+bfloat16 bfloat16::fromBits(uint16_t bits) {
+  bfloat16 value;
+  value.bits = bits;
+  return value;
+}
+
+uint16_t bfloat16::getBits() const {
+  return bits;
+}
+
 Datatype::Datatype() : kind(Undefined) {
 }
 
@@ -38,7 +143,12 @@ bool Datatype::isInt() const {
 }
 
 bool Datatype::isFloat() const {
-  return getKind() == Float32 || getKind() == Float64;
+  return getKind() == Float16 || getKind() == BFloat16 ||
+         getKind() == Float32 || getKind() == Float64;
+}
+
+bool Datatype::isReducedPrecision() const {
+  return getKind() == Float16 || getKind() == BFloat16;
 }
 
 bool Datatype::isComplex() const {
@@ -61,6 +171,13 @@ Datatype max_type(Datatype a, Datatype b) {
     if (a == Float64 || b == Float64) {
       return Float64;
     }
+    // Integers combined with a 16-bit float keep the float's type
+    else if (!a.isFloat() && b.isReducedPrecision()) {
+      return b;
+    }
+    else if (!b.isFloat() && a.isReducedPrecision()) {
+      return a;
+    }
     else {
       return Float32;
     }
@@ -90,6 +207,8 @@ int Datatype::getNumBits() const {
       return 8;
     case UInt16:
     case Int16:
+    case Float16:
+    case BFloat16:
       return 16;
     case UInt32:
     case Int32:
@@ -114,6 +233,8 @@ std::ostream& operator<<(std::ostream& os, const Datatype& type) {
   if (type.isBool()) os << "bool";
   else if (type.isInt()) os << "int" << type.getNumBits() << "_t";
   else if (type.isUInt()) os << "uint" << type.getNumBits() << "_t";
+  else if (type == Datatype::Float16) os << "taco_float16_t";
+  else if (type == Datatype::BFloat16) os << "taco_bfloat16_t";
   else if (type == Datatype::Float32) os << "float";
   else if (type == Datatype::Float64) os << "double";
   else if (type == Datatype::Complex64) os << "float complex";
@@ -135,6 +256,8 @@ std::ostream& operator<<(std::ostream& os, const Datatype::Kind& kind) {
     case Datatype::Int32: os << "Int32"; break;
     case Datatype::Int64: os << "Int64"; break;
     case Datatype::Int128: os << "Int128"; break;
+    case Datatype::Float16: os << "Float16"; break;
+    case Datatype::BFloat16: os << "BFloat16"; break;
     case Datatype::Float32: os << "Float32"; break;
     case Datatype::Float64: os << "Float64"; break;
     case Datatype::Complex64: os << "Complex64"; break;
@@ -194,6 +317,7 @@ Datatype Int128 = Datatype(Datatype::UInt128);
   
 Datatype Float(int bits) {
   switch (bits) {
+    case 16: return Datatype(Datatype::Float16);
     case 32: return Datatype(Datatype::Float32);
     case 64: return Datatype(Datatype::Float64);
     default: 
@@ -202,6 +326,8 @@ Datatype Float(int bits) {
   }
 }
 
+Datatype Float16 = Datatype(Datatype::Float16);
+Datatype BFloat16 = Datatype(Datatype::BFloat16);
 Datatype Float32 = Datatype(Datatype::Float32);
 Datatype Float64 = Datatype(Datatype::Float64);
 
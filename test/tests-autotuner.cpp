@@ -0,0 +1,112 @@
+#include <cstdio>
+#include "test.h"
+#include "taco/tensor.h"
+#include "taco/autotuner.h"
+#include "taco/index_notation/transformations.h"
+#include "taco/parser/schedule_parser.h"
+#include "taco/util/env.h"
+
+using namespace taco;
+
+static const IndexVar i("i"), j("j"), k("k");
+
+static void fillSpMV(Tensor<double>& A, Tensor<double>& x) {
+  for (int r = 0; r < A.getDimension(0); r++) {
+    for (int c = r % 3; c < A.getDimension(1); c += 7) {
+      A.insert({r, c}, (double)(r + c % 5));
+    }
+  }
+  for (int c = 0; c < x.getDimension(0); c++) {
+    x.insert({c}, (double)(c % 4));
+  }
+  A.pack();
+  x.pack();
+}
+
+TEST(autotuner, enumerate_spgemm) {
+  Tensor<double> A("A", {8, 8}, CSR);
+  Tensor<double> B("B", {8, 8}, CSR);
+  Tensor<double> C("C", {8, 8}, CSR);
+  C(i, j) = A(i, k) * B(k, j);
+  IndexStmt stmt = makeConcreteNotation(makeReductionNotation(C.getAssignment()));
+  stmt = reorderLoopsTopologically(stmt);
+
+  AutotuneOptions options;
+  options.maxCandidates = 100;
+  vector<string> schedules = enumerateSchedules(stmt, options);
+  ASSERT_EQ("", schedules[0]);
+
+  // The topological order i,k,j is the only order that iterates over all
+  // three CSR matrices in storage order, and it scatters into the result.
+  ASSERT_TRUE(util::contains(schedules, "precompute(A(i,k)*B(k,j),j,j)"));
+  for (const string& schedule : schedules) {
+    ASSERT_EQ(string::npos, schedule.find("reorder")) << schedule;
+  }
+  IndexStmt scheduled = parser::applySchedule(stmt,
+      parser::ScheduleParser("precompute(A(i,k)*B(k,j),j,j)"));
+  ASSERT_TRUE(isa<Where>(scheduled.as<Forall>().getStmt()));
+}
+
+TEST(autotuner, spmv) {
+  if (should_use_CUDA_codegen()) {
+    return;
+  }
+  Tensor<double> A("A", {60, 50}, CSR);
+  Tensor<double> x("x", {50}, Format({Dense}));
+  fillSpMV(A, x);
+
+  Tensor<double> expected("expected", {60}, Format({Dense}));
+  expected(i) = A(i, j) * x(j);
+  expected.evaluate();
+
+  Tensor<double> y("y", {60}, Format({Dense}));
+  y(i) = A(i, j) * x(j);
+  AutotuneOptions options;
+  options.maxCandidates = 6;
+  options.repetitions = 2;
+  vector<ScheduleTiming> timings;
+  string schedule = autotune(y, options, &timings);
+
+  ASSERT_LE(2u, timings.size());
+  bool found = false;
+  for (auto& timing : timings) {
+    found |= (timing.schedule == schedule);
+  }
+  ASSERT_TRUE(found);
+
+  y.assemble();
+  y.compute();
+  ASSERT_TENSOR_EQ(expected, y);
+}
+
+TEST(autotuner, stored_schedule) {
+  if (should_use_CUDA_codegen()) {
+    return;
+  }
+  Tensor<double> A("A", {40, 30}, CSR);
+  Tensor<double> x("x", {30}, Format({Dense}));
+  fillSpMV(A, x);
+
+  AutotuneOptions options;
+  options.maxCandidates = 3;
+  options.repetitions = 1;
+  options.scheduleFile = util::getTmpdir() + "autotuner_schedules.txt";
+  remove(options.scheduleFile.c_str());
+
+  Tensor<double> y("y", {40}, Format({Dense}));
+  y(i) = A(i, j) * x(j);
+  string schedule = autotune(y, options);
+
+  // The second search finds the stored schedule and does not time anything
+  Tensor<double> z("y", {40}, Format({Dense}));
+  z(i) = A(i, j) * x(j);
+  vector<ScheduleTiming> timings;
+  ASSERT_EQ(schedule, autotune(z, options, &timings));
+  ASSERT_TRUE(timings.empty());
+  z.assemble();
+  z.compute();
+  y.assemble();
+  y.compute();
+  ASSERT_TENSOR_EQ(y, z);
+  remove(options.scheduleFile.c_str());
+}
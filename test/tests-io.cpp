@@ -36,6 +36,19 @@ TEST(io, mtx) {
   ASSERT_TRUE(equals(expected, tensor));
 }
 
+TEST(io, mtx_reduced_precision) {
+  TensorBase tensor = read(testDataDirectory()+"2tensor.mtx", CSR, Float16);
+  ASSERT_EQ(Float16, tensor.getComponentType());
+
+  TensorBase expected(Float16, {32,32}, CSR);
+  expected.insert({0, 0}, float16(101.0f));
+  expected.insert({1, 0}, float16(102.0f));
+  expected.insert({5, 2}, float16(307.0f));
+  expected.pack();
+
+  ASSERT_TRUE(equals(expected, tensor));
+}
+
 TEST(io, tensor) {
   Tensor<double> tensor = read(testDataDirectory()+"3tensor.tns", Sparse);
   ASSERT_EQ(3, tensor.getOrder());
@@ -2,6 +2,7 @@
 #include <codegen/codegen_c.h>
 #include <codegen/codegen_cuda.h>
 #include <fstream>
+#include <atomic>
 #include "test.h"
 #include "test_tensors.h"
 #include "taco/tensor.h"
@@ -9,6 +10,7 @@
 #include "taco/index_notation/transformations.h"
 #include "codegen/codegen.h"
 #include "taco/lower/lower.h"
+#include "taco/codegen/task_runtime.h"
 #include "op_factory.h"
 
 using namespace taco;
@@ -661,6 +663,58 @@ INSTANTIATE_TEST_CASE_P(spgemm, spgemm,
                                std::make_tuple(CSR, CSC, false),
                                std::make_tuple(DCSR, DCSC, false)));
 
+TEST(scheduling_eval, spgemmSymbolicCPU) {
+  if (should_use_CUDA_codegen()) {
+    return;
+  }
+  int NUM_I = 100;
+  int NUM_J = 80;
+  int NUM_K = 90;
+  Tensor<double> A("A", {NUM_I, NUM_J}, CSR);
+  Tensor<double> B("B", {NUM_J, NUM_K}, CSR);
+  for (int i = 0; i < NUM_I; i++) {
+    for (int j = i % 7; j < NUM_J; j += 9) {
+      A.insert({i, j}, (double) (i + j % 3));
+    }
+  }
+  for (int j = 0; j < NUM_J; j++) {
+    for (int k = j % 5; k < NUM_K; k += 11) {
+      B.insert({j, k}, (double) (k - j % 4));
+    }
+  }
+  A.pack();
+  B.pack();
+
+  Tensor<double> C("C", {NUM_I, NUM_K}, CSR);
+  C(i, k) = A(i, j) * B(j, k);
+  IndexStmt stmt = reorderLoopsTopologically(C.getAssignment().concretize());
+  IndexExpr rhs = stmt.as<Forall>().getStmt().as<Forall>().getStmt()
+                      .as<Forall>().getStmt().as<Assignment>().getRhs();
+  TensorVar w("w", Type(Float64, {(size_t)NUM_K}), taco::dense);
+  stmt = stmt.precompute(rhs, k, k, w)
+             .assemble(C.getTensorVar(), AssembleStrategy::Symbolic);
+
+  // Both the symbolic phase that counts the nonzeros of each row and the
+  // numeric phase that inserts them are parallelized over rows
+  Assemble assemble = stmt.as<Assemble>();
+  ASSERT_TRUE(isa<Forall>(assemble.getQueries()));
+  ASSERT_EQ(ParallelUnit::CPUThread,
+            assemble.getQueries().as<Forall>().getParallelUnit());
+  ASSERT_EQ(ParallelUnit::CPUThread,
+            assemble.getCompute().as<Forall>().getParallelUnit());
+
+  C.compile(stmt);
+  C.assemble();
+  C.compute();
+
+  Tensor<double> expected("expected", {NUM_I, NUM_K}, {Dense, Dense});
+  expected(i, k) = A(i, j) * B(j, k);
+  expected.compile();
+  expected.assemble();
+  expected.compute();
+  ASSERT_TENSOR_EQ(expected, C);
+}
+
 TEST(scheduling_eval, spmataddCPU) {
   if (should_use_CUDA_codegen()) {
     return;
@@ -888,6 +942,325 @@ TEST(scheduling_eval, spmvCPU) {
   ASSERT_TENSOR_EQ(expected, y);
 }
 
+TEST(scheduling_eval, spmvCPU_balanced) {
+  if (should_use_CUDA_codegen()) {
+    return;
+  }
+  // Row lengths follow a power law, with empty rows in the middle and at the
+  // end, so equal-row chunks would be badly unbalanced.
+  int NUM_I = 200;
+  int NUM_J = 150;
+  Tensor<double> A("A", {NUM_I, NUM_J}, CSR);
+  Tensor<double> x("x", {NUM_J}, Format({Dense}));
+  Tensor<double> y("y", {NUM_I}, Format({Dense}));
+
+  for (int i = 0; i < NUM_I - 10; i++) {
+    if (i % 7 == 3) {
+      continue;
+    }
+    int rowLength = NUM_J / (i + 1);
+    for (int j = 0; j < rowLength; j++) {
+      A.insert({i, (j * 13 + i) % NUM_J}, (double) (i + j % 5));
+    }
+  }
+  for (int j = 0; j < NUM_J; j++) {
+    x.insert({j}, (double) (j % 4 + 1));
+  }
+  x.pack();
+  A.pack();
+
+  y(i) = A(i, j) * x(j);
+  IndexStmt stmt = y.getAssignment().concretize();
+  stmt = stmt.parallelize(i, ParallelUnit::CPUThreadBalanced,
+                          OutputRaceStrategy::NoRaces);
+  y.compile(stmt);
+  y.assemble();
+  y.compute();
+  ASSERT_NE(std::string::npos, y.getSource().find("taco_binarySearchFirst"));
+
+  Tensor<double> expected("expected", {NUM_I}, Format({Dense}));
+  expected(i) = A(i, j) * x(j);
+  expected.compile(expected.getAssignment().concretize());
+  expected.assemble();
+  expected.compute();
+  ASSERT_TENSOR_EQ(expected, y);
+
+  // With OpenMP, the balanced partitioning is the default for loops over CSR
+  // rows. Without it, loops run on the task runtime.
+  IndexStmt parallelized = parallelizeOuterLoop(y.getAssignment().concretize());
+  ASSERT_TRUE(isa<Forall>(parallelized));
+#if USE_OPENMP
+  ASSERT_EQ(ParallelUnit::CPUThreadBalanced,
+            to<Forall>(parallelized).getParallelUnit());
+#else
+  ASSERT_EQ(ParallelUnit::CPUTask, to<Forall>(parallelized).getParallelUnit());
+#endif
+}
+
+TEST(scheduling_eval, spmvCPU_tasks) {
+  if (should_use_CUDA_codegen()) {
+    return;
+  }
+  int NUM_I = 300;
+  int NUM_J = 200;
+  Tensor<double> A("A", {NUM_I, NUM_J}, CSR);
+  Tensor<double> x("x", {NUM_J}, Format({Dense}));
+  Tensor<double> y("y", {NUM_I}, Format({Dense}));
+
+  for (int i = 0; i < NUM_I; i++) {
+    int rowLength = NUM_J / (i + 1);
+    for (int j = 0; j < rowLength; j++) {
+      A.insert({i, (j * 7 + i) % NUM_J}, (double) (i % 3 + j));
+    }
+  }
+  for (int j = 0; j < NUM_J; j++) {
+    x.insert({j}, (double) (j % 5));
+  }
+  x.pack();
+  A.pack();
+
+  Tensor<double> expected("expected", {NUM_I}, Format({Dense}));
+  expected(i) = A(i, j) * x(j);
+  expected.compile(expected.getAssignment().concretize());
+  expected.assemble();
+  expected.compute();
+
+  taco_set_num_threads(4);
+  y(i) = A(i, j) * x(j);
+  IndexStmt stmt = y.getAssignment().concretize();
+  y.compile(stmt.parallelize(i, ParallelUnit::CPUTask,
+                             OutputRaceStrategy::NoRaces));
+  y.assemble();
+  y.compute();
+  taco_set_num_threads(1);
+
+  ASSERT_NE(std::string::npos, y.getSource().find("taco_parallel_for"));
+  ASSERT_TENSOR_EQ(expected, y);
+}
+
+TEST(scheduling_eval, spmvTransposedCPU_privatized) {
+  if (should_use_CUDA_codegen()) {
+    return;
+  }
+  int NUM_I = 300;
+  int NUM_J = 200;
+  Tensor<double> A("A", {NUM_I, NUM_J}, CSR);
+  Tensor<double> x("x", {NUM_I}, Format({Dense}));
+  Tensor<double> y("y", {NUM_J}, Format({Dense}));
+
+  for (int i = 0; i < NUM_I; i++) {
+    int rowLength = NUM_J / (i + 1);
+    for (int j = 0; j < rowLength; j++) {
+      A.insert({i, (j * 7 + i) % NUM_J}, (double) (i % 3 + j));
+    }
+    x.insert({i}, (double) (i % 5));
+  }
+  x.pack();
+  A.pack();
+
+  Tensor<double> expected("expected", {NUM_J}, Format({Dense}));
+  expected(j) = A(i, j) * x(i);
+  expected.compile(expected.getAssignment().concretize().reorder({i, j}));
+  expected.assemble();
+  expected.compute();
+
+  taco_set_num_threads(4);
+  y(j) = A(i, j) * x(i);
+  IndexStmt stmt = y.getAssignment().concretize().reorder({i, j});
+  y.compile(stmt.parallelize(i, ParallelUnit::CPUThread,
+                             OutputRaceStrategy::Temporary));
+  y.assemble();
+  y.compute();
+  taco_set_num_threads(1);
+
+  ASSERT_NE(std::string::npos, y.getSource().find("y_copies"));
+  ASSERT_TENSOR_EQ(expected, y);
+}
+
+TEST(scheduling_eval, numaFirstTouchCPU) {
+  if (should_use_CUDA_codegen()) {
+    return;
+  }
+  int NUM_I = 1100;
+  int NUM_J = 40;
+  taco_set_numa_policy(NumaPolicy::Interleave);
+  Tensor<double> A("A", {NUM_I, NUM_J}, CSR);
+  for (int i = 0; i < NUM_I; i++) {
+    for (int j = i % 3; j < NUM_J; j += 5) {
+      A.insert({i, j}, (double) (i % 11 + j));
+    }
+  }
+  A.pack();
+  taco_set_numa_policy(NumaPolicy::FirstTouch);
+
+  Tensor<double> expected("expected", {NUM_I, NUM_J}, Format({Dense, Dense}));
+  expected(i, j) = A(i, j) * 2.0;
+  expected.compile(expected.getAssignment().concretize());
+  expected.assemble();
+  expected.compute();
+
+  // The values of B are initialized with the schedule of the loop over i
+  taco_set_num_threads(4);
+  Tensor<double> B("B", {NUM_I, NUM_J}, Format({Dense, Dense}));
+  B(i, j) = A(i, j) * 2.0;
+  IndexStmt stmt = B.getAssignment().concretize();
+  B.compile(stmt.parallelize(i, ParallelUnit::CPUThread,
+                             OutputRaceStrategy::NoRaces));
+  B.assemble();
+  B.compute();
+  taco_set_num_threads(1);
+
+  string source = B.getSource();
+  size_t init = source.find("pB = 0");
+  ASSERT_NE(std::string::npos, init);
+  ASSERT_NE(std::string::npos,
+            source.rfind("#pragma omp parallel for schedule(runtime)", init));
+  ASSERT_TENSOR_EQ(expected, B);
+}
+
+TEST(scheduling_eval, spmvVectorizedCPU) {
+  if (should_use_CUDA_codegen()) {
+    return;
+  }
+  int NUM_I = 100;
+  int NUM_J = 150;
+  Tensor<double> A("A", {NUM_I, NUM_J}, CSR);
+  Tensor<double> x("x", {NUM_J}, Format({Dense}));
+  Tensor<double> y("y", {NUM_I}, Format({Dense}));
+
+  for (int i = 0; i < NUM_I; i++) {
+    for (int j = i % 5; j < NUM_J; j += 1 + i % 4) {
+      A.insert({i, j}, (double) (i + j % 7));
+    }
+  }
+  for (int j = 0; j < NUM_J; j++) {
+    x.insert({j}, (double) (j % 3));
+  }
+  x.pack();
+  A.pack();
+
+  Tensor<double> expected("expected", {NUM_I}, Format({Dense}));
+  expected(i) = A(i, j) * x(j);
+  expected.compile();
+  expected.assemble();
+  expected.compute();
+
+  IndexVar jpos("jpos"), jpos0("jpos0"), jpos1("jpos1");
+  y(i) = A(i, j) * x(j);
+  IndexStmt stmt = y.getAssignment().concretize();
+  stmt = stmt.pos(j, jpos, A(i,j))
+             .split(jpos, jpos0, jpos1, 8)
+             .parallelize(jpos1, ParallelUnit::CPUVector,
+                          OutputRaceStrategy::ParallelReduction);
+  y.compile(stmt);
+  y.assemble();
+  y.compute();
+
+  ASSERT_NE(std::string::npos, y.getSource().find("compute_simd0"));
+  ASSERT_TENSOR_EQ(expected, y);
+}
+
+TEST(scheduling_eval, vectorizedAddCPU) {
+  if (should_use_CUDA_codegen()) {
+    return;
+  }
+  int NUM_I = 61;
+  Tensor<float> a("a", {NUM_I}, Format({Dense}));
+  Tensor<float> b("b", {NUM_I}, Format({Dense}));
+  Tensor<float> y("y", {NUM_I}, Format({Dense}));
+  Tensor<float> expected("expected", {NUM_I}, Format({Dense}));
+  for (int i = 0; i < NUM_I; i++) {
+    a.insert({i}, (float) (i % 9));
+    b.insert({i}, (float) (i % 4) + 0.5f);
+    expected.insert({i}, (float) (i % 9) * ((float) (i % 4) + 0.5f) +
+                         (float) (i % 9));
+  }
+  a.pack();
+  b.pack();
+  expected.pack();
+
+  IndexVar i0("i0"), i1("i1");
+  y(i) = a(i) * b(i) + a(i);
+  IndexStmt stmt = y.getAssignment().concretize();
+  stmt = stmt.split(i, i0, i1, 16)
+             .parallelize(i1, ParallelUnit::CPUVector,
+                          OutputRaceStrategy::IgnoreRaces);
+  y.compile(stmt);
+  y.assemble();
+  y.compute();
+
+  ASSERT_NE(std::string::npos, y.getSource().find("compute_simd0"));
+  ASSERT_TENSOR_EQ(expected, y);
+}
+
+TEST(scheduling_eval, nested_tasks) {
+  if (should_use_CUDA_codegen()) {
+    return;
+  }
+  int NUM_I = 67;
+  int NUM_J = 45;
+  Tensor<double> A("A", {NUM_I, NUM_J}, Format({Dense, Dense}));
+  Tensor<double> B("B", {NUM_I, NUM_J}, Format({Dense, Dense}));
+  Tensor<double> C("C", {NUM_I, NUM_J}, Format({Dense, Dense}));
+  for (int i = 0; i < NUM_I; i++) {
+    for (int j = 0; j < NUM_J; j++) {
+      B.insert({i, j}, (double) (i + j));
+      C.insert({i, j}, (double) (i * j % 7));
+    }
+  }
+  B.pack();
+  C.pack();
+
+  Tensor<double> expected("expected", {NUM_I, NUM_J}, Format({Dense, Dense}));
+  expected(i, j) = B(i, j) + C(i, j);
+  expected.compile(expected.getAssignment().concretize());
+  expected.assemble();
+  expected.compute();
+
+  taco_set_num_threads(3);
+  A(i, j) = B(i, j) + C(i, j);
+  IndexStmt stmt = A.getAssignment().concretize();
+  stmt = stmt.parallelize(i, ParallelUnit::CPUTask, OutputRaceStrategy::NoRaces)
+             .parallelize(j, ParallelUnit::CPUTask, OutputRaceStrategy::NoRaces);
+  A.compile(stmt);
+  A.assemble();
+  A.compute();
+  taco_set_num_threads(1);
+
+  ASSERT_NE(std::string::npos, A.getSource().find("compute_task1"));
+  ASSERT_TENSOR_EQ(expected, A);
+
+  // Reductions cannot be parallelized over tasks without synchronization.
+  Tensor<double> a("a", {NUM_I}, Format({Dense}));
+  a(i) = B(i, j);
+  string reason;
+  stmt = a.getAssignment().concretize();
+  ASSERT_FALSE(Parallelize(j, ParallelUnit::CPUTask, OutputRaceStrategy::Atomics)
+                   .apply(stmt, &reason).defined());
+}
+
+TEST(scheduling_eval, task_runtime_host_loops) {
+  // Host code can share the runtime's threads, including from nested loops.
+  taco_set_num_threads(4);
+  std::atomic<int> iterations(0);
+  std::vector<int> counts(100, 0);
+  TaskRuntime::getInstance().parallelFor(0, 100, [&](int32_t begin, int32_t end) {
+    for (int32_t i = begin; i < end; i++) {
+      TaskRuntime::getInstance().parallelFor(0, i, [&](int32_t b, int32_t e) {
+        iterations += e - b;
+      });
+      counts[i]++;
+    }
+  });
+  ASSERT_EQ(4, TaskRuntime::getInstance().getNumThreads());
+  taco_set_num_threads(1);
+
+  ASSERT_EQ(99 * 100 / 2, iterations.load());
+  for (int count : counts) {
+    ASSERT_EQ(1, count);
+  }
+}
+
 TEST(scheduling_eval, precompute2D) {
   if (should_use_CUDA_codegen()) {
     return;
@@ -1102,6 +1102,11 @@ TEST(scheduling, mergeby) {
     return stmt.mergeby(j, MergeStrategy::TwoFinger);
   });
 
+  // Testing SIMD block merge.
+  test([&](IndexStmt stmt) {
+    return stmt.mergeby(j, MergeStrategy::SimdBlock);
+  });
+
   // Merging a dimension with a dense iterator with Gallop should be no-op.
   test([&](IndexStmt stmt) {
     return stmt.mergeby(i, MergeStrategy::Gallop);
@@ -1125,6 +1130,37 @@ TEST(scheduling, mergeby) {
   });
 }
 
+TEST(scheduling, mergeby_simd_block) {
+  // The vectors have runs of coordinates that the other vector does not have
+  // that are both shorter and longer than a block.
+  auto dim = 1000;
+  Tensor<double> x("x", {dim}, Format({Sparse}));
+  Tensor<double> z("z", {dim}, Format({Sparse}));
+  IndexVar i("i");
+  for (int i = 0; i < dim; i++) {
+    if ((i / 13) % 3 != 0) {
+      x.insert({i}, (double)(i % 7 + 1));
+    }
+    if (i % 5 != 0 && (i / 29) % 2 == 0) {
+      z.insert({i}, (double)(i % 3 + 1));
+    }
+  }
+  x.pack(); z.pack();
+
+  Tensor<double> expected("expected");
+  expected() = x(i) * z(i);
+  expected.evaluate();
+
+  Tensor<double> a("a");
+  a() = x(i) * z(i);
+  IndexStmt stmt = a.getAssignment().concretize();
+  a.compile(stmt.mergeby(i, MergeStrategy::SimdBlock));
+  a.assemble();
+  a.compute();
+  ASSERT_NE(std::string::npos, a.getSource().find("taco_simd_advance("));
+  ASSERT_TENSOR_EQ(expected, a);
+}
+
 TEST(scheduling, mergeby_gallop_error) {
   Tensor<double> x("x", {8}, Format({Sparse}));
   Tensor<double> y("y", {8}, Format({Dense}));
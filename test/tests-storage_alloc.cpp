@@ -115,4 +115,26 @@ INSTANTIATE_TEST_CASE_P(vector_add, alloc,
     )
 );
 
+TEST(storage_alloc, aligned) {
+  Array array = makeArray(type<double>(), 3);
+  ASSERT_EQ(0u, (uintptr_t)array.getData() % 64);
+
+  // The result arrays are grown by reallocating them several times
+  Tensor<double> a("a", {10000}, Format({Sparse}));
+  a(i) = dla("b", Format({Sparse}))(i) + dlb("c", Format({Sparse}))(i);
+  a.setAllocSize(32);
+  packOperands(a);
+  a.compile();
+  a.assemble();
+  a.compute();
+  ASSERT_NE(std::string::npos, a.getSource().find("taco_realloc("));
+
+  TensorStorage storage = a.getStorage();
+  const ModeIndex& modeIndex = storage.getIndex().getModeIndex(0);
+  ASSERT_EQ(0u, (uintptr_t)modeIndex.getIndexArray(0).getData() % 64);
+  ASSERT_EQ(0u, (uintptr_t)modeIndex.getIndexArray(1).getData() % 64);
+  ASSERT_EQ(0u, (uintptr_t)storage.getValues().getData() % 64);
+  ASSERT_COMPONENTS_EQUALS({{{0,6667}, dlab_indices()}}, dlab_values(), a);
+}
+
 }
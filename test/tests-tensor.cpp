@@ -2,7 +2,10 @@
 #include "taco/component.h"
 #include "taco/tensor.h"
 #include "test_tensors.h"
+#include "taco/index_notation/semiring.h"
 
+#include <algorithm>
+#include <limits>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -519,3 +522,721 @@ TEST(tensor, cache) {
   // ability to answer a request for the first query.
   c(i, j) = a(i, j); c.evaluate();
 }
+
+TEST(tensor, dictionary_encoded_values) {
+  Format dcsr = CSR;
+  dcsr.setValueEncoding(ValueEncoding::Dictionary8);
+
+  Tensor<double> A("A", {3, 4}, dcsr);
+  Tensor<double> B("B", {3, 4}, CSR);
+  map<vector<int>,double> vals = {{{0,0}, 0.5}, {{0,3}, 2.0}, {{1,1}, 0.5},
+                                  {{2,0}, 2.0}, {{2,2}, -1.0}};
+  for (auto& val : vals) {
+    A.insert(val.first, val.second);
+    B.insert(val.first, val.second);
+  }
+  A.pack();
+  B.pack();
+
+  TensorStorage storage = A.getStorage();
+  ASSERT_EQ(UInt8, storage.getValues().getType());
+  ASSERT_EQ(5u, storage.getValues().getSize());
+  ASSERT_EQ(Float64, storage.getValueDictionary().getType());
+  ASSERT_EQ(3u, storage.getValueDictionary().getSize());
+  ASSERT_TRUE(equals(A, B));
+
+  Tensor<double> x("x", {4}, Dense);
+  for (int j = 0; j < 4; ++j) {
+    x.insert({j}, (double)(j + 1));
+  }
+  x.pack();
+
+  IndexVar i, j;
+  Tensor<double> y("y", {3}, Dense);
+  y(i) = A(i,j) * x(j);
+  Tensor<double> expected("expected", {3}, Dense);
+  expected(i) = B(i,j) * x(j);
+  ASSERT_TENSOR_EQ(expected, y);
+}
+
+TEST(tensor, pattern_encoded_values) {
+  Format pcsr = CSR;
+  pcsr.setValueEncoding(ValueEncoding::Pattern);
+
+  Tensor<int> A("A", {3, 3}, pcsr);
+  A.insert({0,1}, 1);
+  A.insert({1,0}, 1);
+  A.insert({1,2}, 1);
+  A.insert({2,2}, 1);
+  A.pack();
+  ASSERT_EQ(0u, A.getStorage().getValues().getSize());
+
+  Tensor<int> x("x", {3}, Dense);
+  x.insert({0}, 1);
+  x.insert({1}, 10);
+  x.insert({2}, 100);
+  x.pack();
+
+  IndexVar i, j;
+  Tensor<int> y("y", {3}, Dense);
+  y(i) = A(i,j) * x(j);
+
+  Tensor<int> expected("expected", {3}, Dense);
+  expected.insert({0}, 10);
+  expected.insert({1}, 101);
+  expected.insert({2}, 100);
+  expected.pack();
+  ASSERT_TENSOR_EQ(expected, y);
+}
+
+TEST(tensor, encoded_result_error) {
+  Format dcsr = CSR;
+  dcsr.setValueEncoding(ValueEncoding::Dictionary16);
+
+  Tensor<double> A("A", {3, 3}, CSR);
+  Tensor<double> B("B", {3, 3}, dcsr);
+  IndexVar i, j;
+  B(i,j) = A(i,j);
+  ASSERT_THROW(B.compile(), taco::TacoException);
+}
+
+TEST(tensor, delta_compressed_coordinates) {
+  Tensor<double> A("A", {4, 200}, {Dense, DeltaCompressed});
+  Tensor<double> B("B", {4, 200}, CSR);
+  Tensor<double> C("C", {4, 200}, {DeltaCompressed, DeltaCompressed});
+  for (int i = 0; i < 4; i += (i == 1) ? 2 : 1) {
+    for (int j = i; j < 200; j += 3 + i * 7) {
+      A.insert({i, j}, (double)(i + j));
+      B.insert({i, j}, (double)(i + j));
+      C.insert({i, j}, (double)(i + j));
+    }
+  }
+  A.pack();
+  B.pack();
+  C.pack();
+
+  ModeIndex modeIndex = A.getStorage().getIndex().getModeIndex(1);
+  ASSERT_EQ(3, modeIndex.numIndexArrays());
+  ASSERT_EQ(UInt32, modeIndex.getIndexArray(1).getType());
+  ASSERT_LT(A.getStorage().getSizeInBytes(), B.getStorage().getSizeInBytes());
+  ASSERT_TRUE(equals(A, B));
+  ASSERT_TRUE(equals(C, B));
+
+  Tensor<double> x("x", {200}, Dense);
+  for (int j = 0; j < 200; ++j) {
+    x.insert({j}, (double)(j % 7));
+  }
+  x.pack();
+
+  IndexVar i, j;
+  Tensor<double> expected("expected", {4}, Dense);
+  expected(i) = B(i,j) * x(j);
+  Tensor<double> y("y", {4}, Dense);
+  y(i) = A(i,j) * x(j);
+  ASSERT_TENSOR_EQ(expected, y);
+  Tensor<double> z("z", {4}, Dense);
+  z(i) = C(i,j) * x(j);
+  ASSERT_TENSOR_EQ(expected, z);
+
+  Tensor<double> D("D", {4, 200}, {Dense, DeltaCompressed});
+  D(i,j) = B(i,j);
+  ASSERT_THROW(D.compile(), taco::TacoException);
+}
+
+TEST(tensor, statistics) {
+  Tensor<double> A("A", {4, 5}, {Dense, Dense});
+  ASSERT_FALSE(A.getStatistics().defined());
+  A.insert({0,0}, 1.0);
+  A.insert({0,3}, 2.0);
+  A.insert({1,1}, 3.0);
+  A.insert({3,0}, 4.0);
+  A.insert({3,2}, 5.0);
+  A.insert({3,4}, 6.0);
+  A.pack();
+
+  const TensorStatistics& stats = A.getStatistics();
+  ASSERT_TRUE(stats.defined());
+  ASSERT_EQ(6u, stats.getNumNonzeros());
+  ASSERT_EQ(3u, stats.getNumNonEmptySlices(0));
+  ASSERT_EQ(5u, stats.getNumNonEmptySlices(1));
+  ASSERT_DOUBLE_EQ(0.25, stats.getEmptySliceFraction(0));
+  ASSERT_EQ(3u, stats.getMaxSliceNonzeros(0));
+  ASSERT_EQ(2u, stats.getMaxSliceNonzeros(1));
+  ASSERT_EQ(3u, stats.getNumFibers(0));
+  ASSERT_EQ(6u, stats.getNumFibers(1));
+  ASSERT_DOUBLE_EQ(0.75, stats.getLevelDensity(0));
+  ASSERT_DOUBLE_EQ(0.4, stats.getLevelDensity(1));
+}
+
+TEST(tensor, suggest_format) {
+  Tensor<double> A("A", {4, 5}, CSR);
+  A.insert({0,0}, 1.0);
+  A.insert({0,3}, 2.0);
+  A.insert({1,1}, 3.0);
+  A.insert({3,0}, 4.0);
+  A.insert({3,2}, 5.0);
+  A.insert({3,4}, 6.0);
+  A.pack();
+  ASSERT_EQ(CSR, suggestFormat(A));
+
+  Tensor<double> B("B", {3, 3}, CSR);
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      B.insert({i,j}, 1.0);
+    }
+  }
+  B.pack();
+  ASSERT_EQ(Format({Dense, Dense}), suggestFormat(B));
+
+  Tensor<double> C("C", {1000, 1000}, CSR);
+  for (int i = 0; i < 10; ++i) {
+    for (int j = 0; j < 5; ++j) {
+      C.insert({i * 100, j * 7}, 1.0);
+    }
+  }
+  C.pack();
+  ASSERT_EQ(DCSR, suggestFormat(C));
+
+  Tensor<double> D("D", {1000, 1000}, CSR);
+  for (int i = 0; i < 10; ++i) {
+    D.insert({i * 100, i}, 1.0);
+  }
+  D.pack();
+  ASSERT_EQ(COO(2, true, true, false, {0,1}), suggestFormat(D));
+
+  // The mode ordering follows the loops over the expression that reads A
+  IndexVar i, j;
+  Tensor<double> x("x", {4}, Dense);
+  Tensor<double> y("y", {5}, Dense);
+  y(j) = A(i,j) * x(i);
+  ASSERT_EQ(vector<int>({1,0}),
+            suggestFormat(A, y.getAssignment().getRhs()).getModeOrdering());
+}
+
+TEST(tensor, automatic_format_selection) {
+  Tensor<double> A("A", {1000, 100}, {Dense, Dense});
+  Tensor<double> B("B", {1000, 100}, CSR);
+  for (int i = 0; i < 10; ++i) {
+    for (int j = 0; j < 5; ++j) {
+      A.insert({i * 100, j * 7}, (double)(i + j));
+      B.insert({i * 100, j * 7}, (double)(i + j));
+    }
+  }
+  A.pack();
+  B.pack();
+  A.setAutomaticFormatSelection(true);
+
+  Tensor<double> x("x", {100}, Dense);
+  for (int j = 0; j < 100; ++j) {
+    x.insert({j}, (double)j);
+  }
+  x.pack();
+
+  IndexVar i, j;
+  Tensor<double> y("y", {1000}, Dense);
+  y(i) = A(i,j) * x(j);
+  y.evaluate();
+  ASSERT_EQ(DCSR, A.getFormat());
+  ASSERT_EQ(DCSR, A.getTensorVar().getFormat());
+  ASSERT_TRUE(equals(A, B));
+
+  Tensor<double> expected("expected", {1000}, Dense);
+  expected(i) = B(i,j) * x(j);
+  ASSERT_TENSOR_EQ(expected, y);
+}
+
+TEST(tensor, convert) {
+  Tensor<double> A("A", {3, 4}, CSR);
+  Tensor<double> expected("expected", {3, 4}, CSC);
+  for (auto& component : vector<pair<vector<int>,double>>(
+           {{{0,1}, 1.0}, {{2,0}, 2.0}, {{2,3}, 3.0}})) {
+    A.insert(component.first, component.second);
+    expected.insert(component.first, component.second);
+  }
+  A.pack();
+  expected.pack();
+
+  TensorBase B = A.convert(CSC);
+  ASSERT_EQ(CSC, B.getFormat());
+  ASSERT_TRUE(equals(expected, B));
+  ASSERT_TRUE(B == A.convert(CSC));
+  ASSERT_TRUE(A == A.convert(CSR));
+
+  A.insert({1,1}, 4.0);
+  A.pack();
+  expected.insert({1,1}, 4.0);
+  expected.pack();
+  ASSERT_FALSE(B == A.convert(CSC));
+  ASSERT_TRUE(equals(expected, A.convert(CSC)));
+}
+
+TEST(tensor, operand_layout_conflict) {
+  Tensor<double> B("B", {50, 40}, CSR);
+  Tensor<double> C("C", {50, 40}, CSC);
+  Tensor<double> D("D", {50, 40}, CSR);
+  for (int i = 0; i < 50; ++i) {
+    for (int j = i % 3; j < 40; j += 7) {
+      B.insert({i, j}, (double)(i + j));
+      C.insert({i, (j + i) % 40}, (double)(i * j));
+      D.insert({i, (j + i) % 40}, (double)(i * j));
+    }
+  }
+  B.pack();
+  C.pack();
+  D.pack();
+
+  // The formats of B and C need the i and j loops nested in different orders,
+  // so C is read from a copy in row-major order.
+  IndexVar i("i"), j("j"), k("k");
+  Tensor<double> A("A", {50, 40}, CSR);
+  A(i,j) = B(i,j) + C(i,j);
+  auto formats = suggestOperandFormats(A.getAssignment(), {B, C});
+  ASSERT_EQ(1u, formats.size());
+  ASSERT_EQ(CSR, formats.at(C.getTensorVar()));
+
+  Tensor<double> expected("expected", {50, 40}, CSR);
+  expected(i,j) = B(i,j) + D(i,j);
+  ASSERT_TENSOR_EQ(expected, A);
+  ASSERT_EQ(CSC, C.getFormat());
+
+  // Column-major matrix-vector multiplication scatters into the dense result,
+  // which is cheaper than converting the matrix.
+  Tensor<double> x("x", {40}, Dense);
+  for (int j = 0; j < 40; ++j) {
+    x.insert({j}, (double)j);
+  }
+  x.pack();
+  Tensor<double> y("y", {50}, Dense);
+  y(i) = C(i,j) * x(j);
+  ASSERT_TRUE(suggestOperandFormats(y.getAssignment(), {C, x}).empty());
+
+  // Sparse matrix multiplication scatters rows into a workspace rather than
+  // converting the right operand and computing inner products.
+  Tensor<double> E("E", {40, 30}, CSR);
+  for (int k = 0; k < 30; ++k) {
+    E.insert({k, k}, 1.0);
+    E.insert({(k * 7) % 40, k}, 2.0);
+  }
+  E.pack();
+  Tensor<double> F("F", {50, 30}, CSR);
+  F(i,k) = B(i,j) * E(j,k);
+  ASSERT_TRUE(suggestOperandFormats(F.getAssignment(), {B, E}).empty());
+}
+
+TEST(tensor, tiled_dense) {
+  Format tiled = Tiled({2, 4});
+  ASSERT_EQ(tiled, Tiled({2, 4}));
+  ASSERT_NE(tiled, Tiled({4, 2}));
+  ASSERT_EQ(4, getTileSize(tiled.getModeFormats()[1]));
+
+  Tensor<double> A("A", {5, 7}, tiled);
+  Tensor<double> B("B", {5, 7}, {Dense, Dense});
+  for (int i = 0; i < 5; ++i) {
+    for (int j = 0; j < 7; ++j) {
+      A.insert({i, j}, (double)(i * 7 + j));
+      B.insert({i, j}, (double)(i * 7 + j));
+    }
+  }
+  A.pack();
+  B.pack();
+
+  // Rows and columns are padded to 6 and 8, and the components of (1,5) are
+  // stored in the second 2x4 tile, at offset 1*4 + 1 within the tile.
+  Array values = A.getStorage().getValues();
+  ASSERT_EQ(48u, values.getSize());
+  ASSERT_DOUBLE_EQ(12.0, ((double*)values.getData())[13]);
+  ASSERT_TRUE(equals(A, B));
+
+  IndexVar i, j;
+  Tensor<double> x("x", {7}, Dense);
+  for (int j = 0; j < 7; ++j) {
+    x.insert({j}, (double)(j % 3));
+  }
+  x.pack();
+  Tensor<double> y("y", {5}, Dense);
+  y(i) = A(i,j) * x(j);
+  Tensor<double> expected("expected", {5}, Dense);
+  expected(i) = B(i,j) * x(j);
+  ASSERT_TENSOR_EQ(expected, y);
+
+  Tensor<double> C("C", {5, 7}, Tiled({4, 2}, {1, 0}));
+  C(i,j) = A(i,j) + B(i,j);
+  Tensor<double> D("D", {5, 7}, Format({Dense, Dense}, {1, 0}));
+  D(i,j) = B(i,j) + B(i,j);
+  ASSERT_TENSOR_EQ(D, C);
+
+  // Larger modes have their tile grid computed at runtime
+  Tensor<double> E("E", {20, 33}, Tiled({8, 8}));
+  Tensor<double> F("F", {20, 33}, {Dense, Dense});
+  for (int i = 0; i < 20; ++i) {
+    for (int j = i % 5; j < 33; j += 4) {
+      E.insert({i, j}, (double)(i - j));
+      F.insert({i, j}, (double)(i - j));
+    }
+  }
+  E.pack();
+  F.pack();
+  ASSERT_EQ(24u * 40u, E.getStorage().getValues().getSize());
+  ASSERT_TRUE(equals(E, F));
+  Tensor<double> G("G", {20, 33}, Tiled({8, 8}));
+  G(i,j) = E(i,j) * F(i,j);
+  Tensor<double> H("H", {20, 33}, {Dense, Dense});
+  H(i,j) = F(i,j) * F(i,j);
+  ASSERT_TENSOR_EQ(H, G);
+}
+
+TEST(tensor, fusion) {
+  Tensor<double> A("A", {6, 5}, CSR);
+  Tensor<double> B("B", {5, 7}, CSC);
+  Tensor<double> D("D", {6, 7}, {Dense, Dense});
+  for (int i = 0; i < 6; ++i) {
+    for (int k = i % 2; k < 5; k += 2) {
+      A.insert({i, k}, (double)(i + k));
+    }
+    for (int j = 0; j < 7; ++j) {
+      D.insert({i, j}, (double)(i * j));
+    }
+  }
+  for (int k = 0; k < 5; ++k) {
+    for (int j = k % 3; j < 7; j += 3) {
+      B.insert({k, j}, (double)(k - j));
+    }
+  }
+  A.pack();
+  B.pack();
+  D.pack();
+
+  IndexVar i("i"), j("j"), k("k");
+  taco_set_fusion(true);
+  Tensor<double> T("T", {6, 7}, {Dense, Dense});
+  T(i,j) = A(i,k) * B(k,j);
+  Tensor<double> C("C", {6, 7}, {Dense, Dense});
+  C(i,j) = T(i,j) + D(i,j);
+  Tensor<double> S("S", {6, 5}, CSR);
+  S(i,k) = A(i,k) * 2.0;
+  Tensor<double> R("R", {6, 5}, CSR);
+  R(i,k) = S(i,k) + A(i,k);
+  C.evaluate();
+  R.evaluate();
+
+  // Producers whose sparse operands store reduced modes above the others
+  // are not fused
+  Tensor<double> BT("BT", {5, 7}, CSR);
+  BT(k,j) = B(k,j);
+  BT.evaluate();
+  Tensor<double> U("U", {6, 7}, {Dense, Dense});
+  U(i,j) = A(i,k) * BT(k,j);
+  Tensor<double> V("V", {6, 7}, {Dense, Dense});
+  V(i,j) = U(i,j) + D(i,j);
+  V.evaluate();
+  ASSERT_FALSE(U.needsCompute());
+  ASSERT_TENSOR_EQ(C, V);
+  taco_set_fusion(false);
+
+  // The intermediates were computed as part of the results that read them
+  ASSERT_TRUE(T.needsCompute());
+  ASSERT_TRUE(S.needsCompute());
+  ASSERT_EQ(std::string::npos, C.getSource().find("T_vals"));
+  ASSERT_EQ(std::string::npos, R.getSource().find("S_vals"));
+
+  Tensor<double> expectedC("expectedC", {6, 7}, {Dense, Dense});
+  expectedC(i,j) = A(i,k) * B(k,j) + D(i,j);
+  ASSERT_TENSOR_EQ(expectedC, C);
+  Tensor<double> expectedR("expectedR", {6, 5}, CSR);
+  expectedR(i,k) = A(i,k) * 2.0 + A(i,k);
+  ASSERT_TENSOR_EQ(expectedR, R);
+
+  // Intermediates are computed on their own when they are read
+  Tensor<double> expectedT("expectedT", {6, 7}, {Dense, Dense});
+  expectedT(i,j) = A(i,k) * B(k,j);
+  ASSERT_TENSOR_EQ(expectedT, T);
+  ASSERT_FALSE(T.needsCompute());
+}
+
+TEST(tensor, masked_assignment) {
+  Tensor<double> M("M", {6, 7}, CSR);
+  Tensor<double> A("A", {6, 4}, {Dense, Dense});
+  Tensor<double> B("B", {4, 7}, {Dense, Dense});
+  for (int i = 0; i < 6; ++i) {
+    M.insert({i, (i * 3) % 7}, 1.0);
+    M.insert({i, (i * 5 + 1) % 7}, 2.0);
+    for (int k = 0; k < 4; ++k) {
+      A.insert({i, k}, (double)(i + k));
+    }
+  }
+  for (int k = 0; k < 4; ++k) {
+    for (int j = 0; j < 7; ++j) {
+      B.insert({k, j}, (double)(k - j));
+    }
+  }
+  M.pack();
+  A.pack();
+  B.pack();
+
+  IndexVar i("i"), j("j"), k("k");
+  Tensor<double> P("P", {6, 7}, {Dense, Dense});
+  P(i,j) = A(i,k) * B(k,j);
+  P.evaluate();
+
+  Tensor<double> expected("expected", {6, 7}, CSR);
+  Tensor<double> expectedComplement("expectedComplement", {6, 7}, CSR);
+  Tensor<double> expectedAccumulate("expectedAccumulate", {6, 7},
+                                    {Dense, Dense});
+  Tensor<double> C("C", {6, 7}, CSR);
+  Tensor<double> D("D", {6, 7}, {Dense, Dense});
+  Tensor<double> E("E", {6, 7}, CSR);
+  Tensor<double> F("F", {6, 7}, {Dense, Dense});
+  for (int i = 0; i < 6; ++i) {
+    for (int j = 0; j < 7; ++j) {
+      const bool sampled = (j == (i * 3) % 7 || j == (i * 5 + 1) % 7);
+      const double product = P.at({i, j});
+      if (sampled) {
+        expected.insert({i, j}, product);
+      } else {
+        expectedComplement.insert({i, j}, product);
+      }
+      expectedAccumulate.insert({i, j}, sampled ? 10.0 + product : 10.0);
+      F.insert({i, j}, 10.0);
+    }
+  }
+  expected.pack();
+  expectedComplement.pack();
+  expectedAccumulate.pack();
+  F.pack();
+
+  // Sampled dense-dense matrix multiplication computes only the entries
+  // stored in the mask, with the mask's free variables iterated first
+  C(i,j) = Mask(M(i,j))(A(i,k) * B(k,j));
+  ASSERT_TRUE(C.getAssignment().getMask().defined());
+  ASSERT_FALSE(C.getAssignment().getMask().isComplemented());
+  C.evaluate();
+  ASSERT_TENSOR_EQ(expected, C);
+
+  D(i,j) = Mask(M(i,j), true)(A(i,k) * B(k,j));
+  ASSERT_TRUE(D.getAssignment().getMask().isComplemented());
+  D.evaluate();
+  ASSERT_TENSOR_EQ(expectedComplement, D);
+
+  Assignment masked(E(i,j), A(i,k) * B(k,j), Mask(M(i,j)));
+  ASSERT_TRUE(masked.getMask().defined());
+  ASSERT_FALSE(masked.getMask().accumulates());
+  E(i,j) = masked.getRhs();
+  E.evaluate();
+  ASSERT_TENSOR_EQ(expected, E);
+
+  // A masked compound assignment accumulates into the result and leaves the
+  // entries outside the mask unchanged
+  F(i,j) += Mask(M(i,j))(A(i,k) * B(k,j));
+  ASSERT_TRUE(F.getAssignment().getMask().accumulates());
+  F.evaluate();
+  ASSERT_TENSOR_EQ(expectedAccumulate, F);
+
+  ASSERT_FALSE(Assignment(E(i,j), P(i,j)).getMask().defined());
+}
+
+TEST(tensor, semiring) {
+  const double inf = std::numeric_limits<double>::infinity();
+  const int n = 8;
+  Tensor<double> A("A", {n, n}, CSR, inf);
+  Tensor<double> d("d", {n}, {Dense}, inf);
+  Tensor<double> B("B", {n, n}, CSR);
+  Tensor<double> x("x", {n}, {Dense});
+  for (int i = 0; i < n; ++i) {
+    for (int j = i % 3; j < n; j += 3) {
+      A.insert({i, j}, (double)(i + 2 * j));
+    }
+    for (int j = i % 2; j < n; j += 4) {
+      B.insert({i, j}, 1.0);
+    }
+    d.insert({i}, (i % 2) ? (double)i : inf);
+    if (i % 3 == 0) {
+      x.insert({i}, 1.0);
+    }
+  }
+  A.pack();
+  d.pack();
+  B.pack();
+  x.pack();
+
+  Tensor<double> expectedMinPlus("expectedMinPlus", {n}, {Dense}, inf);
+  Tensor<double> expectedReachable("expectedReachable", {n}, {Dense});
+  for (int i = 0; i < n; ++i) {
+    double shortest = inf;
+    for (int j = i % 3; j < n; j += 3) {
+      shortest = std::min(shortest, (i + 2 * j) + ((j % 2) ? (double)j : inf));
+    }
+    expectedMinPlus.insert({i}, shortest);
+    for (int j = i % 2; j < n; j += 4) {
+      if (j % 3 == 0) {
+        expectedReachable.insert({i}, 1.0);
+      }
+    }
+  }
+  expectedMinPlus.pack();
+  expectedReachable.pack();
+
+  // A relaxation step of Bellman-Ford starts each reduction from infinity,
+  // the identity of min, rather than from zero
+  IndexVar i("i"), j("j");
+  Tensor<double> y("y", {n}, {Dense}, inf);
+  y(i) = Semiring::minPlus(Float64)(sum(j, A(i,j) * d(j)));
+  y.evaluate();
+  ASSERT_TENSOR_EQ(expectedMinPlus, y);
+
+  // Boolean reductions stop at the first true value
+  Tensor<double> z("z", {n}, {Dense});
+  z(i) = Semiring::orAnd(Float64)(sum(j, B(i,j) * x(j)));
+  z.evaluate();
+  ASSERT_TENSOR_EQ(expectedReachable, z);
+  ASSERT_NE(z.getSource().find("break"), std::string::npos);
+
+  Tensor<double> w("w", {n}, {Dense});
+  w(i) = Semiring::maxTimes(Float64)(sum(j, B(i,j) * x(j)));
+  w.evaluate();
+  ASSERT_TENSOR_EQ(expectedReachable, w);
+
+  Tensor<double> v("v", {n}, {Dense}, inf);
+  Assignment assignment(v(i), A(i,j) * d(j), Semiring::minPlus(Float64));
+  ASSERT_TRUE(isa<Reduction>(assignment.getRhs()));
+  v(i) = assignment.getRhs();
+  v.evaluate();
+  ASSERT_TENSOR_EQ(expectedMinPlus, v);
+}
+
+TEST(tensor, reduced_precision) {
+  const int n = 40;
+  Tensor<float16> A("A", {n, n}, CSR);
+  Tensor<float16> x("x", {n}, {Dense});
+  Tensor<bfloat16> B("B", {n, n}, CSR);
+  Tensor<bfloat16> z("z", {n}, {Dense});
+  for (int i = 0; i < n; ++i) {
+    for (int j = i % 3; j < n; j += 3) {
+      A.insert({i, j}, float16(0.25f * (i + j)));
+      B.insert({i, j}, bfloat16(0.25f * (i + j)));
+    }
+    x.insert({i}, float16(1.0f + i % 5));
+    z.insert({i}, bfloat16(1.0f + i % 5));
+  }
+  A.pack();
+  x.pack();
+  B.pack();
+  z.pack();
+
+  // Products and sums are computed in float and rounded once when stored
+  Tensor<float16> expected("expected", {n}, {Dense});
+  Tensor<bfloat16> expectedB("expectedB", {n}, {Dense});
+  for (int i = 0; i < n; ++i) {
+    float sum = 0.0f;
+    for (int j = i % 3; j < n; j += 3) {
+      sum += 0.25f * (i + j) * (1.0f + j % 5);
+    }
+    expected.insert({i}, float16(sum));
+    expectedB.insert({i}, bfloat16(sum));
+  }
+  expected.pack();
+  expectedB.pack();
+
+  IndexVar i("i"), j("j");
+  Tensor<float16> y("y", {n}, {Dense});
+  y(i) = A(i,j) * x(j);
+  ASSERT_EQ(Float32, y.getAccumulationType());
+  y.evaluate();
+  ASSERT_TENSOR_EQ(expected, y);
+  ASSERT_NE(y.getSource().find("taco_float_to_float16("), std::string::npos);
+
+  Tensor<bfloat16> w("w", {n}, {Dense});
+  w.setAccumulationType(Float64);
+  w(i) = B(i,j) * z(j);
+  w.evaluate();
+  ASSERT_TENSOR_EQ(expectedB, w);
+  ASSERT_NE(w.getSource().find("double t"), std::string::npos);
+
+  ASSERT_EQ(float16(0.25f * 5), A.at({1, 4}));
+}
+
+TEST(tensor, constant_dimensions) {
+  const int n = 50;
+  Tensor<double> B("B", {n, n}, CSR);
+  Tensor<double> C("C", {n, 16}, {Dense, Dense});
+  Tensor<double> expected("expected", {n, 16}, {Dense, Dense});
+  for (int i = 0; i < n; ++i) {
+    B.insert({i, (i * 7) % n}, 1.0 + i);
+    for (int k = 0; k < 16; ++k) {
+      C.insert({i, k}, (double)(k + i));
+    }
+  }
+  B.pack();
+  C.pack();
+  for (int i = 0; i < n; ++i) {
+    for (int k = 0; k < 16; ++k) {
+      expected.insert({i, k}, (1.0 + i) * ((i * 7) % n + k));
+    }
+  }
+  expected.pack();
+
+  IndexVar i("i"), j("j"), k("k");
+  Tensor<double> A("A", {n, 16}, {Dense, Dense});
+  A(i,k) = B(i,j) * C(j,k);
+  A.evaluate();
+  ASSERT_TENSOR_EQ(expected, A);
+
+  // The rank loop has a constant trip count and dense strides are constants
+  const std::string source = A.getSource();
+  ASSERT_NE(source.find("< 16;"), std::string::npos);
+  ASSERT_EQ(source.find("_dimension"), std::string::npos);
+}
+
+static void testDenseProducts(int n) {
+  Tensor<double> B("B", {n, n}, {Dense, Dense});
+  Tensor<double> C("C", {n, n}, Format({Dense, Dense}, {1, 0}));
+  Tensor<double> x("x", {n}, {Dense});
+  Tensor<double> expectedA("expectedA", {n, n}, {Dense, Dense});
+  Tensor<double> expectedY("expectedY", {n}, {Dense});
+  for (int i = 0; i < n; ++i) {
+    for (int j = 0; j < n; ++j) {
+      B.insert({i, j}, (double)((i + 2 * j) % 7));
+      C.insert({i, j}, (double)((3 * i + j) % 5));
+    }
+    x.insert({i}, (double)(i % 3));
+  }
+  B.pack();
+  C.pack();
+  x.pack();
+  for (int i = 0; i < n; ++i) {
+    double y = 0.0;
+    for (int j = 0; j < n; ++j) {
+      double a = 0.0;
+      for (int k = 0; k < n; ++k) {
+        a += ((i + 2 * k) % 7) * ((3 * k + j) % 5);
+      }
+      expectedA.insert({i, j}, a);
+      y += ((i + 2 * j) % 7) * (j % 3);
+    }
+    expectedY.insert({i}, y);
+  }
+  expectedA.pack();
+  expectedY.pack();
+
+  IndexVar i("i"), j("j"), k("k");
+  Tensor<double> A("A", {n, n}, {Dense, Dense});
+  A(i,j) = B(i,k) * C(k,j);
+  A.evaluate();
+  ASSERT_TENSOR_EQ(expectedA, A);
+  ASSERT_NE(A.getSource().find("taco_dgemm("), std::string::npos);
+
+  Tensor<double> y("y", {n}, {Dense});
+  y(i) = B(i,j) * x(j);
+  y.evaluate();
+  ASSERT_TENSOR_EQ(expectedY, y);
+  ASSERT_NE(y.getSource().find("taco_dgemv("), std::string::npos);
+}
+
+TEST(tensor, blas_offload) {
+  // Without a BLAS the kernels fall back to their loops
+  taco_set_blas("");
+  testDenseProducts(24);
+  if (taco_set_blas("libopenblas.so.0") || taco_set_blas("libblas.so.3")) {
+    testDenseProducts(25);
+    taco_set_blas("");
+  }
+}
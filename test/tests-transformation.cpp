@@ -5,6 +5,7 @@
 #include "taco/index_notation/transformations.h"
 #include "taco/index_notation/index_notation.h"
 #include "taco/util/name_generator.h"
+#include "taco/parser/einsum_parser.h"
 #include "taco/tensor.h"
 
 using namespace taco;
@@ -348,4 +349,120 @@ TEST(schedule, workspace_spmspm) {
   ASSERT_TENSOR_EQ(E,A);
 }
 
+TEST(schedule, common_subexpressions) {
+  if (should_use_CUDA_codegen()) {
+    return;
+  }
+  Tensor<double> B("B", {8,6}, CSR);
+  Tensor<double> E("E", {8,6}, CSR);
+  Tensor<double> c("c", {6}, Format({dense}));
+  Tensor<double> d("d", {6}, Format({dense}));
+  Tensor<double> e("e", {8}, Format({dense}));
+  for (int r = 0; r < 8; r++) {
+    for (int s = r % 3; s < 6; s += 2) {
+      B.insert({r,s}, (double)(r + s));
+    }
+    for (int s = r % 2; s < 6; s += 3) {
+      E.insert({r,s}, (double)(r - s));
+    }
+    e.insert({r}, (double)(r % 4 + 1));
+  }
+  for (int s = 0; s < 6; s++) {
+    c.insert({s}, (double)s);
+    d.insert({s}, (double)(s % 3) + 0.5);
+  }
+  B.pack();
+  E.pack();
+  c.pack();
+  d.pack();
+  e.pack();
+
+  Tensor<double> expected("expected", {8,6}, Format({dense,dense}));
+  for (int r = 0; r < 8; r++) {
+    for (int s = 0; s < 6; s++) {
+      double cd = c.at({s}) + d.at({s});
+      double value = B.at({r,s}) * cd + E.at({r,s}) * cd +
+                     e.at({r}) * e.at({r}) * B.at({r,s});
+      if (value != 0.0) {
+        expected.insert({r,s}, value);
+      }
+    }
+  }
+  expected.pack();
+
+  Tensor<double> A("A", {8,6}, Format({dense,dense}));
+  A(i,j) = B(i,j) * (c(j) + d(j)) + E(i,j) * (c(j) + d(j)) +
+           e(i) * e(i) * B(i,j);
+
+  // c(j)+d(j) is precomputed into a vector before the loops and e(i)*e(i)
+  // into a scalar inside the loop over i
+  IndexStmt stmt = makeConcreteNotation(A.getAssignment());
+  stmt = eliminateCommonSubexpressions(stmt);
+  ASSERT_TRUE(isa<Where>(stmt));
+  IndexStmt consumer = to<Where>(stmt).getConsumer();
+  ASSERT_TRUE(isa<Forall>(consumer));
+  ASSERT_TRUE(isa<Where>(to<Forall>(consumer).getStmt()));
+  ASSERT_EQ(2u, getTemporaries(stmt).size());
+
+  A.evaluate();
+  ASSERT_TENSOR_EQ(expected, A);
+}
+
+TEST(schedule, contraction_order) {
+  if (should_use_CUDA_codegen()) {
+    return;
+  }
+  IndexVar l("l");
+  Tensor<double> B("B", {8,10}, Format({dense,dense}));
+  Tensor<double> C("C", {10,12}, Format({dense,dense}));
+  Tensor<double> D("D", {12,6}, Format({dense,dense}));
+  for (int r = 0; r < 12; r++) {
+    for (int s = 0; s < 12; s++) {
+      if (r < 8 && s < 10) {
+        B.insert({r,s}, (double)((r + s) % 5));
+      }
+      if (r < 10) {
+        C.insert({r,s}, (double)(r - s % 4));
+      }
+      if (s < 6) {
+        D.insert({r,s}, (double)(r * s % 7));
+      }
+    }
+  }
+  B.pack();
+  C.pack();
+  D.pack();
+
+  Tensor<double> expected("expected", {8,6}, Format({dense,dense}));
+  expected(i,l) = B(i,j) * C(j,k) * D(k,l);
+  expected.evaluate();
+
+  // Contracting C and D first takes 10*12*6 + 8*10*6 multiplications, which
+  // is far fewer than the 8*10*12*6 of a single loop nest
+  IndexStmt stmt = optimizeContractionOrder(expected.getAssignment());
+  ASSERT_TRUE(isa<Where>(stmt));
+  vector<TensorVar> temporaries = getTemporaries(stmt);
+  ASSERT_EQ(1u, temporaries.size());
+  ASSERT_EQ(Type(Float64, {10,6}), temporaries[0].getType());
+
+  vector<TensorBase> operands = {B, C, D};
+  Format format;
+  parser::EinsumParser parser("ij,jk,kl->il", operands, format, Float64, true);
+  parser.parse();
+  TensorBase A = parser.getResultTensor();
+  A.evaluate();
+  ASSERT_TENSOR_EQ(expected, A);
+
+  // A single loop nest is cheaper when the first operand is very sparse
+  Tensor<double> S("S", {8,10}, CSR);
+  S.insert({1,2}, 1.0);
+  S.insert({5,7}, 2.0);
+  S.pack();
+  Tensor<double> R("R", {8,6}, Format({dense,dense}));
+  R(i,l) = S(i,j) * C(j,k) * D(k,l);
+  map<TensorVar,size_t> nonzeros = {{S.getTensorVar(), 2}};
+  ASSERT_TRUE(isa<Assignment>(optimizeContractionOrder(R.getAssignment(),
+                                                       nonzeros)));
+}
+
 }
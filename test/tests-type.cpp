@@ -1,6 +1,8 @@
 #include "test.h"
 #include "taco/type.h"
 
+#include <cmath>
+
 using namespace taco;
 using namespace std;
 
@@ -45,6 +47,36 @@ TYPED_TEST_P(FloatTest, types) {
 REGISTER_TYPED_TEST_CASE_P(FloatTest, types);
 typedef ::testing::Types<float, double> GenericFloat;
 INSTANTIATE_TYPED_TEST_CASE_P(Generic, FloatTest, GenericFloat);
+typedef ::testing::Types<float16, bfloat16> ReducedFloat;
+INSTANTIATE_TYPED_TEST_CASE_P(Reduced, FloatTest, ReducedFloat);
+
+TEST(type, reduced_precision) {
+  ASSERT_TRUE(Float16.isReducedPrecision());
+  ASSERT_TRUE(BFloat16.isReducedPrecision());
+  ASSERT_FALSE(Float32.isReducedPrecision());
+  ASSERT_EQ(Float16, Float(16));
+  ASSERT_EQ(Float32, max_type(Float16, Float32));
+  ASSERT_EQ(Float32, max_type(Float16, BFloat16));
+  ASSERT_EQ(Float16, max_type(Int32, Float16));
+  ASSERT_EQ(Float64, max_type(BFloat16, Float64));
+
+  // Conversions round to nearest, ties to even
+  ASSERT_EQ(0x3c00, float16(1.0f).getBits());
+  ASSERT_EQ(0x3555, float16(1.0f / 3.0f).getBits());
+  ASSERT_EQ(0x3c00, float16(1.0f + 1.0f / 2048.0f).getBits());
+  ASSERT_EQ(0x3c02, float16(1.0f + 3.0f / 2048.0f).getBits());
+  ASSERT_EQ(65504.0f, float(float16(65504.0f)));
+  ASSERT_TRUE(std::isinf(float(float16(1e5f))));
+  ASSERT_EQ(0x0001, float16(std::ldexp(1.0f, -24)).getBits());
+  ASSERT_EQ(std::ldexp(1.0f, -24), float(float16::fromBits(0x0001)));
+  ASSERT_TRUE(std::isnan(float(float16(std::nanf("")))));
+
+  ASSERT_EQ(0x3f80, bfloat16(1.0f).getBits());
+  ASSERT_EQ(0x3f80, bfloat16(1.0f + 1.0f / 256.0f).getBits());
+  ASSERT_EQ(0x3f82, bfloat16(1.0f + 3.0f / 256.0f).getBits());
+  ASSERT_EQ(-2.5f, float(bfloat16(-2.5f)));
+  ASSERT_TRUE(std::isnan(float(bfloat16(std::nanf("")))));
+}
 
 TEST(type, equality) {
   Datatype fp32(Datatype::Float32);
@@ -606,3 +606,77 @@ TEST(workspaces, tile_dotProduct_3) {
   expected.compute();
   ASSERT_TENSOR_EQ(expected, A);
 }
+
+TEST(workspaces, arena_spgemm) {
+  if (should_use_CUDA_codegen()) {
+    return;
+  }
+  Tensor<double> A("A", {40, 40}, CSR);
+  Tensor<double> B("B", {40, 40}, CSR);
+  for (int i = 0; i < 40; i++) {
+    for (int j = i % 3; j < 40; j += 5) {
+      A.insert({i, j}, (double)(i + j));
+      B.insert({j, i}, (double)(i - j));
+    }
+  }
+  A.pack();
+  B.pack();
+
+  IndexVar i("i"), j("j"), k("k");
+  Tensor<double> expected("expected", {40, 40}, CSR);
+  expected(i, j) = A(i, k) * B(k, j);
+  expected.evaluate();
+
+  Tensor<double> C("C", {40, 40}, CSR);
+  IndexExpr precomputedExpr = A(i, k) * B(k, j);
+  C(i, j) = precomputedExpr;
+  TensorVar w("w", Type(Float64, {40}), taco::dense);
+  IndexStmt stmt = C.getAssignment().concretize();
+  stmt = stmt.reorder({i, k, j}).precompute(precomputedExpr, j, j, w);
+
+  C.compile(stmt);
+  ASSERT_NE(std::string::npos, C.getSource().find("taco_arena_calloc("));
+  ASSERT_NE(std::string::npos, C.getSource().find("taco_arena_free("));
+  C.assemble();
+
+  // The workspace is allocated from the heap until the arena has grown to fit
+  // it, so compute several times to exercise both paths
+  for (int n = 0; n < 3; n++) {
+    C.compute();
+    ASSERT_TENSOR_EQ(expected, C);
+  }
+}
+
+TEST(workspaces, spgemm_sorted_rows) {
+  if (should_use_CUDA_codegen()) {
+    return;
+  }
+  // Even rows of the result have a few nonzeros, whose indices are sorted,
+  // and odd rows have many, whose indices are found by scanning the workspace
+  Tensor<double> A("A", {40, 30}, CSR);
+  Tensor<double> B("B", {30, 3000}, CSR);
+  for (int i = 0; i < 40; i++) {
+    for (int k = i % 30; k < 30; k += (i % 2 == 0) ? 30 : 1) {
+      A.insert({i, k}, (double)(i + k));
+    }
+  }
+  for (int k = 0; k < 30; k++) {
+    for (int j = (k * 7) % 97; j < 3000; j += 601) {
+      B.insert({k, j}, (double)(k - j % 5));
+    }
+  }
+  A.pack();
+  B.pack();
+
+  IndexVar i("i"), j("j"), k("k");
+  Tensor<double> expected("expected", {40, 3000}, Format({Dense, Dense}));
+  expected(i, j) = A(i, k) * B(k, j);
+  expected.evaluate();
+
+  Tensor<double> C("C", {40, 3000}, CSR);
+  C(i, j) = A(i, k) * B(k, j);
+  C.evaluate();
+  ASSERT_NE(std::string::npos, C.getSource().find("qsort("));
+  ASSERT_NE(std::string::npos, C.getSource().find("w_scan_index"));
+  ASSERT_TENSOR_EQ(expected, C);
+}
@@ -262,7 +262,8 @@ static void printSchedulingHelp() {
               "an output race strategy `strat`. Since the other transformations "
               "expect serial code, parallelize must come last in a series of "
               "transformations.  Possible parallel hardware units are: "
-              "NotParallel, GPUBlock, GPUWarp, GPUThread, CPUThread, CPUVector. "
+              "NotParallel, GPUBlock, GPUWarp, GPUThread, CPUThread, "
+              "CPUThreadBalanced, CPUTask, CPUVector. "
               "Possible output race strategies are: "
               "IgnoreRaces, NoRaces, Atomics, Temporary, ParallelReduction.");
 }
@@ -308,348 +309,6 @@ static void printCommandLine(ostream& os, int argc, char* argv[]) {
   }
 }
 
-static bool setSchedulingCommands(vector<vector<string>> scheduleCommands, parser::Parser& parser, IndexStmt& stmt) {
-  auto findVar = [&stmt](string name) {
-    ProvenanceGraph graph(stmt);
-    for (auto v : graph.getAllIndexVars()) {
-      if (v.getName() == name) {
-        return v;
-      }
-    }
-
-    taco_uassert(0) << "Index variable '" << name << "' not defined in statement " << stmt;
-    abort(); // to silence a warning: control reaches end of non-void function
-  };
-
-  bool isGPU = false;
-
-  for(vector<string> scheduleCommand : scheduleCommands) {
-    string command = scheduleCommand[0];
-    scheduleCommand.erase(scheduleCommand.begin());
-
-    if (command == "pos") {
-      taco_uassert(scheduleCommand.size() == 3) << "'pos' scheduling directive takes 3 parameters: pos(i, ipos, tensor)";
-      string i, ipos, tensor;
-      i      = scheduleCommand[0];
-      ipos   = scheduleCommand[1];
-      tensor = scheduleCommand[2];
-
-      for (auto a : getArgumentAccesses(stmt)) {
-        if (a.getTensorVar().getName() == tensor) {
-          IndexVar derived(ipos);
-          stmt = stmt.pos(findVar(i), derived, a);
-          goto end;
-        }
-      }
-
-    } else if (command == "fuse") {
-      taco_uassert(scheduleCommand.size() == 3) << "'fuse' scheduling directive takes 3 parameters: fuse(i, j, f)";
-      string i, j, f;
-      i = scheduleCommand[0];
-      j = scheduleCommand[1];
-      f = scheduleCommand[2];
-
-      IndexVar fused(f);
-      stmt = stmt.fuse(findVar(i), findVar(j), fused);
-
-    } else if (command == "split") {
-      taco_uassert(scheduleCommand.size() == 4)
-          << "'split' scheduling directive takes 4 parameters: split(i, i1, i2, splitFactor)";
-      string i, i1, i2;
-      size_t splitFactor;
-      i = scheduleCommand[0];
-      i1 = scheduleCommand[1];
-      i2 = scheduleCommand[2];
-      taco_uassert(sscanf(scheduleCommand[3].c_str(), "%zu", &splitFactor) == 1)
-          << "failed to parse fourth parameter to `split` directive as a size_t";
-
-      IndexVar split1(i1);
-      IndexVar split2(i2);
-      stmt = stmt.split(findVar(i), split1, split2, splitFactor);
-    } else if (command == "divide") {
-      taco_uassert(scheduleCommand.size() == 4)
-          << "'divide' scheduling directive takes 4 parameters: divide(i, i1, i2, divFactor)";
-      string i, i1, i2;
-      i = scheduleCommand[0];
-      i1 = scheduleCommand[1];
-      i2 = scheduleCommand[2];
-
-      size_t divideFactor;
-      taco_uassert(sscanf(scheduleCommand[3].c_str(), "%zu", &divideFactor) == 1)
-          << "failed to parse fourth parameter to `divide` directive as a size_t";
-
-      IndexVar divide1(i1);
-      IndexVar divide2(i2);
-      stmt = stmt.divide(findVar(i), divide1, divide2, divideFactor);
-    } else if (command == "precompute") {
-      string exprStr, i, iw, name;
-      vector<string> i_vars, iw_vars;
-
-      taco_uassert(scheduleCommand.size() == 3 || scheduleCommand.size() == 4)
-        << "'precompute' scheduling directive takes 3 or 4 parameters: "
-        << "precompute(expr, i, iw [, workspace_name]) or precompute(expr, {i_vars}, "
-           "{iw_vars} [, workspace_name])" << scheduleCommand.size();
-
-      exprStr = scheduleCommand[0];
-//      i       = scheduleCommand[1];
-//      iw      = scheduleCommand[2];
-      i_vars  = parser::varListParser(scheduleCommand[1]);
-      iw_vars = parser::varListParser(scheduleCommand[2]);
-
-      if (scheduleCommand.size() == 4)
-        name  = scheduleCommand[3];
-      else
-        name  = "workspace";
-
-      vector<IndexVar> origs;
-      vector<IndexVar> pres;
-      for (auto& i : i_vars) {
-        origs.push_back(findVar(i));
-      }
-      for (auto& iw : iw_vars) {
-        try {
-          pres.push_back(findVar(iw));
-        } catch (TacoException &e) {
-          pres.push_back(IndexVar(iw));
-        }
-      }
-
-      struct GetExpr : public IndexNotationVisitor {
-        using IndexNotationVisitor::visit;
-
-        string exprStr;
-        IndexExpr expr;
-
-        void setExprStr(string input) {
-          exprStr = input;
-          exprStr.erase(remove(exprStr.begin(), exprStr.end(), ' '), exprStr.end());
-        }
-
-        string toString(IndexExpr e) {
-          stringstream tempStream;
-          tempStream << e;
-          string tempStr = tempStream.str();
-          tempStr.erase(remove(tempStr.begin(), tempStr.end(), ' '), tempStr.end());
-          return tempStr;
-        }
-
-        void visit(const AccessNode* node) {
-          IndexExpr currentExpr(node);
-          if (toString(currentExpr) == exprStr) {
-            expr = currentExpr;
-          }
-          else {
-            IndexNotationVisitor::visit(node);
-          }
-        }
-
-        void visit(const UnaryExprNode* node) {
-          IndexExpr currentExpr(node);
-          if (toString(currentExpr) == exprStr) {
-            expr = currentExpr;
-          }
-          else {
-            IndexNotationVisitor::visit(node);
-          }
-        }
-
-        void visit(const BinaryExprNode* node) {
-          IndexExpr currentExpr(node);
-          if (toString(currentExpr) == exprStr) {
-            expr = currentExpr;
-          }
-          else {
-            IndexNotationVisitor::visit(node);
-          }
-        }
-      };
-
-      GetExpr visitor;
-      visitor.setExprStr(exprStr);
-      stmt.accept(&visitor);
-
-      vector<Dimension> dims;
-      auto domains = stmt.getIndexVarDomains();
-      for (auto& orig : origs) {
-        auto it = domains.find(orig);
-        if (it != domains.end()) {
-          dims.push_back(it->second);
-        } else {
-          dims.push_back(Dimension(orig));
-        }
-      }
-
-      std::vector<ModeFormatPack> modeFormatPacks(dims.size(), Dense);
-      Format format(modeFormatPacks);
-      TensorVar workspace(name, Type(Float64, dims), format);
-
-      stmt = stmt.precompute(visitor.expr, origs, pres, workspace);
-
-    } else if (command == "reorder") {
-      taco_uassert(scheduleCommand.size() > 1) << "'reorder' scheduling directive needs at least 2 parameters: reorder(outermost, ..., innermost)";
-
-      vector<IndexVar> reorderedVars;
-      for (string var : scheduleCommand) {
-        reorderedVars.push_back(findVar(var));
-      }
-
-      stmt = stmt.reorder(reorderedVars);
-
-    } else if (command == "mergeby") {
-      taco_uassert(scheduleCommand.size() == 2) << "'mergeby' scheduling directive takes 2 parameters: mergeby(i, strategy)";
-      string i, strat;
-      MergeStrategy strategy;
-
-      i = scheduleCommand[0];
-      strat = scheduleCommand[1];
-      if (strat == "TwoFinger") {
-        strategy = MergeStrategy::TwoFinger;
-      } else if (strat == "Gallop") {
-        strategy = MergeStrategy::Gallop;
-      } else {
-        taco_uerror << "Merge strategy not defined.";
-        goto end;
-      }
-
-      stmt = stmt.mergeby(findVar(i), strategy);
-
-    } else if (command == "bound") {
-      taco_uassert(scheduleCommand.size() == 4) << "'bound' scheduling directive takes 4 parameters: bound(i, i1, bound, type)";
-      string i, i1, type;
-      size_t bound;
-      i  = scheduleCommand[0];
-      i1 = scheduleCommand[1];
-      taco_uassert(sscanf(scheduleCommand[2].c_str(), "%zu", &bound) == 1) << "failed to parse third parameter to `bound` directive as a size_t";
-      type = scheduleCommand[3];
-
-      BoundType bound_type;
-      if (type == "MinExact") {
-        bound_type = BoundType::MinExact;
-      } else if (type == "MinConstraint") {
-        bound_type = BoundType::MinConstraint;
-      } else if (type == "MaxExact") {
-        bound_type = BoundType::MaxExact;
-      } else if (type == "MaxConstraint") {
-        bound_type = BoundType::MaxConstraint;
-      } else {
-        taco_uerror << "Bound type not defined.";
-        goto end;
-      }
-
-      IndexVar bound1(i1);
-      stmt = stmt.bound(findVar(i), bound1, bound, bound_type);
-
-    } else if (command == "unroll") {
-      taco_uassert(scheduleCommand.size() == 2) << "'unroll' scheduling directive takes 2 parameters: unroll(i, unrollFactor)";
-      string i;
-      size_t unrollFactor;
-      i  = scheduleCommand[0];
-      taco_uassert(sscanf(scheduleCommand[1].c_str(), "%zu", &unrollFactor) == 1) << "failed to parse second parameter to `unroll` directive as a size_t";
-
-      stmt = stmt.unroll(findVar(i), unrollFactor);
-
-    } else if (command == "parallelize") {
-      string i, unit, strategy;
-      taco_uassert(scheduleCommand.size() == 3) << "'parallelize' scheduling directive takes 3 parameters: parallelize(i, unit, strategy)";
-      i        = scheduleCommand[0];
-      unit     = scheduleCommand[1];
-      strategy = scheduleCommand[2];
-
-      ParallelUnit parallel_unit;
-      if (unit == "NotParallel") {
-        parallel_unit = ParallelUnit::NotParallel;
-      } else if (unit == "GPUBlock") {
-        parallel_unit = ParallelUnit::GPUBlock;
-        isGPU = true;
-      } else if (unit == "GPUWarp") {
-        parallel_unit = ParallelUnit::GPUWarp;
-        isGPU = true;
-      } else if (unit == "GPUThread") {
-        parallel_unit = ParallelUnit::GPUThread;
-        isGPU = true;
-      } else if (unit == "CPUThread") {
-        parallel_unit = ParallelUnit::CPUThread;
-      } else if (unit == "CPUVector") {
-        parallel_unit = ParallelUnit::CPUVector;
-      } else {
-        taco_uerror << "Parallel hardware not defined.";
-        goto end;
-      }
-
-      OutputRaceStrategy output_race_strategy;
-      if (strategy == "IgnoreRaces") {
-        output_race_strategy = OutputRaceStrategy::IgnoreRaces;
-      } else if (strategy == "NoRaces") {
-        output_race_strategy = OutputRaceStrategy::NoRaces;
-      } else if (strategy == "Atomics") {
-        output_race_strategy = OutputRaceStrategy::Atomics;
-      } else if (strategy == "Temporary") {
-        output_race_strategy = OutputRaceStrategy::Temporary;
-      } else if (strategy == "ParallelReduction") {
-        output_race_strategy = OutputRaceStrategy::ParallelReduction;
-      } else {
-        taco_uerror << "Race strategy not defined.";
-        goto end;
-      }
-
-      stmt = stmt.parallelize(findVar(i), parallel_unit, output_race_strategy);
-
-    } else if (command == "assemble") {
-      taco_uassert(scheduleCommand.size() == 2 || scheduleCommand.size() == 3) 
-          << "'assemble' scheduling directive takes 2 or 3 parameters: "
-          << "assemble(tensor, strategy [, separately_schedulable])";
-
-      string tensor = scheduleCommand[0];
-      string strategy = scheduleCommand[1];
-      string schedulable = "false";
-      if (scheduleCommand.size() == 3) {
-        schedulable = scheduleCommand[2];
-      }
-
-      TensorVar result;
-      for (auto a : getResultAccesses(stmt).first) {
-        if (a.getTensorVar().getName() == tensor) {
-          result = a.getTensorVar();
-          break;
-        }
-      }
-      taco_uassert(result.defined()) << "Unable to find result tensor '"
-                                     << tensor << "'";
-
-      AssembleStrategy assemble_strategy;
-      if (strategy == "Append") {
-        assemble_strategy = AssembleStrategy::Append;
-      } else if (strategy == "Insert") {
-        assemble_strategy = AssembleStrategy::Insert;
-      } else {
-        taco_uerror << "Assemble strategy not defined.";
-        goto end;
-      }
-
-      bool separately_schedulable;
-      if (schedulable == "true") {
-        separately_schedulable = true;
-      } else if (schedulable == "false") {
-        separately_schedulable = false;
-      } else {
-        taco_uerror << "Incorrectly specified whether computation of result "
-                    << "statistics should be separately schedulable.";
-        goto end;
-      }
-
-      stmt = stmt.assemble(result, assemble_strategy, separately_schedulable);
-
-    } else {
-      taco_uerror << "Unknown scheduling function \"" << command << "\"";
-      break;
-    }
-
-    end:;
-  }
-
-  return isGPU;
-}
-
 int main(int argc, char* argv[]) {
   if (argc < 2) {
     printUsageInfo();
@@ -1155,7 +814,9 @@ int main(int argc, char* argv[]) {
   stmt = reorderLoopsTopologically(stmt);
 
   if (setSchedule) {
-    cuda |= setSchedulingCommands(scheduleCommands, parser, stmt);
+    bool usesGPU = false;
+    stmt = parser::applySchedule(stmt, scheduleCommands, &usesGPU);
+    cuda |= usesGPU;
   }
   else {
     stmt = insertTemporaries(stmt);